@@ -0,0 +1,136 @@
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "IntMatrix.h"
+
+using namespace mtm;
+using std::cout;
+using std::endl;
+using std::string;
+
+// Measures the operations of IntMatrix on square sizes from 4x4 up to
+// --max-size (8192 by default), and prints one CSV row per operation and size,
+// in the format of PartBBenchmark, for tracking regressions:
+//
+//   suite,operation,rows,cols,iterations,ns_per_op,ns_per_element,gb_per_s
+//
+// gb_per_s counts the bytes of elements an operation reads and writes.
+// Usage: PartABenchmark [--max-size N] [BENCHMARK...]
+
+#define ADD_BENCHMARK(x) benchmarks[#x]=x;
+
+static const int SIZES[] = {4, 16, 64, 256, 1024, 4096, 8192};
+static const double MIN_SECONDS = 0.1;
+static int max_size = 8192;
+
+// Results are added here so that the compiler can not drop the operations
+static volatile double sink = 0;
+
+// A stream buffer that discards what is written to it, so printing measures
+// only the formatting
+class DiscardBuffer : public std::streambuf {
+    char buffer[4096];
+public:
+    DiscardBuffer(){
+        setp(buffer, buffer + sizeof(buffer));
+    }
+protected:
+    int overflow(int character) override {
+        setp(buffer, buffer + sizeof(buffer));
+        return traits_type::not_eof(character);
+    }
+};
+
+// Runs operation until MIN_SECONDS have passed (at least once), and reports it
+void measure(const string& suite, const string& operation, int size, double bytes_per_element,
+             const std::function<void()>& run){
+    if (size <= 1024){
+        run(); // Warm up the caches and the allocator
+    }
+    long long iterations = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        run();
+        iterations++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < MIN_SECONDS);
+    double ns_per_op = seconds * 1e9 / iterations;
+    double elements = static_cast<double>(size) * size;
+    cout << suite << "," << operation << "," << size << "," << size << "," << iterations << ","
+         << ns_per_op << "," << ns_per_op / elements << "," << bytes_per_element * elements / ns_per_op << endl;
+}
+
+void benchmarkIntMatrix(){
+    const string suite = "IntMatrix";
+    const double S = sizeof(int);
+    for (int size : SIZES){
+        if (size > max_size){
+            break;
+        }
+        Dimensions dim(size, size);
+        // all scans the whole of a, which has no zero, and any the whole of zeros
+        IntMatrix a(dim, 1);
+        IntMatrix b(dim, 2);
+        IntMatrix zeros(dim, 0);
+        int value = 1;
+
+        measure(suite, "construct", size, S, [&](){ IntMatrix m(dim, value); sink = sink + m(0, 0); });
+        measure(suite, "copy", size, 2 * S, [&](){ IntMatrix m(a); sink = sink + m(0, 0); });
+        measure(suite, "add", size, 3 * S, [&](){ IntMatrix m = a + b; sink = sink + m(0, 0); });
+        measure(suite, "negate", size, 2 * S, [&](){ IntMatrix m = -a; sink = sink + m(0, 0); });
+        measure(suite, "scalar_add", size, 2 * S, [&](){ IntMatrix m = a + value; sink = sink + m(0, 0); });
+        measure(suite, "less", size, 2 * S, [&](){ sink = sink + (a < value)(0, 0); });
+        measure(suite, "less_equal", size, 2 * S, [&](){ sink = sink + (a <= value)(0, 0); });
+        measure(suite, "greater", size, 2 * S, [&](){ sink = sink + (a > value)(0, 0); });
+        measure(suite, "greater_equal", size, 2 * S, [&](){ sink = sink + (a >= value)(0, 0); });
+        measure(suite, "equal", size, 2 * S, [&](){ sink = sink + (a == value)(0, 0); });
+        measure(suite, "not_equal", size, 2 * S, [&](){ sink = sink + (a != value)(0, 0); });
+        measure(suite, "transpose", size, 2 * S, [&](){ IntMatrix m = a.transpose(); sink = sink + m(0, 0); });
+        measure(suite, "all", size, S, [&](){ sink = sink + all(a); });
+        measure(suite, "any", size, S, [&](){ sink = sink + any(zeros); });
+        measure(suite, "print", size, S, [&](){
+            DiscardBuffer buffer;
+            std::ostream out(&buffer);
+            out << a;
+        });
+    }
+}
+
+int main(int argc, char* argv[]){
+
+    std::map<std::string, std::function<void()>> benchmarks;
+
+    ADD_BENCHMARK(benchmarkIntMatrix);
+
+    std::vector<string> selected;
+    for (int i = 1; i < argc; i++){
+        string argument = argv[i];
+        if (argument == "--max-size" && i + 1 < argc){
+            max_size = std::atoi(argv[++i]);
+        } else if (benchmarks.count(argument) > 0){
+            selected.push_back(argument);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--max-size N] [BENCHMARK...]" << endl;
+            return 2;
+        }
+    }
+    if (selected.empty()){
+        for (std::pair<const string, std::function<void()>>& benchmark : benchmarks){
+            selected.push_back(benchmark.first);
+        }
+    }
+
+    cout << "suite,operation,rows,cols,iterations,ns_per_op,ns_per_element,gb_per_s" << endl;
+    for (const string& name : selected){
+        benchmarks[name]();
+    }
+    return 0;
+}
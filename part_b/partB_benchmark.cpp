@@ -0,0 +1,181 @@
+
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Matrix.h"
+
+using namespace mtm;
+using std::cout;
+using std::endl;
+using std::string;
+
+// Measures the operations of Matrix<int>, Matrix<double> and Array<int> on
+// square sizes from 4x4 up to --max-size (8192 by default), and prints one CSV
+// row per operation and size, for tracking regressions:
+//
+//   suite,operation,rows,cols,iterations,ns_per_op,ns_per_element,gb_per_s
+//
+// gb_per_s counts the bytes of elements an operation reads and writes (none
+// for the construction of an Array, which leaves its elements uninitialized).
+// Usage: PartBBenchmark [--max-size N] [BENCHMARK...]
+
+#define ADD_BENCHMARK(x) benchmarks[#x]=x;
+
+static const int SIZES[] = {4, 16, 64, 256, 1024, 4096, 8192};
+static const double MIN_SECONDS = 0.1;
+static int max_size = 8192;
+
+// Results are added here so that the compiler can not drop the operations
+static volatile double sink = 0;
+
+// A stream buffer that discards what is written to it, so printing measures
+// only the formatting
+class DiscardBuffer : public std::streambuf {
+    char buffer[4096];
+public:
+    DiscardBuffer(){
+        setp(buffer, buffer + sizeof(buffer));
+    }
+protected:
+    int overflow(int character) override {
+        setp(buffer, buffer + sizeof(buffer));
+        return traits_type::not_eof(character);
+    }
+};
+
+// Runs operation until MIN_SECONDS have passed (at least once), and reports it
+void measure(const string& suite, const string& operation, int size, double bytes_per_element,
+             const std::function<void()>& run){
+    if (size <= 1024){
+        run(); // Warm up the caches and the allocator
+    }
+    long long iterations = 0;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    double seconds = 0;
+    do {
+        run();
+        iterations++;
+        seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    } while (seconds < MIN_SECONDS);
+    double ns_per_op = seconds * 1e9 / iterations;
+    double elements = static_cast<double>(size) * size;
+    cout << suite << "," << operation << "," << size << "," << size << "," << iterations << ","
+         << ns_per_op << "," << ns_per_op / elements << "," << bytes_per_element * elements / ns_per_op << endl;
+}
+
+template<typename T>
+void benchmarkMatrix(const string& suite){
+    const double S = sizeof(T);
+    const double B = sizeof(bool);
+    for (int size : SIZES){
+        if (size > max_size){
+            break;
+        }
+        Dimensions dim(size, size);
+        // all scans the whole of a, which has no zero, and any the whole of zeros
+        Matrix<T> a(dim, T(1));
+        Matrix<T> b(dim, T(2));
+        Matrix<T> zeros(dim, T(0));
+        T value = T(1);
+
+        measure(suite, "construct", size, S, [&](){ Matrix<T> m(dim, value); sink = sink + m(0, 0); });
+        measure(suite, "copy", size, 2 * S, [&](){ Matrix<T> m(a); sink = sink + m(0, 0); });
+        measure(suite, "add", size, 3 * S, [&](){ Matrix<T> m = a + b; sink = sink + m(0, 0); });
+        measure(suite, "negate", size, 2 * S, [&](){ Matrix<T> m = -a; sink = sink + m(0, 0); });
+        measure(suite, "scalar_add", size, 2 * S, [&](){ Matrix<T> m = a + value; sink = sink + m(0, 0); });
+        measure(suite, "less", size, S + B, [&](){ sink = sink + (a < value)(0, 0); });
+        measure(suite, "less_equal", size, S + B, [&](){ sink = sink + (a <= value)(0, 0); });
+        measure(suite, "greater", size, S + B, [&](){ sink = sink + (a > value)(0, 0); });
+        measure(suite, "greater_equal", size, S + B, [&](){ sink = sink + (a >= value)(0, 0); });
+        measure(suite, "equal", size, S + B, [&](){ sink = sink + (a == value)(0, 0); });
+        measure(suite, "not_equal", size, S + B, [&](){ sink = sink + (a != value)(0, 0); });
+        measure(suite, "transpose", size, 2 * S, [&](){ Matrix<T> m = a.transpose(); sink = sink + m(0, 0); });
+        measure(suite, "apply", size, 2 * S, [&](){
+            Matrix<T> m = a.apply([](const T& element){ return element * 3; });
+            sink = sink + m(0, 0);
+        });
+        measure(suite, "all", size, S, [&](){ sink = sink + all(a); });
+        measure(suite, "any", size, S, [&](){ sink = sink + any(zeros); });
+        measure(suite, "print", size, S, [&](){
+            DiscardBuffer buffer;
+            std::ostream out(&buffer);
+            out << a;
+        });
+    }
+}
+
+void benchmarkMatrixInt(){
+    benchmarkMatrix<int>("Matrix<int>");
+}
+
+void benchmarkMatrixDouble(){
+    benchmarkMatrix<double>("Matrix<double>");
+}
+
+void benchmarkArray(){
+    const double S = sizeof(int);
+    for (int size : SIZES){
+        if (size > max_size){
+            break;
+        }
+        int length = size * size;
+        Array<int> source(length);
+        for (int i = 0; i < length; i++){
+            source[i] = i;
+        }
+        Array<int> target(length);
+        measure("Array<int>", "construct", size, 0, [&](){
+            Array<int> array(length);
+            array[0] = 1;
+            sink = sink + array[0];
+        });
+        measure("Array<int>", "copy", size, 2 * S, [&](){ Array<int> array(source); sink = sink + array[0]; });
+        measure("Array<int>", "assign", size, 2 * S, [&](){ target = source; sink = sink + target[0]; });
+        measure("Array<int>", "read", size, S, [&](){
+            long long sum = 0;
+            for (int i = 0; i < length; i++){
+                sum += source[i];
+            }
+            sink = sink + sum;
+        });
+    }
+}
+
+int main(int argc, char* argv[]){
+
+    std::map<std::string, std::function<void()>> benchmarks;
+
+    ADD_BENCHMARK(benchmarkMatrixInt);
+    ADD_BENCHMARK(benchmarkMatrixDouble);
+    ADD_BENCHMARK(benchmarkArray);
+
+    std::vector<string> selected;
+    for (int i = 1; i < argc; i++){
+        string argument = argv[i];
+        if (argument == "--max-size" && i + 1 < argc){
+            max_size = std::atoi(argv[++i]);
+        } else if (benchmarks.count(argument) > 0){
+            selected.push_back(argument);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--max-size N] [BENCHMARK...]" << endl;
+            return 2;
+        }
+    }
+    if (selected.empty()){
+        for (std::pair<const string, std::function<void()>>& benchmark : benchmarks){
+            selected.push_back(benchmark.first);
+        }
+    }
+
+    cout << "suite,operation,rows,cols,iterations,ns_per_op,ns_per_element,gb_per_s" << endl;
+    for (const string& name : selected){
+        benchmarks[name]();
+    }
+    return 0;
+}
@@ -9,7 +9,11 @@
 #include <string>
 #include <fstream>
 #include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
 
+#include "AllocationTracker.h"
 #include "Matrix.h"
 
 #define DEPENDENCY_VERBOSE
@@ -26,6 +30,12 @@ using std::ostream;
  cout<<"Failed assertion at line "<<__LINE__<<" in "<<__func__<<endl;\
   return false; }
 
+// Asserts that x makes exactly count heap allocations on this thread
+#define ASSERT_ALLOCATIONS(x, count) { AllocationCounter allocation_counter; x; \
+  if(allocation_counter.allocations() != static_cast<std::uint64_t>(count)){ \
+  cout<<"Failed assertion at line "<<__LINE__<<" in "<<__func__<<": "<<allocation_counter.allocations()<<\
+  " allocations while expecting "<<(count)<<endl; return false; }}
+
 #define ADD_TEST(x) tests[#x]=x;
 
 class DependencyFinder{
@@ -979,6 +989,292 @@ bool testApply(){
 
 }
 
+// Sums throw once sums_left reaches zero
+class ThrowingSum{
+    int value;
+public:
+    static int sums_left;
+    explicit ThrowingSum(int value = 0) : value(value){}
+    ThrowingSum operator+(const ThrowingSum& other) const{
+        if (sums_left-- <= 0){
+            throw std::runtime_error("sum failed");
+        }
+        return ThrowingSum(value + other.value);
+    }
+    int get() const{ return value; }
+};
+int ThrowingSum::sums_left = 0;
+
+bool testAllocations(){
+
+    Matrix<int> a(Dimensions(3,4), 1);
+    Matrix<int> b(Dimensions(3,4), 2);
+    const Matrix<int>& const_a = a;
+    int total = 0;
+
+    // Element access, iteration and in-place operations never allocate
+    ASSERT_ALLOCATIONS(a(1,2) = 5; total += const_a(1,2), 0);
+    ASSERT_ALLOCATIONS(for (int& element : a){ element++; }, 0);
+    ASSERT_ALLOCATIONS(for (const int& element : const_a){ total += element; }, 0);
+    ASSERT_ALLOCATIONS(a += 3, 0);
+    ASSERT_ALLOCATIONS(total += a.height() * a.width(), 0);
+    ASSERT_TEST(total == 5 + 11 * 2 + 6 + 12);
+    ASSERT_TEST(a(0,0) == 5 && a(1,2) == 9);
+
+    // Every new matrix is a single allocation
+    ASSERT_ALLOCATIONS(Matrix<int> sum = a + b; ASSERT_TEST(sum(1,2) == 11), 1);
+    ASSERT_ALLOCATIONS(Matrix<int> sum = a + 1; ASSERT_TEST(sum(1,2) == 10), 1);
+    ASSERT_ALLOCATIONS(Matrix<int> sum = 1 + a; ASSERT_TEST(sum(1,2) == 10), 1);
+    ASSERT_ALLOCATIONS(Matrix<int> negative = -a; ASSERT_TEST(negative(1,2) == -9), 1);
+    ASSERT_ALLOCATIONS(Matrix<int> copy(a); ASSERT_TEST(copy(1,2) == 9), 1);
+    ASSERT_ALLOCATIONS(Matrix<int> matrix(Dimensions(5,5), 7); ASSERT_TEST(matrix(4,4) == 7), 1);
+    ASSERT_ALLOCATIONS(Matrix<int> transposed = a.transpose(); ASSERT_TEST(transposed(2,1) == 9), 1);
+
+    // Assigning a matrix of the same size reuses the storage
+    ASSERT_ALLOCATIONS(b = a, 0);
+    ASSERT_TEST(checkAreEqual(a, b));
+
+    // When adding may throw, += works on a copy, so a failed addition changes nothing
+    Matrix<ThrowingSum> sums(Dimensions(2,3), ThrowingSum(1));
+    ThrowingSum::sums_left = 4;
+    try{
+        sums += ThrowingSum(1);
+        ASSERT_TEST(false);
+    }
+    catch (const std::runtime_error&){}
+    for (const ThrowingSum& element : sums){
+        ASSERT_TEST(element.get() == 1);
+    }
+    ThrowingSum::sums_left = 6;
+    sums += ThrowingSum(1);
+    ASSERT_TEST(sums(0,0).get() == 2 && sums(1,2).get() == 2);
+
+    return true;
+
+}
+
+// Counts its live instances and its assignments, and has no default constructor
+class Counted{
+    int value;
+public:
+    static int live;
+    static int assignments;
+    explicit Counted(int value) : value(value){ live++; }
+    Counted(const Counted& other) : value(other.value){ live++; }
+    Counted& operator=(const Counted& other){ value = other.value; assignments++; return *this; }
+    ~Counted(){ live--; }
+    Counted operator+(const Counted& other) const{ return Counted(value + other.value); }
+    int get() const{ return value; }
+};
+int Counted::live = 0;
+int Counted::assignments = 0;
+
+bool testRawStorage(){
+
+    {
+        // Elements are copy-constructed in place, never default-constructed
+        Matrix<Counted> a(Dimensions(2,3), Counted(1));
+        ASSERT_TEST(Counted::live == 6);
+        Matrix<Counted> b = a + a;
+        ASSERT_TEST(b(1,2).get() == 2 && Counted::live == 12);
+        Matrix<Counted> sum = b + Counted(1);
+        Counted::assignments = 0;
+        Matrix<Counted> t = sum.transpose();
+        ASSERT_TEST(t.height() == 3 && t.width() == 2 && t(2,1).get() == 3 && Counted::live == 24);
+        ASSERT_TEST(Counted::assignments == 0);
+        a = t;
+        ASSERT_TEST(a.height() == 3 && a(2,1).get() == 3 && Counted::live == 24);
+    }
+    ASSERT_TEST(Counted::live == 0);
+
+    // Fills of repeated bytes, and of other values
+    Matrix<int> minus_ones(Dimensions(3,5), -1);
+    Matrix<int> sevens(Dimensions(3,5), 7);
+    Matrix<double> halves(Dimensions(2,2), -0.5);
+    for (int element : minus_ones){
+        ASSERT_TEST(element == -1);
+    }
+    for (int element : sevens){
+        ASSERT_TEST(element == 7);
+    }
+    ASSERT_TEST(halves(1,1) == -0.5);
+
+    // Copies of trivially copyable elements, and of strings
+    Matrix<int> copy(sevens);
+    sevens(2,4) = 0;
+    ASSERT_TEST(copy(2,4) == 7);
+    Matrix<string> names(Dimensions(2,2), "name");
+    Matrix<string> other(Dimensions(1,1), "other");
+    other = names;
+    names(0,0) = "changed";
+    ASSERT_TEST(other.height() == 2 && other(0,0) == "name" && other(1,1) == "name");
+
+    return true;
+
+}
+
+// Copies throw once copies_left reaches zero
+class Fragile{
+    int value;
+public:
+    static int copies_left;
+    explicit Fragile(int value) : value(value){}
+    Fragile(const Fragile& other) : value(other.value){
+        if (copies_left-- <= 0){
+            throw std::runtime_error("copy failed");
+        }
+    }
+    Fragile& operator=(const Fragile& other) = default;
+    int get() const{ return value; }
+};
+int Fragile::copies_left = 0;
+
+bool testGrowableArray(){
+
+    Array<int> numbers;
+    ASSERT_TEST(numbers.size() == 0 && numbers.capacity() == 0);
+    for (int i = 0; i < 100; i++){
+        numbers.push_back(i);
+        ASSERT_TEST(numbers.capacity() >= numbers.size());
+    }
+    ASSERT_TEST(numbers.size() == 100 && numbers[0] == 0 && numbers[99] == 99);
+
+    // Capacity doubles, so growing to n elements takes O(log n) allocations
+    ASSERT_ALLOCATIONS(Array<int> grown; for (int i = 0; i < 1024; i++){ grown.push_back(i); }, 11);
+    ASSERT_ALLOCATIONS(Array<int> reserved; reserved.reserve(1024); for (int i = 0; i < 1024; i++){ reserved.push_back(i); }, 1);
+
+    // Appending an element of the array itself, while it grows
+    numbers.shrink_to_fit();
+    ASSERT_TEST(numbers.capacity() == 100);
+    numbers.push_back(numbers[50]);
+    ASSERT_TEST(numbers.size() == 101 && numbers[100] == 50);
+    numbers.pop_back();
+    numbers.pop_back();
+    ASSERT_TEST(numbers.size() == 99 && numbers[98] == 98);
+
+    // Move-only elements are moved when the storage grows
+    Array<std::unique_ptr<int>> pointers;
+    for (int i = 0; i < 10; i++){
+        pointers.emplace_back(new int(i));
+    }
+    pointers.push_back(std::unique_ptr<int>(new int(10)));
+    ASSERT_TEST(pointers.size() == 11 && *pointers[0] == 0 && *pointers[10] == 10);
+    Array<std::unique_ptr<int>> moved(std::move(pointers));
+    ASSERT_TEST(pointers.size() == 0 && moved.size() == 11 && *moved[5] == 5);
+
+    // A failed growth leaves the array unchanged
+    Array<Fragile> fragile;
+    Fragile::copies_left = 3;
+    fragile.reserve(3);
+    for (int i = 0; i < 3; i++){
+        fragile.push_back(Fragile(i));
+    }
+    Fragile::copies_left = 2;
+    try{
+        fragile.push_back(Fragile(3));
+        ASSERT_TEST(false);
+    }
+    catch (const std::runtime_error&){}
+    ASSERT_TEST(fragile.size() == 3 && fragile.capacity() == 3 && fragile[2].get() == 2);
+
+    return true;
+
+}
+
+bool testAppendRow(){
+
+    const int cols = 5;
+    int row[cols] = {0, 1, 2, 3, 4};
+    Matrix<int> matrix = Matrix<int>::FromRow(row, row + cols);
+    ASSERT_TEST(matrix.height() == 1 && matrix.width() == cols && matrix(0,4) == 4);
+    for (int i = 1; i < 100; i++){
+        for (int& element : row){
+            element += cols;
+        }
+        matrix.appendRow(row, row + cols);
+    }
+    ASSERT_TEST(matrix.height() == 100 && matrix.width() == cols);
+    int expected = 0;
+    for (int element : matrix){
+        ASSERT_TEST(element == expected++);
+    }
+
+    // Rows are appended in place: none after reserving, and O(log rows) without
+    ASSERT_ALLOCATIONS(matrix.reserveRows(200), 1);
+    ASSERT_ALLOCATIONS(for (int i = 0; i < 100; i++){ matrix.appendRow(row, row + cols); }, 0);
+    ASSERT_ALLOCATIONS(Matrix<int> grown = Matrix<int>::FromRow({1, 2}); for (int i = 0; i < 1023; i++){
+        grown.appendRow({3, 4}); }, 11);
+    ASSERT_TEST(matrix.height() == 200 && matrix(199,4) == 499);
+
+    // Rows are taken from any forward range, including the elements of another matrix
+    std::vector<string> words = {"a", "b"};
+    Matrix<string> strings = Matrix<string>::FromRow(words.begin(), words.end());
+    strings.appendRow({"c", "d"});
+    Matrix<int> first_row = Matrix<int>::FromRow({7, 8});
+    Matrix<int> rows = Matrix<int>::FromRow(first_row.begin(), first_row.end());
+    rows.appendRow(first_row.begin(), first_row.end());
+    ASSERT_TEST(strings(1,0) == "c" && rows.height() == 2 && rows(1,1) == 8);
+
+    // Input iterators are read once, so rows can be streamed
+    std::istringstream in("1 2 3 4 5 6 7 8");
+    Matrix<int> streamed = Matrix<int>::FromRow({1, 2, 3});
+    try{
+        streamed.appendRow(std::istream_iterator<int>(in), std::istream_iterator<int>());
+        ASSERT_TEST(false);
+    }
+    catch (const Matrix<int>::DimensionMismatch& e){
+        ASSERT_TEST(string(e.what()) == "Mtm matrix error: Dimension mismatch: (1,3) (1,8)");
+    }
+    ASSERT_TEST(streamed.height() == 1);
+    std::istringstream rows_in("4 5 6");
+    streamed.appendRow(std::istream_iterator<int>(rows_in), std::istream_iterator<int>());
+    ASSERT_TEST(streamed.height() == 2 && streamed(1,0) == 4 && streamed(1,1) == 5 && streamed(1,2) == 6);
+    std::istringstream short_in("7 8");
+    try{
+        streamed.appendRow(std::istream_iterator<int>(short_in), std::istream_iterator<int>());
+        ASSERT_TEST(false);
+    }
+    catch (const Matrix<int>::DimensionMismatch& e){
+        ASSERT_TEST(string(e.what()) == "Mtm matrix error: Dimension mismatch: (2,3) (1,2)");
+    }
+    std::istringstream first_in("9 10");
+    Matrix<int> first = Matrix<int>::FromRow(std::istream_iterator<int>(first_in), std::istream_iterator<int>());
+    ASSERT_TEST(streamed.height() == 2 && first.width() == 2 && first(0,1) == 10);
+
+    // A row of the wrong width, or an empty first row, is rejected
+    try{
+        matrix.appendRow({1, 2, 3});
+        ASSERT_TEST(false);
+    }
+    catch (const Matrix<int>::DimensionMismatch& e){
+        ASSERT_TEST(string(e.what()) == "Mtm matrix error: Dimension mismatch: (200,5) (1,3)");
+    }
+    try{
+        Matrix<int>::FromRow(row, row);
+        ASSERT_TEST(false);
+    }
+    catch (const Matrix<int>::IllegalInitialization&){}
+
+    // A row that fails halfway is not appended
+    Fragile::copies_left = 10;
+    Matrix<Fragile> fragile(Dimensions(1,3), Fragile(0));
+    std::vector<Fragile> bad_row(3, Fragile(1));
+    fragile.reserveRows(2);
+    Fragile::copies_left = 2;
+    try{
+        fragile.appendRow(bad_row.begin(), bad_row.end());
+        ASSERT_TEST(false);
+    }
+    catch (const std::runtime_error&){}
+    ASSERT_TEST(fragile.height() == 1 && fragile.size() == 3);
+    Fragile::copies_left = 3;
+    fragile.appendRow(bad_row.begin(), bad_row.end());
+    ASSERT_TEST(fragile.height() == 2 && fragile(1,2).get() == 1);
+
+    return true;
+
+}
+
 bool run_test(std::function<bool()> test, std::string test_name){
     if(!test()){
         cout<<test_name<<" - FAILED."<<endl;
@@ -1007,6 +1303,10 @@ int main(){
     ADD_TEST(testLogicalAnyAll);
     ADD_TEST(testApply);
     ADD_TEST(testOperatorParenthesis);
+    ADD_TEST(testAllocations);
+    ADD_TEST(testRawStorage);
+    ADD_TEST(testGrowableArray);
+    ADD_TEST(testAppendRow);
 
     int passed = 0;
     for (std::pair<std::string, std::function<bool()>> element : tests)
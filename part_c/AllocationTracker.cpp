@@ -0,0 +1,103 @@
+#include <cstdlib>
+#include <new>
+#include "AllocationTracker.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        /* Constant-initialized, so counting never allocates, not even on a new thread */
+        thread_local AllocationTotals thread_totals = {0, 0, 0};
+
+        void* allocate(std::size_t size)
+        {
+            // Like the default operator new: retry through the new handler until it gives up
+            void* memory = nullptr;
+            while((memory = std::malloc((size == 0)? 1 : size)) == nullptr)
+            {
+                std::new_handler handler = std::get_new_handler();
+                if(handler == nullptr)
+                {
+                    throw std::bad_alloc();
+                }
+                handler();
+            }
+            thread_totals.allocations++;
+            thread_totals.bytes += size;
+            return memory;
+        }
+
+        void* allocateNoThrow(std::size_t size) noexcept
+        {
+            try
+            {
+                return allocate(size);
+            } catch (...) {
+                return nullptr;
+            }
+        }
+
+        void deallocate(void* memory) noexcept
+        {
+            if(memory != nullptr)
+            {
+                thread_totals.deallocations++;
+                std::free(memory);
+            }
+        }
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    AllocationTotals AllocationCounter::totals() noexcept
+    {
+        return thread_totals;
+    }
+}
+
+/****************************************/
+/*   Global operator new and delete     */
+/****************************************/
+void* operator new(std::size_t size)
+{
+    return mtm::allocate(size);
+}
+
+void* operator new[](std::size_t size)
+{
+    return mtm::allocate(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return mtm::allocateNoThrow(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return mtm::allocateNoThrow(size);
+}
+
+void operator delete(void* memory) noexcept
+{
+    mtm::deallocate(memory);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    mtm::deallocate(memory);
+}
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+    mtm::deallocate(memory);
+}
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+    mtm::deallocate(memory);
+}
@@ -0,0 +1,93 @@
+#ifndef ALLOCATION_TRACKER_INC
+#define ALLOCATION_TRACKER_INC
+// Includes
+#include <cstddef>
+#include <cstdint>
+//---------
+
+namespace mtm
+{
+    /*
+     * Struct: AllocationTotals
+     * ---------------------------------------
+     * The heap allocations a thread made through the global operator new
+     * (and the matching deletes) since it started.
+     */
+    struct AllocationTotals
+    {
+        std::uint64_t allocations;
+        std::uint64_t deallocations;
+        std::uint64_t bytes;
+    };
+
+    /*
+     * Class: AllocationCounter
+     * ---------------------------------------
+     * Counts the heap allocations the calling thread makes while the counter
+     * is alive, so a test can assert how many allocations a piece of code makes.
+     * Allocations of other threads are never counted.
+     *
+     * The counts come from replacements of the global operator new and delete
+     * in AllocationTracker.cpp, which only the testers link: a program that
+     * uses an AllocationCounter without linking it does not build.
+     */
+    class AllocationCounter
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        /* Instance variables */
+        AllocationTotals start;
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: AllocationCounter
+         * Usage: AllocationCounter counter;
+         * ---------------------------------------
+         * Starts counting from zero.
+         */
+        AllocationCounter() noexcept : start(totals()) { }
+        AllocationCounter(const AllocationCounter&) = delete;
+        AllocationCounter& operator=(const AllocationCounter&) = delete;
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Function: totals
+         * Usage: AllocationTotals totals = AllocationCounter::totals();
+         * -----------------------------------
+         * Returns the allocations of the calling thread since it started.
+         */
+        static AllocationTotals totals() noexcept;
+
+        /*
+         * Method: allocations, deallocations, bytes, reset
+         * Usage: std::uint64_t allocations = counter.allocations();
+         * -----------------------------------
+         * Return the number of allocations, of deallocations and of bytes
+         * allocated since the counter was created or last reset.
+         * reset starts counting from zero again.
+         */
+        std::uint64_t allocations() const noexcept
+        {
+            return totals().allocations - start.allocations;
+        }
+        std::uint64_t deallocations() const noexcept
+        {
+            return totals().deallocations - start.deallocations;
+        }
+        std::uint64_t bytes() const noexcept
+        {
+            return totals().bytes - start.bytes;
+        }
+        void reset() noexcept
+        {
+            start = totals();
+        }
+    };
+}
+#endif
@@ -1,6 +1,14 @@
 #ifndef _ARRAY_INC
 #define _ARRAY_INC
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace mtm
 {
@@ -10,7 +18,110 @@ namespace mtm
     private:
         /* Instance variables */
         T* data;
-        int max_size;
+        int max_size;       /* The number of elements                          */
+        int allocated;      /* The number of elements the storage has room for */
+
+        /*
+         * Elements live in raw storage, and are constructed in place, so no
+         * element is ever default-constructed only to be assigned over.
+         * Trivially copyable elements are copied with memcpy.
+         */
+        static const bool TRIVIAL = std::is_trivially_copyable<T>::value;
+
+        /* Allocates storage for size elements, without constructing them */
+        static T* allocate(int size)
+        {
+            if (size <= 0)
+            {
+                return nullptr;
+            }
+            return static_cast<T*>(::operator new(sizeof(T) * static_cast<size_t>(size)));
+        }
+
+        /* Destroys the size elements of storage, and frees it */
+        static void release(T* storage, int size) noexcept
+        {
+            if (!std::is_trivially_destructible<T>::value)
+            {
+                for (int i = 0; i < size; i++)
+                {
+                    storage[i].~T();
+                }
+            }
+            ::operator delete(storage);
+        }
+
+        /*
+         * Constructs the size elements of source in the raw storage, moving
+         * them, or copying them if their move constructor may throw (and they
+         * can be copied), so that a failure leaves source unchanged.
+         */
+        static void relocate(T* source, int size, T* storage)
+        {
+            if (TRIVIAL)
+            {
+                if (size > 0)
+                {
+                    std::memcpy(static_cast<void*>(storage), source, sizeof(T) * static_cast<size_t>(size));
+                }
+                return;
+            }
+            int constructed = 0;
+            try
+            {
+                for (; constructed < size; constructed++)
+                {
+                    new (storage + constructed) T(std::move_if_noexcept(source[constructed]));
+                }
+            } catch (...) {
+                for (int i = 0; i < constructed; i++)
+                {
+                    storage[i].~T();
+                }
+                throw;
+            }
+        }
+
+        /* Moves the elements to new storage for new_capacity elements */
+        void reallocate(int new_capacity)
+        {
+            T* storage = allocate(new_capacity);
+            try
+            {
+                relocate(data, max_size, storage);
+            } catch (...) {
+                ::operator delete(storage);
+                throw;
+            }
+            release(data, max_size);
+            data = storage;
+            allocated = new_capacity;
+        }
+
+        /* The capacity to grow to for one more element: double the current one */
+        int grownCapacity() const
+        {
+            if (allocated == std::numeric_limits<int>::max())
+            {
+                throw std::length_error("Array is full");
+            }
+            return (allocated > std::numeric_limits<int>::max() / 2)?
+                std::numeric_limits<int>::max() : std::max(1, allocated * 2);
+        }
+
+        /* True if every byte of value is the same, so memset can fill with it */
+        static bool isByteRepeated(const T& value) noexcept
+        {
+            const unsigned char* bytes = reinterpret_cast<const unsigned char*>(std::addressof(value));
+            for (size_t i = 1; i < sizeof(T); i++)
+            {
+                if (bytes[i] != bytes[0])
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
     public:
         /*********************************/
         /*        Public Section        */
@@ -18,44 +129,93 @@ namespace mtm
         /*
          * Constructor: Array<T>
          * Usage: Array<T> new_array(size);
+         *        Array<T> new_array(size, value);
          * ---------------------------------
          * Initializes a new Array that stores objects of type <T>.
          * The default constructor creates an empty Array.
-         * The second form creates and allocates an array with size elements.
-         * The max size of the array is constant and cannot be realloced.
-         * 
+         * The second form creates an array with size default-initialized
+         * elements (left uninitialized for types like int, as with new T[]),
+         * and the third an array with size copies of value, so T only needs
+         * a default constructor for the second form.
+         * The array can grow later on, see push_back.
+         *
          * Possible exceptions:
-         * std::bad_alloc
-         */   
-        explicit Array(int size) : data(new T[size]), max_size(size) { }
-        Array() : data(nullptr), max_size(0) { };
+         * std::bad_alloc, or whatever the constructor of T throws.
+         */
+        explicit Array(int size) : data(allocate(size)), max_size(std::max(size, 0)), allocated(max_size)
+        {
+            int constructed = 0;
+            try
+            {
+                for (; constructed < max_size; constructed++)
+                {
+                    new (data + constructed) T;
+                }
+            } catch (...) {
+                release(data, constructed);
+                throw;
+            }
+        }
+        Array(int size, const T& value) : data(allocate(size)), max_size(std::max(size, 0)), allocated(max_size)
+        {
+            if (TRIVIAL && isByteRepeated(value))
+            {
+                std::memset(static_cast<void*>(data), *reinterpret_cast<const unsigned char*>(std::addressof(value)),
+                            sizeof(T) * static_cast<size_t>(max_size));
+                return;
+            }
+            try
+            {
+                std::uninitialized_fill_n(data, max_size, value);
+            } catch (...) {
+                ::operator delete(data);
+                throw;
+            }
+        }
+        Array() : data(nullptr), max_size(0), allocated(0) { };
 
         /*
          * Copy Constructor: Array<T>
          * Usage: Array<t> new_array = arr;
          * --------------------------------
-         * Initializes a new Array.  
+         * Initializes a new Array.
          * Creates a new array that is a copy of arr.
-         * 
+         *
          * Possible exceptions:
-         * No assignment operator to class T, std::bad_aloc
+         * std::bad_alloc, or whatever the copy constructor of T throws.
          */
-        Array(const Array& arr) : max_size(arr.size())
+        Array(const Array& arr) : data(allocate(arr.size())), max_size(arr.size()), allocated(max_size)
         {
-            T* new_data = new T[arr.size()];
-            try
+            if (TRIVIAL)
             {
-                for (int i =0 ; i < arr.size(); i++)
+                if (max_size > 0)
                 {
-                    new_data[i] = arr[i];
+                    std::memcpy(static_cast<void*>(data), arr.data, sizeof(T) * static_cast<size_t>(max_size));
                 }
+                return;
+            }
+            try
+            {
+                std::uninitialized_copy(arr.data, arr.data + max_size, data);
             } catch (...) {
-                delete[] new_data;
+                ::operator delete(data);
                 throw;
             }
-            data = new_data;
         }
-        
+
+        /*
+         * Move Constructor: Array<T>
+         * Usage: Array<T> new_array = std::move(arr);
+         * --------------------------------
+         * Takes the elements of arr, which is left empty.
+         */
+        Array(Array&& arr) noexcept : data(arr.data), max_size(arr.max_size), allocated(arr.allocated)
+        {
+            arr.data = nullptr;
+            arr.max_size = 0;
+            arr.allocated = 0;
+        }
+
         /*
          * Destructor: ~Array<T>
          * ---------------------
@@ -63,18 +223,24 @@ namespace mtm
          */
         ~Array()
         {
-            delete[] data;
+            release(data, max_size);
         }
 
         /*
          * Operator: =
          * Usage: this_array = target_arr;
+         *        this_array = std::move(target_arr);
          * ----------------------
          * Replaces every single element in the left hand array to be equal
          * to target_arr's elements.
-         * 
+         * An array of the same size keeps its storage when copying into it
+         * cannot throw; otherwise the copy is built aside first, so a failed
+         * assignment leaves the array unchanged.
+         * The second form takes the elements of target_arr instead, leaving
+         * target_arr empty.
+         *
          * Possible exceptions:
-         * No assignment operator to class T, std::bad_aloc
+         * std::bad_alloc, or whatever the copy constructor of T throws.
          */
         Array& operator=(const Array& target_arr)
         {
@@ -82,21 +248,40 @@ namespace mtm
             {
                 return *this;
             }
-            T* temp_data = new T[target_arr.size()];
-            try 
+            if (max_size == target_arr.max_size && (TRIVIAL || std::is_nothrow_copy_assignable<T>::value))
             {
-                for(int i = 0 ; i < target_arr.size(); i++)
+                if (TRIVIAL)
                 {
-                    temp_data[i] = target_arr[i];
+                    if (max_size > 0)
+                    {
+                        std::memcpy(static_cast<void*>(data), target_arr.data,
+                                    sizeof(T) * static_cast<size_t>(max_size));
+                    }
                 }
-            } catch (...) {
-                delete[] temp_data;
-                throw;
+                else
+                {
+                    std::copy(target_arr.data, target_arr.data + max_size, data);
+                }
+                return *this;
+            }
+            Array copy(target_arr);
+            std::swap(data, copy.data);
+            std::swap(max_size, copy.max_size);
+            std::swap(allocated, copy.allocated);
+            return *this;
+        }
+        Array& operator=(Array&& target_arr) noexcept
+        {
+            if (this != &target_arr)
+            {
+                release(data, max_size);
+                data = target_arr.data;
+                max_size = target_arr.max_size;
+                allocated = target_arr.allocated;
+                target_arr.data = nullptr;
+                target_arr.max_size = 0;
+                target_arr.allocated = 0;
             }
-
-            delete[] data;
-            data = temp_data;
-            max_size = target_arr.max_size;
             return *this;
         }
 
@@ -111,6 +296,103 @@ namespace mtm
             return max_size;
         }
 
+        /*
+         * Method: capacity, reserve, shrink_to_fit
+         * Usage: this_arr.reserve(rows * columns);
+         * -----------------------------------
+         * capacity returns the number of elements the array has room for
+         * without reallocating, reserve makes room for at least new_capacity
+         * elements, and shrink_to_fit frees the room beyond size().
+         * A reallocation moves the elements when their move constructor
+         * cannot throw, and copies them otherwise, so a failed one leaves the
+         * array unchanged. It invalidates references to the elements.
+         *
+         * Possible exceptions:
+         * std::bad_alloc, or whatever the copy constructor of T throws.
+         */
+        int capacity() const noexcept
+        {
+            return allocated;
+        }
+        void reserve(int new_capacity)
+        {
+            if (new_capacity > allocated)
+            {
+                reallocate(new_capacity);
+            }
+        }
+        void shrink_to_fit()
+        {
+            if (allocated > max_size)
+            {
+                reallocate(max_size);
+            }
+        }
+
+        /*
+         * Method: push_back, emplace_back, pop_back
+         * Usage: this_arr.push_back(element);
+         *        this_arr.emplace_back(constructor_arguments...);
+         *        this_arr.pop_back();
+         * -----------------------------------
+         * push_back appends a copy of element (or moves it, if it is an
+         * rvalue), emplace_back appends an element constructed in place from
+         * the given arguments and returns it, and pop_back destroys the last
+         * element. When the array is full, its capacity doubles, so appending
+         * takes amortized constant time.
+         * If appending fails, the array is left unchanged.
+         * pop_back ASSUMES the array is not empty.
+         *
+         * Possible exceptions:
+         * std::bad_alloc, std::length_error once the array holds INT_MAX
+         * elements, or whatever the constructors of T throw.
+         */
+        void push_back(const T& element)
+        {
+            emplace_back(element);
+        }
+        void push_back(T&& element)
+        {
+            emplace_back(std::move(element));
+        }
+        template<typename... ARGUMENTS>
+        T& emplace_back(ARGUMENTS&&... arguments)
+        {
+            if (max_size == allocated)
+            {
+                // Build the element before moving the others, as the arguments may refer to them
+                int new_capacity = grownCapacity();
+                T* storage = allocate(new_capacity);
+                try
+                {
+                    new (storage + max_size) T(std::forward<ARGUMENTS>(arguments)...);
+                } catch (...) {
+                    ::operator delete(storage);
+                    throw;
+                }
+                try
+                {
+                    relocate(data, max_size, storage);
+                } catch (...) {
+                    storage[max_size].~T();
+                    ::operator delete(storage);
+                    throw;
+                }
+                release(data, max_size);
+                data = storage;
+                allocated = new_capacity;
+            }
+            else
+            {
+                new (data + max_size) T(std::forward<ARGUMENTS>(arguments)...);
+            }
+            return data[max_size++];
+        }
+        void pop_back() noexcept
+        {
+            data[--max_size].~T();
+        }
+
         /*
          * Operator: []
          * Usage: T element = this_arr[index];
@@ -127,4 +409,4 @@ namespace mtm
         }
     };
 }
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,123 @@
+#include "Bitboard.h"
+
+namespace mtm
+{
+    /***************************************/
+    /*     Ctors implementation section    */
+    /***************************************/
+    OccupancyBitboards::OccupancyBitboards(int height, int width, bool sparse) :
+    height(height), width(width),
+    row_words((width + WORD_BITS - 1) / WORD_BITS), col_words((height + WORD_BITS - 1) / WORD_BITS),
+    sparse(sparse), tiles()
+    {
+        if(sparse)
+        {
+            return;
+        }
+        for(int team = CPP; team <= PYTHON; team++)
+        {
+            rows[team].assign(static_cast<size_t>(height) * row_words, 0);
+            cols[team].assign(static_cast<size_t>(width) * col_words, 0);
+        }
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    void OccupancyBitboards::clear() noexcept
+    {
+        for(int team = CPP; team <= PYTHON; team++)
+        {
+            std::fill(rows[team].begin(), rows[team].end(), 0);
+            std::fill(cols[team].begin(), cols[team].end(), 0);
+        }
+        tiles.clear();
+    }
+
+    size_t OccupancyBitboards::memoryUsage() const noexcept
+    {
+        size_t bytes = sizeof(OccupancyBitboards) + tiles.size() * sizeof(Tile);
+        for(int team = CPP; team <= PYTHON; team++)
+        {
+            bytes += (rows[team].capacity() + cols[team].capacity()) * sizeof(std::uint64_t);
+        }
+        return bytes;
+    }
+
+    int OccupancyBitboards::countInRow(Team team, int row, int first_col, int last_col) const noexcept
+    {
+        first_col = std::max(first_col, 0);
+        last_col = std::min(last_col, width - 1);
+        if(row < 0 || row >= height || first_col > last_col)
+        {
+            return 0;
+        }
+        return countSpan([&](int word) { return rowWord(team, row, word); }, first_col, last_col);
+    }
+
+    int OccupancyBitboards::countInColumn(Team team, int col, int first_row, int last_row) const noexcept
+    {
+        first_row = std::max(first_row, 0);
+        last_row = std::min(last_row, height - 1);
+        if(col < 0 || col >= width || first_row > last_row)
+        {
+            return 0;
+        }
+        return countSpan([&](int word) { return colWord(team, col, word); }, first_row, last_row);
+    }
+
+    bool OccupancyBitboards::isRowClear(int row, int first_col, int last_col) const noexcept
+    {
+        return countInRow(CPP, row, first_col, last_col) == 0 && countInRow(PYTHON, row, first_col, last_col) == 0;
+    }
+
+    bool OccupancyBitboards::isColumnClear(int col, int first_row, int last_row) const noexcept
+    {
+        return countInColumn(CPP, col, first_row, last_row) == 0 &&
+                countInColumn(PYTHON, col, first_row, last_row) == 0;
+    }
+
+    int OccupancyBitboards::countInRing(Team team, const GridPoint& center, int inner, int outer) const noexcept
+    {
+        int count = 0;
+        forEachRingSpan(center, inner, outer, [&](int row, int first_col, int last_col)
+        {
+            count += countSpan([&](int word) { return rowWord(team, row, word); }, first_col, last_col);
+        });
+        return count;
+    }
+
+    /* Private Methods */
+    void OccupancyBitboards::setSparse(const GridPoint& cell, Team team)
+    {
+        Tile& tile = tiles.obtain(cell.row / WORD_BITS, cell.col / WORD_BITS);
+        std::uint64_t& row_word = tile.rows[team][cell.row % WORD_BITS];
+        std::uint64_t bit = 1ULL << (cell.col % WORD_BITS);
+        if(!((tile.rows[CPP][cell.row % WORD_BITS] | tile.rows[PYTHON][cell.row % WORD_BITS]) & bit))
+        {
+            tile.occupied++;
+        }
+        row_word |= bit;
+        tile.cols[team][cell.col % WORD_BITS] |= 1ULL << (cell.row % WORD_BITS);
+    }
+
+    void OccupancyBitboards::resetSparse(const GridPoint& cell) noexcept
+    {
+        Tile* tile = tiles.find(cell.row / WORD_BITS, cell.col / WORD_BITS);
+        if(tile == nullptr)
+        {
+            return;
+        }
+        std::uint64_t bit = 1ULL << (cell.col % WORD_BITS);
+        bool was_occupied = (tile->rows[CPP][cell.row % WORD_BITS] | tile->rows[PYTHON][cell.row % WORD_BITS]) & bit;
+        for(int team = CPP; team <= PYTHON; team++)
+        {
+            tile->rows[team][cell.row % WORD_BITS] &= ~bit;
+            tile->cols[team][cell.col % WORD_BITS] &= ~(1ULL << (cell.row % WORD_BITS));
+        }
+        if(was_occupied && --tile->occupied == 0)
+        {
+            tiles.vacate(cell.row / WORD_BITS, cell.col / WORD_BITS);
+        }
+    }
+}
@@ -0,0 +1,342 @@
+#ifndef BITBOARD_INC
+#define BITBOARD_INC
+// Includes
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "Auxiliaries.h"
+#include "TileMap.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: OccupancyBitboards
+     * ---------------------------------------
+     * One bit per cell and per team, telling whether a character of that team
+     * stands in the cell.
+     * Every team has two copies of its bits: a row-major one, where each board
+     * row is a run of 64-bit words, and a column-major (transposed) one, where
+     * each board column is. Row, column and diamond queries then work on whole
+     * words with masks and popcounts, instead of visiting cell by cell:
+     * a span of n cells costs about n / 64 word operations.
+     * The bits of a sparse board are kept in a TileMap of 64 x 64 tiles, each
+     * holding the 64 row words and the 64 column words of its cells, so they
+     * take memory only around the occupied cells, and reading a word costs a
+     * hash lookup.
+     */
+    class OccupancyBitboards
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        static const int WORD_BITS = 64;
+        struct Tile
+        {
+            std::uint64_t rows[2][WORD_BITS];   /* Indexed by Team, then by the row in the tile */
+            std::uint64_t cols[2][WORD_BITS];   /* Indexed by Team, then by the column in the tile */
+            int occupied;
+
+            Tile() : rows(), cols(), occupied(0) { }
+        };
+
+        /* Instance variables */
+        int height;
+        int width;
+        int row_words;                          /* Words per board row */
+        int col_words;                          /* Words per board column */
+        bool sparse;
+        std::vector<std::uint64_t> rows[2];     /* Indexed by Team, dense boards only */
+        std::vector<std::uint64_t> cols[2];     /* Indexed by Team, dense boards only */
+        TileMap<Tile> tiles;                    /* Sparse boards only */
+
+        /* The given word of a row (column) */
+        std::uint64_t rowWord(int team, int row, int word) const noexcept
+        {
+            if(!sparse)
+            {
+                return rows[team][static_cast<size_t>(row) * row_words + word];
+            }
+            const Tile* tile = tiles.find(row / WORD_BITS, word);
+            return (tile == nullptr)? 0 : tile->rows[team][row % WORD_BITS];
+        }
+        std::uint64_t colWord(int team, int col, int word) const noexcept
+        {
+            if(!sparse)
+            {
+                return cols[team][static_cast<size_t>(col) * col_words + word];
+            }
+            const Tile* tile = tiles.find(word, col / WORD_BITS);
+            return (tile == nullptr)? 0 : tile->cols[team][col % WORD_BITS];
+        }
+
+        /* Private Methods */
+        static int popcount(std::uint64_t word) noexcept
+        {
+#if defined(__GNUC__)
+            return __builtin_popcountll(word);
+#else
+            int count = 0;
+            for(; word != 0; word &= word - 1)
+            {
+                count++;
+            }
+            return count;
+#endif
+        }
+
+        static int lowestBit(std::uint64_t word) noexcept
+        {
+#if defined(__GNUC__)
+            return __builtin_ctzll(word);
+#else
+            int bit = 0;
+            while(!(word & 1))
+            {
+                word >>= 1;
+                bit++;
+            }
+            return bit;
+#endif
+        }
+
+        /* The mask of the bits first..last (inclusive) of a word */
+        static std::uint64_t spanMask(int first, int last) noexcept
+        {
+            std::uint64_t high = (last == WORD_BITS - 1)? ~0ULL : ((1ULL << (last + 1)) - 1);
+            return high & ~((1ULL << first) - 1);
+        }
+
+        /*
+         * Counts the set bits first..last (inclusive, in range) of a line of words,
+         * where word_at(i) returns the i-th word of the line
+         */
+        template<typename WORD_AT>
+        static int countSpan(WORD_AT word_at, int first, int last) noexcept
+        {
+            int first_word = first / WORD_BITS, last_word = last / WORD_BITS;
+            if(first_word == last_word)
+            {
+                return popcount(word_at(first_word) & spanMask(first % WORD_BITS, last % WORD_BITS));
+            }
+            int count = popcount(word_at(first_word) & spanMask(first % WORD_BITS, WORD_BITS - 1));
+            for(int word = first_word + 1; word < last_word; word++)
+            {
+                count += popcount(word_at(word));
+            }
+            return count + popcount(word_at(last_word) & spanMask(0, last % WORD_BITS));
+        }
+
+        /* Calls visit(index) for every set bit first..last (inclusive, in range) of a line of words */
+        template<typename WORD_AT, typename VISITOR>
+        static void forEachInSpan(WORD_AT word_at, int first, int last, VISITOR visit)
+        {
+            for(int word = first / WORD_BITS; word <= last / WORD_BITS; word++)
+            {
+                int low = std::max(first - word * WORD_BITS, 0);
+                int high = std::min(last - word * WORD_BITS, WORD_BITS - 1);
+                for(std::uint64_t bits = word_at(word) & spanMask(low, high); bits != 0; bits &= bits - 1)
+                {
+                    visit(word * WORD_BITS + lowestBit(bits));
+                }
+            }
+        }
+
+        void setSparse(const GridPoint& cell, Team team);
+        void resetSparse(const GridPoint& cell) noexcept;
+
+        /*
+         * Calls span(row, first_col, last_col) for every row span of the cells
+         * whose distance from center is between inner and outer, clipped to the board.
+         */
+        template<typename SPAN>
+        void forEachRingSpan(const GridPoint& center, int inner, int outer, SPAN span) const
+        {
+            inner = std::max(inner, 0);
+            outer = std::min(outer, height + width); // No cell is farther, and this can not overflow
+            if(outer < inner)
+            {
+                return;
+            }
+            int first_row = std::max(0, center.row - outer);
+            int last_row = std::min(height - 1, center.row + outer);
+            for(int row = first_row; row <= last_row; row++)
+            {
+                int row_distance = std::abs(row - center.row);
+                int outer_half = outer - row_distance;
+                int hole_half = inner - 1 - row_distance; // Columns within it are closer than inner
+                int first_col = std::max(0, center.col - outer_half);
+                int last_col = std::min(width - 1, center.col + outer_half);
+                if(hole_half < 0)
+                {
+                    if(first_col <= last_col)
+                    {
+                        span(row, first_col, last_col);
+                    }
+                    continue;
+                }
+                int left_end = std::min(last_col, center.col - hole_half - 1);
+                int right_begin = std::max(first_col, center.col + hole_half + 1);
+                if(first_col <= left_end)
+                {
+                    span(row, first_col, left_end);
+                }
+                if(right_begin <= last_col)
+                {
+                    span(row, right_begin, last_col);
+                }
+            }
+        }
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: OccupancyBitboards
+         * Usage: OccupancyBitboards occupancy(height, width);
+         *        OccupancyBitboards occupancy(height, width, sparse);
+         * ---------------------------------------
+         * Creates empty bitboards for a height x width board, dense or sparse.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        OccupancyBitboards(int height, int width, bool sparse = false);
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: set, reset, test
+         * Usage: occupancy.set(cell, team);
+         *        occupancy.reset(cell);
+         *        if(occupancy.test(cell, team)) ...
+         * -----------------------------------
+         * set marks cell as occupied by team, reset marks it as empty (for both
+         * teams), and test returns whether team occupies cell.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (set only, when a sparse board allocates a tile)
+         */
+        void set(const GridPoint& cell, Team team)
+        {
+            if(sparse)
+            {
+                setSparse(cell, team);
+                return;
+            }
+            size_t row_word = static_cast<size_t>(cell.row) * row_words + cell.col / WORD_BITS;
+            size_t col_word = static_cast<size_t>(cell.col) * col_words + cell.row / WORD_BITS;
+            rows[team][row_word] |= 1ULL << (cell.col % WORD_BITS);
+            cols[team][col_word] |= 1ULL << (cell.row % WORD_BITS);
+        }
+        void reset(const GridPoint& cell) noexcept
+        {
+            if(sparse)
+            {
+                resetSparse(cell);
+                return;
+            }
+            size_t row_word = static_cast<size_t>(cell.row) * row_words + cell.col / WORD_BITS;
+            size_t col_word = static_cast<size_t>(cell.col) * col_words + cell.row / WORD_BITS;
+            for(int team = CPP; team <= PYTHON; team++)
+            {
+                rows[team][row_word] &= ~(1ULL << (cell.col % WORD_BITS));
+                cols[team][col_word] &= ~(1ULL << (cell.row % WORD_BITS));
+            }
+        }
+        bool test(const GridPoint& cell, Team team) const noexcept
+        {
+            return (rowWord(team, cell.row, cell.col / WORD_BITS) >> (cell.col % WORD_BITS)) & 1;
+        }
+
+        /*
+         * Method: clear
+         * Usage: occupancy.clear();
+         * -----------------------------------
+         * Marks every cell as empty.
+         */
+        void clear() noexcept;
+
+        /*
+         * Method: retainEmptyTiles
+         * Usage: occupancy.retainEmptyTiles(true);
+         * -----------------------------------
+         * While retained, the tiles of a sparse board are not freed when they
+         * empty (see TileMap::retainEmptyTiles).
+         */
+        void retainEmptyTiles(bool retain) noexcept
+        {
+            tiles.retainEmptyTiles(retain);
+        }
+
+        /*
+         * Method: memoryUsage
+         * Usage: size_t bytes = occupancy.memoryUsage();
+         * -----------------------------------
+         * Returns the approximate number of bytes held by the bits.
+         */
+        size_t memoryUsage() const noexcept;
+
+        /*
+         * Method: countInRow, countInColumn
+         * Usage: int enemies = occupancy.countInRow(team, row, first_col, last_col);
+         *        int enemies = occupancy.countInColumn(team, col, first_row, last_row);
+         * -----------------------------------
+         * Returns the number of cells of the given row (column) span, inclusive
+         * and clipped to the board, that team occupies.
+         */
+        int countInRow(Team team, int row, int first_col, int last_col) const noexcept;
+        int countInColumn(Team team, int col, int first_row, int last_row) const noexcept;
+
+        /*
+         * Method: isRowClear, isColumnClear
+         * Usage: if(occupancy.isRowClear(row, first_col, last_col)) ...
+         * -----------------------------------
+         * Returns true if no character of any team stands in the given row
+         * (column) span, inclusive and clipped to the board.
+         */
+        bool isRowClear(int row, int first_col, int last_col) const noexcept;
+        bool isColumnClear(int col, int first_row, int last_row) const noexcept;
+
+        /*
+         * Method: countInRing, countInRange
+         * Usage: int targets = occupancy.countInRing(team, center, inner, outer);
+         *        int targets = occupancy.countInRange(team, center, radius);
+         * -----------------------------------
+         * Returns the number of characters of team whose distance from center
+         * is between inner and outer (at most radius).
+         */
+        int countInRing(Team team, const GridPoint& center, int inner, int outer) const noexcept;
+        int countInRange(Team team, const GridPoint& center, int radius) const noexcept
+        {
+            return countInRing(team, center, 0, radius);
+        }
+
+        /*
+         * Method: forEachInRing
+         * Usage: occupancy.forEachInRing(team, center, inner, outer, visit);
+         * -----------------------------------
+         * Calls visit(cell, distance) for every cell occupied by team whose
+         * distance from center is between inner and outer, row by row.
+         *
+         * Assumptions on VISITOR:
+         * • Callable as visit(const GridPoint&, int).
+         */
+        template<typename VISITOR>
+        void forEachInRing(Team team, const GridPoint& center, int inner, int outer, VISITOR visit) const
+        {
+            forEachRingSpan(center, inner, outer, [&](int row, int first_col, int last_col)
+            {
+                int row_distance = std::abs(row - center.row);
+                forEachInSpan([&](int word) { return rowWord(team, row, word); }, first_col, last_col, [&](int col)
+                {
+                    visit(GridPoint(row, col), row_distance + std::abs(col - center.col));
+                });
+            });
+        }
+    };
+}
+#endif
@@ -20,13 +20,23 @@ namespace mtm
         return team;
     }
 
-    units_t Character::getRange() const
+    units_t Character::getAmmo() const noexcept
+    {
+        return ammo;
+    }
+
+    units_t Character::getRange() const noexcept
     {
         return range;
     }
     
-    units_t Character::getPower() const
+    units_t Character::getPower() const noexcept
     {
         return power;
     }
+
+    int Character::getComboCount() const noexcept
+    {
+        return 0;
+    }
 }
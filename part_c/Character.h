@@ -3,7 +3,6 @@
 // Includes
 #include <iostream>
 #include <memory>
-#include "Matrix.h"
 #include "Auxiliaries.h"
 #include "Exceptions.h"
 //---------
@@ -27,9 +26,6 @@ namespace mtm
         /*********************************/
         units_t health;
         units_t ammo;
-
-        units_t getRange() const;
-        units_t getPower() const;
     public:
         /**************************************/
         /*     C'tors and D'tors section      */
@@ -50,6 +46,14 @@ namespace mtm
          */
         virtual char getName() const = 0;
 
+        /*
+         * Method: getType
+         * Usage: CharacterType type = character.getType();
+         * -----------------------------------
+         * Returns the type of the character.
+         */
+        virtual CharacterType getType() const noexcept = 0;
+
         /*
          * Method: getTeam
          * Usage: Team team = character.getTeam();
@@ -66,6 +70,33 @@ namespace mtm
          */
         units_t getHealth() const noexcept;
 
+        /*
+         * Method: getAmmo
+         * Usage: units_t ammo = character.getAmmo();
+         * -----------------------------------
+         * Returns the current ammo of the character.
+         */
+        units_t getAmmo() const noexcept;
+
+        /*
+         * Method: getRange, getPower
+         * Usage: units_t range = character.getRange();
+         *        units_t power = character.getPower();
+         * -----------------------------------
+         * Returns the attack range / power of the character.
+         */
+        units_t getRange() const noexcept;
+        units_t getPower() const noexcept;
+
+        /*
+         * Method: getComboCount
+         * Usage: int combo = character.getComboCount();
+         * -----------------------------------
+         * Returns the number of consecutive attacks counted towards the
+         * character's next combo attack. Characters without combos return 0.
+         */
+        virtual int getComboCount() const noexcept;
+
         /*
          * Method: setHealth
          * Usage: character.setHealth(new_health);
@@ -82,6 +113,7 @@ namespace mtm
          * Usage: shared_ptr<Character> copied_character = character.clone();
          * -----------------------------------
          * Returns a shared_ptr to a copy of a copied character.
+         * Like Game::makeCharacter, the copy is allocated from a PoolAllocator.
          */
         virtual std::shared_ptr<Character> clone() const = 0;
 
@@ -90,7 +122,6 @@ namespace mtm
         virtual bool isInAttackRange(const GridPoint& src_coordinates , const GridPoint& dst_coordinates) const noexcept = 0;
         virtual bool isLegalMove(int distance) const noexcept = 0;
         virtual bool hasEnoughAmmo() const noexcept = 0;
-        virtual void attack(Matrix<std::shared_ptr<Character>>board, const GridPoint& src_coordinates , const GridPoint& dst_coordinates) = 0;
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "CharacterStore.h"
+
+namespace mtm
+{
+    const int CharacterStore::NO_CHARACTER;
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    int CharacterStore::add(CharacterType type, Team team, units_t health, units_t ammo,
+                            units_t range, units_t power, int combo_count, const GridPoint& position)
+    {
+        // Reserve every column first, so a failed allocation leaves the columns in sync
+        size_t new_size = types.size() + 1;
+        if(new_size > types.capacity())
+        {
+            size_t new_capacity = 2 * types.capacity() + 1;
+            types.reserve(new_capacity);
+            teams.reserve(new_capacity);
+            healths.reserve(new_capacity);
+            ammos.reserve(new_capacity);
+            ranges.reserve(new_capacity);
+            powers.reserve(new_capacity);
+            combo_counts.reserve(new_capacity);
+            rows.reserve(new_capacity);
+            cols.reserve(new_capacity);
+        }
+        types.push_back(type);
+        teams.push_back(team);
+        healths.push_back(health);
+        ammos.push_back(ammo);
+        ranges.push_back(range);
+        powers.push_back(power);
+        combo_counts.push_back(combo_count);
+        rows.push_back(position.row);
+        cols.push_back(position.col);
+        return size() - 1;
+    }
+
+    bool CharacterStore::remove(int id) noexcept
+    {
+        int last = size() - 1;
+        bool moved = (id != last);
+        if(moved)
+        {
+            types[id] = types[last];
+            teams[id] = teams[last];
+            healths[id] = healths[last];
+            ammos[id] = ammos[last];
+            ranges[id] = ranges[last];
+            powers[id] = powers[last];
+            combo_counts[id] = combo_counts[last];
+            rows[id] = rows[last];
+            cols[id] = cols[last];
+        }
+        types.pop_back();
+        teams.pop_back();
+        healths.pop_back();
+        ammos.pop_back();
+        ranges.pop_back();
+        powers.pop_back();
+        combo_counts.pop_back();
+        rows.pop_back();
+        cols.pop_back();
+        return moved;
+    }
+
+    CharacterStore::Record CharacterStore::getRecord(int id) const noexcept
+    {
+        Record record = {types[id], teams[id], healths[id], ammos[id], ranges[id],
+                            powers[id], combo_counts[id], rows[id], cols[id]};
+        return record;
+    }
+
+    void CharacterStore::setRecord(int id, const Record& record) noexcept
+    {
+        types[id] = record.type;
+        teams[id] = record.team;
+        healths[id] = record.health;
+        ammos[id] = record.ammo;
+        ranges[id] = record.range;
+        powers[id] = record.power;
+        combo_counts[id] = record.combo_count;
+        rows[id] = record.row;
+        cols[id] = record.col;
+    }
+
+    void CharacterStore::clear() noexcept
+    {
+        types.clear();
+        teams.clear();
+        healths.clear();
+        ammos.clear();
+        ranges.clear();
+        powers.clear();
+        combo_counts.clear();
+        rows.clear();
+        cols.clear();
+    }
+
+    /******************************************/
+    /*   Bulk queries implementation section  */
+    /******************************************/
+    int CharacterStore::count(Team team) const noexcept
+    {
+        int members = 0;
+        for(int i = 0; i < size(); i++)
+        {
+            members += (teams[i] == team);
+        }
+        return members;
+    }
+
+    units_t CharacterStore::totalHealth(Team team) const noexcept
+    {
+        units_t total = 0;
+        for(int i = 0; i < size(); i++)
+        {
+            total += (teams[i] == team)? healths[i] : 0;
+        }
+        return total;
+    }
+
+    units_t CharacterStore::totalAmmo(Team team) const noexcept
+    {
+        units_t total = 0;
+        for(int i = 0; i < size(); i++)
+        {
+            total += (teams[i] == team)? ammos[i] : 0;
+        }
+        return total;
+    }
+
+    void CharacterStore::findBelowHealth(units_t threshold, std::vector<int>& ids) const
+    {
+        for(int i = 0; i < size(); i++)
+        {
+            if(healths[i] < threshold)
+            {
+                ids.push_back(i);
+            }
+        }
+    }
+
+    void CharacterStore::applyDamage(const std::vector<int>& ids, units_t damage) noexcept
+    {
+        for(int id : ids)
+        {
+            healths[id] -= damage;
+        }
+    }
+}
@@ -0,0 +1,174 @@
+#ifndef CHARACTER_STORE_INC
+#define CHARACTER_STORE_INC
+// Includes
+#include <vector>
+#include "Auxiliaries.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: CharacterStore
+     * ---------------------------------------
+     * A columnar (struct-of-arrays) store of the characters of a game.
+     * Every field of the characters is kept in its own contiguous array, and a
+     * character is identified by its index in those arrays.
+     * The arrays are always dense: removing a character moves the last
+     * character into the freed index, so bulk queries are plain linear scans.
+     */
+    class CharacterStore
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        /* Instance variables */
+        std::vector<CharacterType> types;
+        std::vector<Team> teams;
+        std::vector<units_t> healths;
+        std::vector<units_t> ammos;
+        std::vector<units_t> ranges;
+        std::vector<units_t> powers;
+        std::vector<int> combo_counts;
+        std::vector<int> rows;
+        std::vector<int> cols;
+    public:
+        /* The index used to mark the absence of a character */
+        static const int NO_CHARACTER = -1;
+
+        /*
+         * Struct: Record
+         * ---------------------------------------
+         * Every field of a single character, gathered from the columns.
+         */
+        struct Record
+        {
+            CharacterType type;
+            Team team;
+            units_t health;
+            units_t ammo;
+            units_t range;
+            units_t power;
+            int combo_count;
+            int row;
+            int col;
+        };
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: size
+         * Usage: int count = store.size();
+         * -----------------------------------
+         * Returns the number of characters in the store.
+         */
+        int size() const noexcept
+        {
+            return static_cast<int>(types.size());
+        }
+
+        /*
+         * Method: add
+         * Usage: int id = store.add(type, team, health, ammo, range, power, combo_count, position);
+         * -----------------------------------
+         * Appends a new character to the store and returns its index.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        int add(CharacterType type, Team team, units_t health, units_t ammo,
+                units_t range, units_t power, int combo_count, const GridPoint& position);
+
+        /*
+         * Method: remove
+         * Usage: bool moved = store.remove(id);
+         * -----------------------------------
+         * Removes the character at index id.
+         * The last character of the store is moved into index id to keep the
+         * arrays dense; returns true if such a move took place.
+         */
+        bool remove(int id) noexcept;
+
+        /*
+         * Method: getRecord, setRecord
+         * Usage: CharacterStore::Record record = store.getRecord(id);
+         *        store.setRecord(id, record);
+         * -----------------------------------
+         * Reads / overwrites every field of the character at index id.
+         */
+        Record getRecord(int id) const noexcept;
+        void setRecord(int id, const Record& record) noexcept;
+
+        /*
+         * Method: clear
+         * Usage: store.clear();
+         * -----------------------------------
+         * Removes every character from the store, keeping the allocated capacity.
+         */
+        void clear() noexcept;
+
+        /****************************************/
+        /*        Getter&Setter methods         */
+        /****************************************/
+        CharacterType getType(int id) const noexcept { return types[id]; }
+        Team getTeam(int id) const noexcept { return teams[id]; }
+        units_t getHealth(int id) const noexcept { return healths[id]; }
+        units_t getAmmo(int id) const noexcept { return ammos[id]; }
+        units_t getRange(int id) const noexcept { return ranges[id]; }
+        units_t getPower(int id) const noexcept { return powers[id]; }
+        int getComboCount(int id) const noexcept { return combo_counts[id]; }
+        GridPoint getPosition(int id) const noexcept { return GridPoint(rows[id], cols[id]); }
+
+        void setHealth(int id, units_t health) noexcept { healths[id] = health; }
+        void setAmmo(int id, units_t ammo) noexcept { ammos[id] = ammo; }
+        void setComboCount(int id, int combo_count) noexcept { combo_counts[id] = combo_count; }
+        void setPosition(int id, const GridPoint& position) noexcept
+        {
+            rows[id] = position.row;
+            cols[id] = position.col;
+        }
+
+        /**************************************/
+        /*        Bulk queries section        */
+        /**************************************/
+        /*
+         * Method: count
+         * Usage: int members = store.count(team);
+         * -----------------------------------
+         * Returns the number of characters in team.
+         */
+        int count(Team team) const noexcept;
+
+        /*
+         * Method: totalHealth, totalAmmo
+         * Usage: units_t health = store.totalHealth(team);
+         *        units_t ammo = store.totalAmmo(team);
+         * -----------------------------------
+         * Returns the sum of the health / ammo of every character in team.
+         */
+        units_t totalHealth(Team team) const noexcept;
+        units_t totalAmmo(Team team) const noexcept;
+
+        /*
+         * Method: findBelowHealth
+         * Usage: store.findBelowHealth(threshold, ids);
+         * -----------------------------------
+         * Appends to ids the index of every character whose health is
+         * strictly lower than threshold.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        void findBelowHealth(units_t threshold, std::vector<int>& ids) const;
+
+        /*
+         * Method: applyDamage
+         * Usage: store.applyDamage(ids, damage);
+         * -----------------------------------
+         * Lowers the health of every character in ids by damage.
+         */
+        void applyDamage(const std::vector<int>& ids, units_t damage) noexcept;
+    };
+}
+#endif
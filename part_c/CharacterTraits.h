@@ -0,0 +1,156 @@
+#ifndef CHARACTER_TRAITS_INC
+#define CHARACTER_TRAITS_INC
+// Includes
+#include <cmath>
+#include "Auxiliaries.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Struct: CharacterTraits
+     * ---------------------------------------
+     * The constants that tell the character types apart.
+     * CharacterType is a closed set, so the traits of every type are kept in
+     * the constexpr table CHARACTER_TRAITS, indexed by the type itself.
+     * The character classes take their constants from this table, and the
+     * game engine uses it to apply the rules without any virtual call.
+     */
+    struct CharacterTraits
+    {
+        char cpp_name;
+        char python_name;
+        int max_move_range;
+        units_t reload_amount;
+        units_t ammo_cost;
+        bool has_minimum_range;  /* Can only attack targets that are at least half its range away */
+        units_t splash_divisor;  /* Attacks also hit within range / splash_divisor of the target (0 for none) */
+        units_t splash_damage_divisor;  /* Splash hits deal power / splash_damage_divisor (rounded up) */
+        int combo_length;  /* Every combo_length-th attack is critical (0 for no combos) */
+        units_t critical_multiplier;  /* A critical attack deals power * critical_multiplier */
+    };
+
+    constexpr CharacterTraits CHARACTER_TRAITS[] =
+    {
+        /* SOLDIER */ { 'S', 's', 3, 3, 1, false, 3, 2, 0, 1 },
+        /* MEDIC   */ { 'M', 'm', 5, 5, 1, false, 0, 1, 0, 1 },
+        /* SNIPER  */ { 'N', 'n', 4, 2, 1, true, 0, 1, 3, 2 }
+    };
+
+    /*
+     * Class: CharacterRules
+     * ---------------------------------------
+     * The rules shared by every character type, as functions of
+     * plain values (a type tag and the relevant stats).
+     */
+    class CharacterRules
+    {
+    public:
+        /*
+         * Function: getName
+         * Usage: char name = CharacterRules::getName(type, team);
+         * -----------------------------------
+         * Returns the representation of a character on the game board as a char.
+         */
+        static char getName(CharacterType type, Team team) noexcept
+        {
+            return (team == CPP)? CHARACTER_TRAITS[type].cpp_name : CHARACTER_TRAITS[type].python_name;
+        }
+
+        /*
+         * Function: isLegalMove
+         * Usage: bool legal = CharacterRules::isLegalMove(type, distance);
+         * -----------------------------------
+         * Returns true if and only if a character of type can move distance cells.
+         */
+        static bool isLegalMove(CharacterType type, int distance) noexcept
+        {
+            return distance <= CHARACTER_TRAITS[type].max_move_range;
+        }
+
+        /*
+         * Function: minimumRange
+         * Usage: int minimum = CharacterRules::minimumRange(type, range);
+         * -----------------------------------
+         * Returns the smallest distance a character of type with range can attack.
+         */
+        static int minimumRange(CharacterType type, units_t range) noexcept
+        {
+            return CHARACTER_TRAITS[type].has_minimum_range?
+                static_cast<int>(std::ceil(static_cast<double>(range)/2)) : 0;
+        }
+
+        /*
+         * Function: isInAttackRange
+         * Usage: bool in_range = CharacterRules::isInAttackRange(type, range, src_coords, dst_coords);
+         * -----------------------------------
+         * Returns true if and only if a character of type with range, standing at
+         * src_coords, can attack dst_coords.
+         */
+        static bool isInAttackRange(CharacterType type, units_t range,
+                                    const GridPoint& src_coordinates, const GridPoint& dst_coordinates) noexcept
+        {
+            int distance = GridPoint::distance(src_coordinates, dst_coordinates);
+            return distance <= range && distance >= minimumRange(type, range);
+        }
+
+        /*
+         * Function: splashRadius
+         * Usage: int radius = CharacterRules::splashRadius(type, range);
+         * -----------------------------------
+         * Returns the distance from its target within which the attack of a
+         * character of type with range also deals damage (0 if it only hits the target).
+         */
+        static int splashRadius(CharacterType type, units_t range) noexcept
+        {
+            units_t divisor = CHARACTER_TRAITS[type].splash_divisor;
+            return (divisor == 0)? 0 : static_cast<int>(std::ceil(static_cast<double>(range)/divisor));
+        }
+
+        /*
+         * Function: splashDamage
+         * Usage: units_t damage = CharacterRules::splashDamage(type, power);
+         * -----------------------------------
+         * Returns the damage the attack of a character of type with power deals
+         * to the cells around its target (within splashRadius of it).
+         */
+        static units_t splashDamage(CharacterType type, units_t power) noexcept
+        {
+            return static_cast<units_t>(std::ceil(static_cast<double>(power)/CHARACTER_TRAITS[type].splash_damage_divisor));
+        }
+
+        /*
+         * Function: attackDamage, nextComboCount
+         * Usage: units_t damage = CharacterRules::attackDamage(type, power, combo_count);
+         *        int next_count = CharacterRules::nextComboCount(type, combo_count);
+         * -----------------------------------
+         * attackDamage returns the damage the attack of a character of type
+         * with power deals to its target, when combo_count attacks were
+         * counted towards its combo: the attack that completes a combo is
+         * critical. nextComboCount returns the count after that attack.
+         */
+        static units_t attackDamage(CharacterType type, units_t power, int combo_count) noexcept
+        {
+            const CharacterTraits& traits = CHARACTER_TRAITS[type];
+            return (traits.combo_length > 0 && combo_count == traits.combo_length - 1)?
+                power * traits.critical_multiplier : power;
+        }
+        static int nextComboCount(CharacterType type, int combo_count) noexcept
+        {
+            int length = CHARACTER_TRAITS[type].combo_length;
+            return (length == 0)? 0 : (combo_count + 1) % length;
+        }
+
+        /*
+         * Function: hasEnoughAmmo
+         * Usage: bool can_attack = CharacterRules::hasEnoughAmmo(type, ammo);
+         * -----------------------------------
+         * Returns true if and only if a character of type with ammo can attack.
+         */
+        static bool hasEnoughAmmo(CharacterType type, units_t ammo) noexcept
+        {
+            return ammo >= CHARACTER_TRAITS[type].ammo_cost;
+        }
+    };
+}
+#endif
@@ -0,0 +1,66 @@
+#ifndef COMMAND_INC
+#define COMMAND_INC
+// Includes
+#include "Auxiliaries.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Enum: CommandResult
+     * ---------------------------------------
+     * The outcome of a game command.
+     * Every value other than SUCCESS matches the exception of the same name
+     * from Exceptions.h, which the throwing API raises in that case.
+     */
+    enum CommandResult
+    {
+        SUCCESS,
+        ILLEGAL_ARGUMENT,
+        ILLEGAL_CELL,
+        CELL_EMPTY,
+        MOVE_TOO_FAR,
+        CELL_OCCUPIED,
+        OUT_OF_RANGE,
+        OUT_OF_AMMO,
+        ILLEGAL_TARGET
+    };
+
+    enum CommandType { MOVE, ATTACK, RELOAD };
+
+    /*
+     * Struct: Command
+     * ---------------------------------------
+     * A single move, attack or reload command, as passed to Game::execute.
+     * Reload commands only use src.
+     * A default-constructed command is a placeholder reload of cell (0,0), so
+     * that a buffer of commands (Command buffer[N], std::vector<Command>(n))
+     * can be declared before Game::legalCommands fills it.
+     */
+    struct Command
+    {
+        CommandType type;
+        GridPoint src;
+        GridPoint dst;
+
+        Command() noexcept : type(RELOAD), src(0, 0), dst(0, 0) { }
+        Command(CommandType type, const GridPoint& src, const GridPoint& dst) :
+        type(type), src(src), dst(dst) { }
+
+        static Command move(const GridPoint& src, const GridPoint& dst)
+        {
+            return Command(MOVE, src, dst);
+        }
+
+        static Command attack(const GridPoint& src, const GridPoint& dst)
+        {
+            return Command(ATTACK, src, dst);
+        }
+
+        static Command reload(const GridPoint& coordinates)
+        {
+            return Command(RELOAD, coordinates, coordinates);
+        }
+    };
+}
+#endif
@@ -0,0 +1,294 @@
+#include <algorithm>
+#include "CommandJournal.h"
+#include "Game.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        /* The body is read this many bytes at a time, so a corrupt byte count can not force a huge allocation */
+        const std::size_t READ_CHUNK_SIZE = 64 * 1024;
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    void CommandJournal::clear() noexcept
+    {
+        bytes.clear();
+        record_count = 0;
+    }
+
+    void CommandJournal::write(std::ostream& out) const
+    {
+        unsigned char header[HEADER_SIZE];
+        unsigned int counts[2] = {static_cast<unsigned int>(record_count), static_cast<unsigned int>(bytes.size())};
+        for(int i = 0; i < HEADER_SIZE; i++)
+        {
+            header[i] = static_cast<unsigned char>(counts[i / 4] >> (8 * (i % 4))); //Little endian
+        }
+        out.write(reinterpret_cast<const char*>(header), sizeof(header));
+        if(!bytes.empty())
+        {
+            out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        }
+    }
+
+    CommandJournal CommandJournal::read(std::istream& in)
+    {
+        unsigned char header[HEADER_SIZE];
+        if(!in.read(reinterpret_cast<char*>(header), sizeof(header)))
+        {
+            throw CorruptJournal();
+        }
+        unsigned int counts[2];
+        readHeader(header, counts);
+        CommandJournal journal;
+        journal.record_count = static_cast<int>(counts[0]);
+        // Grow the body only as far as the stream actually goes
+        std::size_t remaining = counts[1];
+        while(remaining > 0)
+        {
+            std::size_t chunk = std::min(remaining, READ_CHUNK_SIZE);
+            std::size_t offset = journal.bytes.size();
+            journal.bytes.resize(offset + chunk);
+            if(!in.read(reinterpret_cast<char*>(journal.bytes.data() + offset), chunk))
+            {
+                throw CorruptJournal();
+            }
+            remaining -= chunk;
+        }
+        return journal;
+    }
+
+    Game CommandJournal::replay() const
+    {
+        return replayRecords(bytes.data(), bytes.data() + bytes.size(), record_count);
+    }
+
+    Game CommandJournal::replay(const unsigned char* data, std::size_t size)
+    {
+        if(size < HEADER_SIZE)
+        {
+            throw CorruptJournal();
+        }
+        unsigned int counts[2];
+        readHeader(data, counts);
+        if(counts[1] != size - HEADER_SIZE)
+        {
+            throw CorruptJournal();
+        }
+        return replayRecords(data + HEADER_SIZE, data + size, static_cast<int>(counts[0]));
+    }
+
+    int CommandJournal::recordCount(const unsigned char* data, std::size_t size)
+    {
+        if(size < HEADER_SIZE)
+        {
+            throw CorruptJournal();
+        }
+        unsigned int counts[2];
+        readHeader(data, counts);
+        return static_cast<int>(counts[0]);
+    }
+
+    /* Private Methods */
+    void CommandJournal::readHeader(const unsigned char* header, unsigned int counts[2]) noexcept
+    {
+        counts[0] = counts[1] = 0;
+        for(int i = 0; i < HEADER_SIZE; i++)
+        {
+            counts[i / 4] |= static_cast<unsigned int>(header[i]) << (8 * (i % 4));
+        }
+    }
+
+    Game CommandJournal::replayRecords(const unsigned char* position, const unsigned char* end, int record_count)
+    {
+        if(record_count <= 0 || end - position < 2 || position[0] != RESET)
+        {
+            throw CorruptJournal();
+        }
+        position += 2;
+        int height = readVarint(position, end);
+        int width = readVarint(position, end);
+        if(height <= 0 || width <= 0)
+        {
+            throw CorruptJournal();
+        }
+        Game game(height, width);
+        std::vector<GridPoint> damaged_cells;
+        std::vector<GridPoint> casualties;
+        for(int record = 1; record < record_count; record++)
+        {
+            if(end - position < 2)
+            {
+                throw CorruptJournal();
+            }
+            RecordKind kind = static_cast<RecordKind>(position[0]);
+            CommandResult recorded = static_cast<CommandResult>(position[1]);
+            CommandResult replayed = SUCCESS;
+            position += 2;
+            switch(kind)
+            {
+                case RESET:
+                {
+                    height = readVarint(position, end);
+                    width = readVarint(position, end);
+                    if(height <= 0 || width <= 0)
+                    {
+                        throw CorruptJournal();
+                    }
+                    game = Game(height, width);
+                    break;
+                }
+
+                case ADD:
+                {
+                    int row = readVarint(position, end);
+                    int col = readVarint(position, end);
+                    int type = readVarint(position, end);
+                    int team = readVarint(position, end);
+                    units_t health = readVarint(position, end);
+                    units_t ammo = readVarint(position, end);
+                    units_t range = readVarint(position, end);
+                    units_t power = readVarint(position, end);
+                    int combo_count = readVarint(position, end);
+                    if(type < SOLDIER || type > SNIPER || team < CPP || team > PYTHON)
+                    {
+                        throw CorruptJournal();
+                    }
+                    replayed = game.applyAdd(GridPoint(row, col), static_cast<CharacterType>(type),
+                        static_cast<Team>(team), health, ammo, range, power, combo_count);
+                    break;
+                }
+
+                case MOVE_RECORD:
+                case ATTACK_RECORD:
+                {
+                    int src_row = readVarint(position, end);
+                    int src_col = readVarint(position, end);
+                    int dst_row = readVarint(position, end);
+                    int dst_col = readVarint(position, end);
+                    GridPoint src_coordinates(src_row, src_col), dst_coordinates(dst_row, dst_col);
+                    if(kind == MOVE_RECORD)
+                    {
+                        replayed = game.applyMove(src_coordinates, dst_coordinates);
+                        break;
+                    }
+                    damaged_cells.clear();
+                    casualties.clear();
+                    replayed = game.applyAttack(src_coordinates, dst_coordinates, damaged_cells);
+                    game.clearDeadCharacters(damaged_cells, casualties);
+                    break;
+                }
+
+                case RELOAD_RECORD:
+                {
+                    int row = readVarint(position, end);
+                    int col = readVarint(position, end);
+                    replayed = game.applyReload(GridPoint(row, col));
+                    break;
+                }
+
+                default:
+                throw CorruptJournal();
+            }
+            if(replayed != recorded)
+            {
+                throw ReplayMismatch(record, recorded, replayed);
+            }
+        }
+        if(position != end)
+        {
+            throw CorruptJournal();
+        }
+        return game;
+    }
+
+    void CommandJournal::writeHeader(RecordKind kind, CommandResult result)
+    {
+        bytes.push_back(static_cast<unsigned char>(kind));
+        bytes.push_back(static_cast<unsigned char>(result));
+        record_count++;
+    }
+
+    void CommandJournal::writeVarint(int value)
+    {
+        // Zigzag encoding maps small negative values to small unsigned ones
+        unsigned int zigzag = (static_cast<unsigned int>(value) << 1) ^ static_cast<unsigned int>(-(value < 0));
+        while(zigzag >= 0x80)
+        {
+            bytes.push_back(static_cast<unsigned char>(zigzag | 0x80));
+            zigzag >>= 7;
+        }
+        bytes.push_back(static_cast<unsigned char>(zigzag));
+    }
+
+    int CommandJournal::readVarint(const unsigned char*& position, const unsigned char* end)
+    {
+        unsigned int zigzag = 0;
+        for(int shift = 0; shift < 35; shift += 7)
+        {
+            if(position == end)
+            {
+                throw CorruptJournal();
+            }
+            unsigned char byte = *position++;
+            zigzag |= static_cast<unsigned int>(byte & 0x7F) << shift;
+            if(!(byte & 0x80))
+            {
+                return static_cast<int>(zigzag >> 1) ^ -static_cast<int>(zigzag & 1);
+            }
+        }
+        throw CorruptJournal();
+    }
+
+    void CommandJournal::recordReset(int height, int width)
+    {
+        writeHeader(RESET, SUCCESS);
+        writeVarint(height);
+        writeVarint(width);
+    }
+
+    void CommandJournal::recordAdd(const GridPoint& coordinates, CharacterType type, Team team, units_t health,
+                                    units_t ammo, units_t range, units_t power, int combo_count, CommandResult result)
+    {
+        writeHeader(ADD, result);
+        writeVarint(coordinates.row);
+        writeVarint(coordinates.col);
+        writeVarint(type);
+        writeVarint(team);
+        writeVarint(health);
+        writeVarint(ammo);
+        writeVarint(range);
+        writeVarint(power);
+        writeVarint(combo_count);
+    }
+
+    void CommandJournal::recordCommand(const Command& command, CommandResult result)
+    {
+        switch(command.type)
+        {
+            case MOVE:
+            writeHeader(MOVE_RECORD, result);
+            break;
+
+            case ATTACK:
+            writeHeader(ATTACK_RECORD, result);
+            break;
+
+            case RELOAD:
+            writeHeader(RELOAD_RECORD, result);
+            writeVarint(command.src.row);
+            writeVarint(command.src.col);
+            return;
+        }
+        writeVarint(command.src.row);
+        writeVarint(command.src.col);
+        writeVarint(command.dst.row);
+        writeVarint(command.dst.col);
+    }
+}
@@ -0,0 +1,196 @@
+#ifndef COMMAND_JOURNAL_INC
+#define COMMAND_JOURNAL_INC
+// Includes
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Auxiliaries.h"
+#include "Exceptions.h"
+#include "Command.h"
+//---------
+
+namespace mtm
+{
+    class Game;
+
+    /*
+     * Class: CommandJournal
+     * ---------------------------------------
+     * An append-only binary log of the commands applied to a Game.
+     * Once attached to a game (see Game::attachJournal), the journal records every
+     * addCharacter, move, attack and reload call together with its outcome,
+     * including the commands that were rejected with an exception.
+     *
+     * Every record starts with a fixed two-byte header (the record kind and the
+     * CommandResult), followed by its operands packed as zigzag varints, so the
+     * common small coordinates take a single byte each.
+     * A journal always starts with a RESET record holding the board dimensions,
+     * followed by one ADD record per character that was on the board when the
+     * journal was attached.
+     */
+    class CommandJournal
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        enum RecordKind { RESET, ADD, MOVE_RECORD, ATTACK_RECORD, RELOAD_RECORD };
+        static const int HEADER_SIZE = 8;   /* The record count and the byte count, written by write() */
+
+        /* Instance variables */
+        std::vector<unsigned char> bytes;
+        int record_count;
+
+        /* Private Methods */
+        void writeHeader(RecordKind kind, CommandResult result);
+        void writeVarint(int value);
+        static int readVarint(const unsigned char*& position, const unsigned char* end);
+        static void readHeader(const unsigned char* header, unsigned int counts[2]) noexcept;
+        static Game replayRecords(const unsigned char* position, const unsigned char* end, int record_count);
+
+        /*
+         * Records written by the game the journal is attached to.
+         */
+        friend class Game;
+        friend class ConcurrentGame;
+        void recordReset(int height, int width);
+        void recordAdd(const GridPoint& coordinates, CharacterType type, Team team, units_t health,
+                        units_t ammo, units_t range, units_t power, int combo_count, CommandResult result);
+        void recordCommand(const Command& command, CommandResult result);
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: CommandJournal
+         * Usage: CommandJournal journal;
+         * ---------------------------------------
+         * Creates an empty journal.
+         */
+        CommandJournal() : record_count(0) { }
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: size
+         * Usage: int records = journal.size();
+         * -----------------------------------
+         * Returns the number of records in the journal.
+         */
+        int size() const noexcept
+        {
+            return record_count;
+        }
+
+        /*
+         * Method: data
+         * Usage: const std::vector<unsigned char>& raw = journal.data();
+         * -----------------------------------
+         * Returns the encoded records.
+         */
+        const std::vector<unsigned char>& data() const noexcept
+        {
+            return bytes;
+        }
+
+        /*
+         * Method: clear
+         * Usage: journal.clear();
+         * -----------------------------------
+         * Removes every record from the journal.
+         */
+        void clear() noexcept;
+
+        /*
+         * Method: write
+         * Usage: journal.write(out);
+         * -----------------------------------
+         * Writes the journal to a binary output stream.
+         */
+        void write(std::ostream& out) const;
+
+        /*
+         * Function: read
+         * Usage: CommandJournal journal = CommandJournal::read(in);
+         * -----------------------------------
+         * Reads a journal that was written with write().
+         *
+         * Possible exceptions:
+         * CommandJournal::CorruptJournal, std::bad_alloc
+         */
+        static CommandJournal read(std::istream& in);
+
+        /*
+         * Method: replay
+         * Usage: Game game = journal.replay();
+         * -----------------------------------
+         * Rebuilds the game the journal was recorded from, by applying its records
+         * to a new game without throwing on rejected commands.
+         * Every command must end with the same outcome it was recorded with.
+         *
+         * Possible exceptions:
+         * CommandJournal::CorruptJournal if the journal can not be decoded.
+         * CommandJournal::ReplayMismatch if a command ends with a different outcome.
+         * std::bad_alloc
+         */
+        Game replay() const;
+
+        /*
+         * Function: replay
+         * Usage: Game game = CommandJournal::replay(data, size);
+         * -----------------------------------
+         * Replays a journal as written by write(), straight from memory (such
+         * as a memory-mapped file), without copying its records.
+         *
+         * Possible exceptions:
+         * The exceptions of replay() above.
+         */
+        static Game replay(const unsigned char* data, std::size_t size);
+
+        /*
+         * Function: recordCount
+         * Usage: int records = CommandJournal::recordCount(data, size);
+         * -----------------------------------
+         * Returns the number of records of a journal as written by write(),
+         * from its header.
+         *
+         * Possible exceptions:
+         * CommandJournal::CorruptJournal if the header is cut short.
+         */
+        static int recordCount(const unsigned char* data, std::size_t size);
+
+        /*********************************/
+        /*       Exception Section       */
+        /*********************************/
+        class CorruptJournal : public Exception
+        {
+        private:
+            const char* description = "Mtm journal error: The journal is corrupt";
+        public:
+            CorruptJournal() = default;
+            virtual ~CorruptJournal() = default;
+            const char* what() const noexcept override
+            {
+                return description;
+            }
+        };
+
+        class ReplayMismatch : public Exception
+        {
+        private:
+            std::string message;
+        public:
+            explicit ReplayMismatch(int record, CommandResult recorded, CommandResult replayed) :
+            message("Mtm journal error: Replay mismatch at record " + std::to_string(record) + ": recorded "
+                    + std::to_string(recorded) + ", replayed " + std::to_string(replayed)) { }
+            virtual ~ReplayMismatch() = default;
+            const char* what() const noexcept override
+            {
+                return message.c_str();
+            }
+        };
+    };
+}
+#endif
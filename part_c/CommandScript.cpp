@@ -0,0 +1,315 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include "CommandScript.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        const char COMMENT = '#';
+
+        /*
+         * A token of the script, pointing into the text of the script
+         */
+        struct Token
+        {
+            const char* begin;
+            const char* end;
+
+            bool is(const char* keyword) const noexcept
+            {
+                const char* character = begin;
+                for(; character != end && *keyword != '\0'; character++, keyword++)
+                {
+                    // Keywords are lowercase letters, so folding the case of ASCII is enough
+                    if((*character | 0x20) != *keyword)
+                    {
+                        return false;
+                    }
+                }
+                return character == end && *keyword == '\0';
+            }
+
+            std::string text() const
+            {
+                return std::string(begin, end);
+            }
+        };
+
+        bool isBlank(char character) noexcept
+        {
+            return character == ' ' || character == '\t' || character == '\r' || character == '\v' || character == '\f';
+        }
+
+        /*
+         * Splits a single line of the script into tokens, up to its comment
+         */
+        class LineTokenizer
+        {
+        private:
+            const char* position;
+            const char* end;
+        public:
+            LineTokenizer(const char* begin, const char* end) : position(begin), end(end) { }
+
+            bool next(Token& token) noexcept
+            {
+                while(position != end && isBlank(*position))
+                {
+                    position++;
+                }
+                if(position == end || *position == COMMENT)
+                {
+                    return false;
+                }
+                token.begin = position;
+                while(position != end && !isBlank(*position) && *position != COMMENT)
+                {
+                    position++;
+                }
+                token.end = position;
+                return true;
+            }
+        };
+
+        /* Reads a decimal int, returning false if token is not one */
+        bool readInt(const Token& token, int& value) noexcept
+        {
+            const char* digit = token.begin;
+            bool negative = (*digit == '-');
+            if(negative || *digit == '+')
+            {
+                digit++;
+            }
+            if(digit == token.end)
+            {
+                return false;
+            }
+            long long magnitude = 0;
+            for(; digit != token.end; digit++)
+            {
+                if(*digit < '0' || *digit > '9')
+                {
+                    return false;
+                }
+                magnitude = magnitude * 10 + (*digit - '0');
+                if(magnitude > static_cast<long long>(INT_MAX) + 1)
+                {
+                    return false;
+                }
+            }
+            magnitude = negative ? -magnitude : magnitude;
+            if(magnitude > INT_MAX)
+            {
+                return false;
+            }
+            value = static_cast<int>(magnitude);
+            return true;
+        }
+
+        /*
+         * Reads the operands of a statement from tokens, reporting errors at line
+         */
+        class OperandReader
+        {
+        private:
+            LineTokenizer& tokens;
+            int line;
+        public:
+            OperandReader(LineTokenizer& tokens, int line) : tokens(tokens), line(line) { }
+
+            Token token()
+            {
+                Token operand;
+                if(!tokens.next(operand))
+                {
+                    throw CommandScript::SyntaxError(line, "Missing operand");
+                }
+                return operand;
+            }
+
+            int number()
+            {
+                Token operand = token();
+                int value = 0;
+                if(!readInt(operand, value))
+                {
+                    throw CommandScript::SyntaxError(line, "Not a number: " + operand.text());
+                }
+                return value;
+            }
+
+            GridPoint point()
+            {
+                int row = number();
+                return GridPoint(row, number());
+            }
+
+            CharacterType type()
+            {
+                Token operand = token();
+                CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+                const char* names[] = {"soldier", "medic", "sniper"};
+                for(int i = 0; i < 3; i++)
+                {
+                    if(operand.is(names[i]))
+                    {
+                        return types[i];
+                    }
+                }
+                throw CommandScript::SyntaxError(line, "Unknown character type: " + operand.text());
+            }
+
+            Team team()
+            {
+                Token operand = token();
+                if(operand.is("cpp"))
+                {
+                    return CPP;
+                }
+                if(operand.is("python"))
+                {
+                    return PYTHON;
+                }
+                throw CommandScript::SyntaxError(line, "Unknown team: " + operand.text());
+            }
+
+            void end()
+            {
+                Token extra;
+                if(tokens.next(extra))
+                {
+                    throw CommandScript::SyntaxError(line, "Unexpected operand: " + extra.text());
+                }
+            }
+        };
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    CommandScript CommandScript::parse(const char* text, std::size_t length)
+    {
+        CommandScript script;
+        const char* position = text;
+        const char* end = text + length;
+        int line = 0;
+        script.steps.reserve(static_cast<std::size_t>(std::count(text, end, '\n')) + 1);
+        while(position != end)
+        {
+            line++;
+            const char* line_end = static_cast<const char*>(std::memchr(position, '\n', end - position));
+            if(line_end == nullptr)
+            {
+                line_end = end;
+            }
+            LineTokenizer tokens(position, line_end);
+            position = (line_end == end)? end : line_end + 1;
+            Token keyword;
+            if(!tokens.next(keyword))
+            {
+                continue; // A blank or comment line
+            }
+            OperandReader operands(tokens, line);
+            if(keyword.is("board"))
+            {
+                Step step(BOARD);
+                step.height = operands.number();
+                step.width = operands.number();
+                if(step.height <= 0 || step.width <= 0)
+                {
+                    throw SyntaxError(line, "Illegal board dimensions");
+                }
+                script.steps.push_back(step);
+            }
+            else if(script.steps.empty())
+            {
+                throw SyntaxError(line, "The script must start with a board");
+            }
+            else if(keyword.is("add"))
+            {
+                Step step(ADD);
+                step.command.src = operands.point();
+                step.type = operands.type();
+                step.team = operands.team();
+                step.health = operands.number();
+                step.ammo = operands.number();
+                step.range = operands.number();
+                step.power = operands.number();
+                script.steps.push_back(step);
+            }
+            else if(keyword.is("move") || keyword.is("attack"))
+            {
+                Step step(COMMAND);
+                GridPoint src = operands.point();
+                GridPoint dst = operands.point();
+                step.command = keyword.is("move")? Command::move(src, dst) : Command::attack(src, dst);
+                script.steps.push_back(step);
+            }
+            else if(keyword.is("reload"))
+            {
+                Step step(COMMAND);
+                step.command = Command::reload(operands.point());
+                script.steps.push_back(step);
+            }
+            else
+            {
+                throw SyntaxError(line, "Unknown statement: " + keyword.text());
+            }
+            operands.end();
+        }
+        if(script.steps.empty())
+        {
+            throw SyntaxError(line, "The script has no board");
+        }
+        return script;
+    }
+
+    Game CommandScript::run(Statistics& statistics, CommandJournal* journal) const
+    {
+        Game game(steps.front().height, steps.front().width);
+        game.attachJournal(journal);
+        for(std::size_t i = 1; i < steps.size(); i++)
+        {
+            const Step& step = steps[i];
+            CommandResult result = SUCCESS;
+            switch(step.kind)
+            {
+                case BOARD:
+                game = Game(step.height, step.width);
+                continue;
+
+                case ADD:
+                result = game.tryAddCharacter(step.command.src, step.type, step.team,
+                                                step.health, step.ammo, step.range, step.power);
+                statistics.additions++;
+                break;
+
+                case COMMAND:
+                switch(step.command.type)
+                {
+                    case MOVE:
+                    result = game.tryMove(step.command.src, step.command.dst);
+                    break;
+
+                    case ATTACK:
+                    result = game.tryAttack(step.command.src, step.command.dst);
+                    break;
+
+                    case RELOAD:
+                    result = game.tryReload(step.command.src);
+                    break;
+                }
+                statistics.commands++;
+                break;
+            }
+            statistics.outcomes[result]++;
+        }
+        game.attachJournal(nullptr);
+        return game;
+    }
+}
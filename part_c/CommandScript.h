@@ -0,0 +1,145 @@
+#ifndef COMMAND_SCRIPT_INC
+#define COMMAND_SCRIPT_INC
+// Includes
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Auxiliaries.h"
+#include "Exceptions.h"
+#include "Command.h"
+#include "CommandJournal.h"
+#include "Game.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: CommandScript
+     * ---------------------------------------
+     * A parsed text script of game commands, one statement per line:
+     *
+     *     board  <height> <width>
+     *     add    <row> <col> <soldier|medic|sniper> <cpp|python> <health> <ammo> <range> <power>
+     *     move   <src row> <src col> <dst row> <dst col>
+     *     attack <src row> <src col> <dst row> <dst col>
+     *     reload <row> <col>
+     *
+     * Keywords are case-insensitive, tokens are separated by blanks, and
+     * everything from a '#' to the end of its line is a comment.
+     * The first statement must be a board, and a later board starts a new
+     * game. An add makes the character as Game::makeCharacter would, and adds
+     * it as Game::addCharacter would.
+     * The script is parsed in place: the tokens point into the given text,
+     * so parsing allocates nothing but the parsed steps.
+     */
+    class CommandScript
+    {
+    public:
+        enum StepKind { BOARD, ADD, COMMAND };
+
+        /*
+         * Struct: Step
+         * ---------------------------------------
+         * A single statement. command holds the coordinates of an add, and
+         * the stats are only used by adds.
+         */
+        struct Step
+        {
+            StepKind kind;
+            Command command;
+            int height;
+            int width;
+            CharacterType type;
+            Team team;
+            units_t health;
+            units_t ammo;
+            units_t range;
+            units_t power;
+
+            explicit Step(StepKind kind) : kind(kind), command(),
+            height(0), width(0), type(SOLDIER), team(CPP), health(0), ammo(0), range(0), power(0) { }
+        };
+
+        /*
+         * Struct: Statistics
+         * ---------------------------------------
+         * What running a script did: the number of adds and of commands, and
+         * how many of both ended with each CommandResult.
+         */
+        struct Statistics
+        {
+            long long additions;
+            long long commands;
+            long long outcomes[ILLEGAL_TARGET + 1];
+
+            Statistics() : additions(0), commands(0), outcomes() { }
+        };
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        /* Instance variables */
+        std::vector<Step> steps;
+    public:
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Function: parse
+         * Usage: CommandScript script = CommandScript::parse(text, length);
+         * -----------------------------------
+         * Parses the script in the length characters at text.
+         *
+         * Possible exceptions:
+         * CommandScript::SyntaxError, std::bad_alloc
+         */
+        static CommandScript parse(const char* text, std::size_t length);
+
+        /*
+         * Method: run
+         * Usage: Game game = script.run(statistics);
+         *        Game game = script.run(statistics, &journal);
+         * -----------------------------------
+         * Runs the script without throwing on rejected commands, adds the
+         * outcomes to statistics, and returns the final game.
+         * The journal, if given, records the run (see Game::attachJournal).
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        Game run(Statistics& statistics, CommandJournal* journal = nullptr) const;
+
+        /*
+         * Method: size, operator[]
+         * Usage: for(size_t i = 0; i < script.size(); i++) { const CommandScript::Step& step = script[i]; }
+         * -----------------------------------
+         * Return the number of statements, and the given one.
+         */
+        std::size_t size() const noexcept
+        {
+            return steps.size();
+        }
+        const Step& operator[](std::size_t index) const noexcept
+        {
+            return steps[index];
+        }
+
+        /*********************************/
+        /*       Exception Section       */
+        /*********************************/
+        class SyntaxError : public Exception
+        {
+        private:
+            std::string message;
+        public:
+            SyntaxError(int line, const std::string& problem) :
+            message("Mtm script error: Line " + std::to_string(line) + ": " + problem) { }
+            virtual ~SyntaxError() = default;
+            const char* what() const noexcept override
+            {
+                return message.c_str();
+            }
+        };
+    };
+}
+#endif
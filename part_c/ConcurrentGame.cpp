@@ -0,0 +1,301 @@
+#include <algorithm>
+#include <functional>
+#include "ConcurrentGame.h"
+#include "Instrumentation.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        /* Per-thread buffers of the commands, reused to spare allocations */
+        thread_local std::vector<int> held_regions;
+        thread_local std::vector<int> needed_regions;
+        thread_local std::vector<GridPoint> damaged;
+        thread_local std::vector<GridPoint> dead;
+    }
+
+    /***************************************/
+    /*     Ctors implementation section    */
+    /***************************************/
+    ConcurrentGame::ConcurrentGame(const Game& game) : game(game),
+    region_size(game.board.isSparse()? std::max(game.height(), game.width()) : REGION_SIZE),
+    region_cols((game.width() + region_size - 1) / region_size),
+    region_count(((game.height() + region_size - 1) / region_size) * region_cols),
+    region_locks(new std::mutex[region_count]), journal_lock(), graveyard_lock(), graveyard()
+    {
+        this->game.hash_deferred = true;
+    }
+
+    ConcurrentGame::RegionLock::RegionLock(ConcurrentGame& owner, std::vector<int>& regions) :
+    owner(owner), regions(regions), locked(false)
+    {
+        lock();
+    }
+
+    ConcurrentGame::RegionLock::~RegionLock()
+    {
+        unlock();
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    void ConcurrentGame::RegionLock::lock()
+    {
+        for(int region : regions)
+        {
+            owner.region_locks[region].lock();
+        }
+        locked = true;
+    }
+
+    void ConcurrentGame::RegionLock::unlock() noexcept
+    {
+        if(!locked)
+        {
+            return;
+        }
+        for(auto region = regions.rbegin(); region != regions.rend(); ++region)
+        {
+            owner.region_locks[*region].unlock();
+        }
+        locked = false;
+    }
+
+    CommandResult ConcurrentGame::tryMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates)
+    {
+        Instrumentation::Timer timer(MOVE_CALL);
+        Instrumentation::count(MOVE_COMMANDS);
+        Command command = Command::move(src_coordinates, dst_coordinates);
+        if(!game.isInBounds(src_coordinates) || !game.isInBounds(dst_coordinates))
+        {
+            record(command, ILLEGAL_CELL);
+            return ILLEGAL_CELL;
+        }
+        held_regions.clear();
+        held_regions.push_back(regionOf(src_coordinates));
+        held_regions.push_back(regionOf(dst_coordinates));
+        std::sort(held_regions.begin(), held_regions.end());
+        held_regions.erase(std::unique(held_regions.begin(), held_regions.end()), held_regions.end());
+        RegionLock lock(*this, held_regions);
+        CommandResult result = game.applyMove(src_coordinates, dst_coordinates);
+        record(command, result);
+        return result;
+    }
+
+    CommandResult ConcurrentGame::tryAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                            std::vector<GridPoint>* casualties)
+    {
+        Instrumentation::Timer timer(ATTACK_CALL);
+        Instrumentation::count(ATTACK_COMMANDS);
+        Command command = Command::attack(src_coordinates, dst_coordinates);
+        std::vector<GridPoint>& killed = (casualties != nullptr)? *casualties : dead;
+        killed.clear();
+        if(!game.isInBounds(src_coordinates) || !game.isInBounds(dst_coordinates))
+        {
+            record(command, ILLEGAL_CELL);
+            return ILLEGAL_CELL;
+        }
+        // The regions depend on the attacker, which can only be read under the lock of its region
+        held_regions.assign(1, regionOf(src_coordinates));
+        RegionLock lock(*this, held_regions);
+        while(true)
+        {
+            attackRegions(game.board(src_coordinates.row, src_coordinates.col), src_coordinates, dst_coordinates,
+                            needed_regions);
+            if(std::includes(held_regions.begin(), held_regions.end(), needed_regions.begin(), needed_regions.end()))
+            {
+                break;
+            }
+            // Another command may change the attacker in between, so check again once locked
+            lock.unlock();
+            held_regions.swap(needed_regions);
+            lock.lock();
+        }
+        damaged.clear();
+        CommandResult result = game.applyAttack(src_coordinates, dst_coordinates, damaged);
+        if(result == SUCCESS)
+        {
+            buryDead(damaged, killed);
+        }
+        record(command, result);
+        return result;
+    }
+
+    CommandResult ConcurrentGame::tryReload(const GridPoint& coordinates)
+    {
+        Instrumentation::Timer timer(RELOAD_CALL);
+        Instrumentation::count(RELOAD_COMMANDS);
+        Command command = Command::reload(coordinates);
+        if(!game.isInBounds(coordinates))
+        {
+            record(command, ILLEGAL_CELL);
+            return ILLEGAL_CELL;
+        }
+        held_regions.assign(1, regionOf(coordinates));
+        RegionLock lock(*this, held_regions);
+        CommandResult result = game.applyReload(coordinates);
+        record(command, result);
+        return result;
+    }
+
+    CommandResult ConcurrentGame::tryAddCharacter(const GridPoint& coordinates, CharacterType type, Team team,
+                                                    units_t health, units_t ammo, units_t range, units_t power)
+    {
+        Instrumentation::Timer timer(ADD_CHARACTER_CALL);
+        Instrumentation::count(ADD_COMMANDS);
+        lockAll();
+        CommandResult result;
+        try
+        {
+            settle(); // Character indices must be dense before the store grows
+            result = game.tryAddCharacter(coordinates, type, team, health, ammo, range, power);
+        }
+        catch(...)
+        {
+            unlockAll();
+            throw;
+        }
+        unlockAll();
+        return result;
+    }
+
+    void ConcurrentGame::attachJournal(CommandJournal* journal)
+    {
+        lockAll();
+        try
+        {
+            settle();
+            game.attachJournal(journal);
+        }
+        catch(...)
+        {
+            unlockAll();
+            throw;
+        }
+        unlockAll();
+    }
+
+    void ConcurrentGame::attachListener(GameEventListener* listener)
+    {
+        lockAll();
+        game.attachListener(listener);
+        unlockAll();
+    }
+
+    Game ConcurrentGame::snapshot()
+    {
+        lockAll();
+        try
+        {
+            settle();
+            Game copy(game);
+            unlockAll();
+            return copy;
+        }
+        catch(...)
+        {
+            unlockAll();
+            throw;
+        }
+    }
+
+    std::uint64_t ConcurrentGame::hash()
+    {
+        lockAll();
+        settle();
+        std::uint64_t result = game.position_hash;
+        unlockAll();
+        return result;
+    }
+
+    /* Private Methods */
+    void ConcurrentGame::attackRegions(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                        std::vector<int>& regions) const
+    {
+        regions.assign(1, regionOf(src_coordinates));
+        if(id == CharacterStore::NO_CHARACTER)
+        {
+            return;
+        }
+        int radius = std::min(CharacterRules::splashRadius(game.characters.getType(id), game.characters.getRange(id)),
+                                game.height() + game.width());
+        int first_row = std::max(0, dst_coordinates.row - radius) / region_size;
+        int last_row = std::min(game.height() - 1, dst_coordinates.row + radius) / region_size;
+        int first_col = std::max(0, dst_coordinates.col - radius) / region_size;
+        int last_col = std::min(game.width() - 1, dst_coordinates.col + radius) / region_size;
+        for(int row = first_row; row <= last_row; row++)
+        {
+            for(int col = first_col; col <= last_col; col++)
+            {
+                regions.push_back(row * region_cols + col);
+            }
+        }
+        std::sort(regions.begin(), regions.end());
+        regions.erase(std::unique(regions.begin(), regions.end()), regions.end());
+    }
+
+    void ConcurrentGame::buryDead(const std::vector<GridPoint>& damaged_cells, std::vector<GridPoint>& casualties)
+    {
+        for(const GridPoint& coordinates : damaged_cells)
+        {
+            int id = game.board(coordinates.row, coordinates.col);
+            if(id != CharacterStore::NO_CHARACTER && game.characters.getHealth(id) <= 0)
+            {
+                if(game.events.active())
+                {
+                    game.events.emit(DeathEvent{coordinates, game.characters.getType(id), game.characters.getTeam(id)});
+                }
+                {
+                    std::lock_guard<std::mutex> guard(graveyard_lock);
+                    graveyard.push_back(id);
+                }
+                game.detachCharacter(coordinates);
+                casualties.push_back(coordinates);
+            }
+        }
+    }
+
+    void ConcurrentGame::record(const Command& command, CommandResult result)
+    {
+        std::lock_guard<std::mutex> guard(journal_lock);
+        if(game.journal != nullptr)
+        {
+            game.journal->recordCommand(command, result);
+        }
+    }
+
+    void ConcurrentGame::lockAll()
+    {
+        for(int region = 0; region < region_count; region++)
+        {
+            region_locks[region].lock();
+        }
+        // Commands out of the board hold no region, only journal_lock
+        journal_lock.lock();
+    }
+
+    void ConcurrentGame::unlockAll() noexcept
+    {
+        journal_lock.unlock();
+        for(int region = region_count - 1; region >= 0; region--)
+        {
+            region_locks[region].unlock();
+        }
+    }
+
+    void ConcurrentGame::settle() noexcept
+    {
+        // From the highest index down, so the character moved into a freed index is never a dead one
+        std::sort(graveyard.begin(), graveyard.end(), std::greater<int>());
+        for(int id : graveyard)
+        {
+            game.eraseCharacter(id);
+        }
+        graveyard.clear();
+        game.position_hash = game.computeHash();
+    }
+}
@@ -0,0 +1,203 @@
+#ifndef CONCURRENT_GAME_INC
+#define CONCURRENT_GAME_INC
+// Includes
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Auxiliaries.h"
+#include "Command.h"
+#include "CommandJournal.h"
+#include "Game.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: ConcurrentGame
+     * ---------------------------------------
+     * A game that any number of threads may send commands to at once.
+     * The board is split into REGION_SIZE x REGION_SIZE regions, each with a
+     * lock of its own. A command locks the regions it reads or writes (the
+     * source and destination of a move, the attacker and the area its attack
+     * may hit) in increasing order, so commands on distant parts of the board
+     * run in parallel, and commands on overlapping parts can not deadlock.
+     * Regions are as wide as the words of the occupancy bitboards, so no two
+     * regions share a word.
+     *
+     * A character that dies is taken off the board right away, but stays in
+     * the character store until the game next settles, since removing it moves
+     * another character, which may be in a region the command does not hold.
+     * The hash of the position is not kept during commands either, and is
+     * recomputed on settling. The game settles on every operation that locks
+     * the whole board: addCharacter, attachJournal, snapshot and hash.
+     *
+     * A sparse board is a single region: its tiles are shared by the whole board.
+     */
+    class ConcurrentGame
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        static const int REGION_SIZE = 64;
+
+        /* Instance variables */
+        Game game;
+        int region_size;
+        int region_cols;
+        int region_count;
+        std::unique_ptr<std::mutex[]> region_locks;
+        std::mutex journal_lock;            /* Guards the attached journal, and orders its records */
+        std::mutex graveyard_lock;
+        std::vector<int> graveyard;         /* The store indices of the characters that died since settling */
+
+        /*
+         * Holds the locks of a sorted set of regions, and releases them when
+         * it goes out of scope.
+         */
+        class RegionLock
+        {
+        private:
+            ConcurrentGame& owner;
+            std::vector<int>& regions;
+            bool locked;
+        public:
+            RegionLock(ConcurrentGame& owner, std::vector<int>& regions);
+            ~RegionLock();
+            RegionLock(const RegionLock&) = delete;
+            RegionLock& operator=(const RegionLock&) = delete;
+            void lock();
+            void unlock() noexcept;
+        };
+
+        /* Private Methods */
+        int regionOf(const GridPoint& coordinates) const noexcept
+        {
+            return (coordinates.row / region_size) * region_cols + coordinates.col / region_size;
+        }
+
+        /*
+         * Sets regions to the sorted regions an attack from src_coordinates to
+         * dst_coordinates by the character at index id (or by nobody) may touch.
+         */
+        void attackRegions(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                            std::vector<int>& regions) const;
+
+        /*
+         * Takes the dead characters among damaged_cells off the board, and
+         * appends their coordinates to casualties (see Game::clearDeadCharacters).
+         * ASSUMES: the regions of damaged_cells are locked.
+         */
+        void buryDead(const std::vector<GridPoint>& damaged_cells, std::vector<GridPoint>& casualties);
+
+        /*
+         * Records command to the attached journal, if any, under journal_lock.
+         * ASSUMES: the regions of the command are locked (none for a command
+         * out of the board), so the journal records the commands in an order a
+         * serial replay agrees with.
+         */
+        void record(const Command& command, CommandResult result);
+
+        /*
+         * Lock (unlock) every region, in order, and then journal_lock, so
+         * that the game can write to its journal or replace it.
+         */
+        void lockAll();
+        void unlockAll() noexcept;
+
+        /*
+         * Removes the dead characters from the store, and recomputes the hash.
+         * ASSUMES: every region is locked.
+         */
+        void settle() noexcept;
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: ConcurrentGame
+         * Usage: ConcurrentGame shared(game);
+         * ---------------------------------------
+         * Creates a concurrent game that starts as a copy of game.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        explicit ConcurrentGame(const Game& game);
+        ~ConcurrentGame() = default;
+        ConcurrentGame(const ConcurrentGame&) = delete;
+        ConcurrentGame& operator=(const ConcurrentGame&) = delete;
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: tryMove, tryAttack, tryReload
+         * Usage: CommandResult result = shared.tryMove(src_coordinates, dst_coordinates);
+         *        CommandResult result = shared.tryAttack(src_coordinates, dst_coordinates, &casualties);
+         * -----------------------------------
+         * Game::tryMove, Game::tryAttack and Game::tryReload, safe to call from
+         * several threads at once.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        CommandResult tryMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
+        CommandResult tryAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                std::vector<GridPoint>* casualties = nullptr);
+        CommandResult tryReload(const GridPoint& coordinates);
+
+        /*
+         * Method: tryAddCharacter
+         * Usage: CommandResult result = shared.tryAddCharacter(coordinates, type, team, health, ammo, range, power);
+         * -----------------------------------
+         * Game::tryAddCharacter. Locks the whole board.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        CommandResult tryAddCharacter(const GridPoint& coordinates, CharacterType type, Team team,
+                                        units_t health, units_t ammo, units_t range, units_t power);
+
+        /*
+         * Method: attachJournal
+         * Usage: shared.attachJournal(&journal);
+         * -----------------------------------
+         * Game::attachJournal. The journal records the commands of all the
+         * threads in one order, in which replaying them serially ends in the
+         * same position with the same outcomes. Locks the whole board.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        void attachJournal(CommandJournal* journal);
+
+        /*
+         * Method: attachListener
+         * Usage: shared.attachListener(&listener);
+         * -----------------------------------
+         * Game::attachListener. The listener is called from every thread that
+         * sends commands, at once, so it must be safe to call concurrently.
+         * The events of a command are emitted while it holds its regions, so
+         * the events of each cell come in the order of its changes.
+         * Locks the whole board.
+         */
+        void attachListener(GameEventListener* listener);
+
+        /*
+         * Method: snapshot, hash
+         * Usage: Game game = shared.snapshot();
+         *        std::uint64_t key = shared.hash();
+         * -----------------------------------
+         * Return a copy of the game (its hash), as of a moment between commands.
+         * Lock the whole board.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (snapshot only)
+         */
+        Game snapshot();
+        std::uint64_t hash();
+    };
+}
+#endif
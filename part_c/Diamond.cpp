@@ -0,0 +1,38 @@
+#include "Diamond.h"
+
+namespace mtm
+{
+    static std::vector<GridPoint> buildOffsetTable(int radius)
+    {
+        std::vector<GridPoint> table;
+        table.reserve(ManhattanDiamond::ringBegin(radius + 1));
+        table.push_back(GridPoint(0, 0));
+        for(int distance = 1; distance <= radius; distance++)
+        {
+            // Walk the ring clockwise, starting from its top corner
+            for(int step = 0; step < distance; step++)
+            {
+                table.push_back(GridPoint(-distance + step, step));
+            }
+            for(int step = 0; step < distance; step++)
+            {
+                table.push_back(GridPoint(step, distance - step));
+            }
+            for(int step = 0; step < distance; step++)
+            {
+                table.push_back(GridPoint(distance - step, -step));
+            }
+            for(int step = 0; step < distance; step++)
+            {
+                table.push_back(GridPoint(-step, -distance + step));
+            }
+        }
+        return table;
+    }
+
+    const std::vector<GridPoint>& ManhattanDiamond::offsets()
+    {
+        static const std::vector<GridPoint> table = buildOffsetTable(MAX_TABLE_RADIUS);
+        return table;
+    }
+}
@@ -0,0 +1,129 @@
+#ifndef DIAMOND_INC
+#define DIAMOND_INC
+// Includes
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include "Auxiliaries.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: ManhattanDiamond
+     * ---------------------------------------
+     * Enumerates the cells around a center whose Manhattan distance
+     * from it is at most a given radius (a "diamond"), or within a range of
+     * distances (a ring), clipped to the board.
+     * Small radii are served from a precomputed offset table, ordered ring by ring
+     * (distance 0, then 1, then 2...), so the cells at distance d occupy the
+     * index range [ringBegin(d), ringBegin(d + 1)) of the table.
+     * Larger radii fall back to walking the clipped rows of the diamond.
+     * Either way, the cost is bounded by the number of cells inside the diamond
+     * and never by the size of the board.
+     */
+    class ManhattanDiamond
+    {
+    public:
+        /* The largest radius that is served from the offset table */
+        static const int MAX_TABLE_RADIUS = 64;
+
+        /*
+         * Function: offsets
+         * Usage: const std::vector<GridPoint>& table = ManhattanDiamond::offsets();
+         * -----------------------------------
+         * Returns the offset table of the diamond with radius MAX_TABLE_RADIUS,
+         * ordered by distance from the center.
+         * The table is built once, on first use.
+         */
+        static const std::vector<GridPoint>& offsets();
+
+        /*
+         * Function: ringBegin
+         * Usage: int first = ManhattanDiamond::ringBegin(distance);
+         * -----------------------------------
+         * Returns the number of cells that are strictly closer than distance
+         * to the center, which is also the index of the first offset
+         * at that distance in the offset table.
+         */
+        static int ringBegin(int distance) noexcept
+        {
+            return (distance <= 0)? 0 : 2 * distance * (distance - 1) + 1;
+        }
+
+        /*
+         * Function: forEach
+         * Usage: ManhattanDiamond::forEach(center, radius, height, width, visit);
+         * -----------------------------------
+         * Calls visit(cell, distance) for every cell of a height x width board
+         * whose distance from center is at most radius.
+         *
+         * Assumptions on VISITOR:
+         * • Callable as visit(const GridPoint&, int).
+         */
+        template<typename VISITOR>
+        static void forEach(const GridPoint& center, int radius, int height, int width, VISITOR visit)
+        {
+            forEachInRing(center, 0, radius, height, width, visit);
+        }
+
+        /*
+         * Function: forEachInRing
+         * Usage: ManhattanDiamond::forEachInRing(center, inner, outer, height, width, visit);
+         * -----------------------------------
+         * Calls visit(cell, distance) for every cell of a height x width board
+         * whose distance from center is at least inner and at most outer.
+         * The cells closer than inner are skipped rather than visited and filtered.
+         *
+         * Assumptions on VISITOR:
+         * • Callable as visit(const GridPoint&, int).
+         */
+        template<typename VISITOR>
+        static void forEachInRing(const GridPoint& center, int inner, int outer, int height, int width,
+                                    VISITOR visit)
+        {
+            inner = std::max(inner, 0);
+            if(outer < inner)
+            {
+                return;
+            }
+            if(outer <= MAX_TABLE_RADIUS)
+            {
+                const std::vector<GridPoint>& table = offsets();
+                for(int distance = inner, i = ringBegin(inner); distance <= outer; distance++)
+                {
+                    for(int end = ringBegin(distance + 1); i < end; i++)
+                    {
+                        int row = center.row + table[i].row, col = center.col + table[i].col;
+                        if(row >= 0 && col >= 0 && row < height && col < width)
+                        {
+                            visit(GridPoint(row, col), distance);
+                        }
+                    }
+                }
+                return;
+            }
+            int first_row = std::max(0, center.row - outer);
+            int last_row = std::min(height - 1, center.row + outer);
+            for(int row = first_row; row <= last_row; row++)
+            {
+                int row_distance = std::abs(row - center.row);
+                int outer_half_width = outer - row_distance;
+                int inner_half_width = inner - row_distance; // The columns strictly inside it are skipped
+                int first_col = std::max(0, center.col - outer_half_width);
+                int last_col = std::min(width - 1, center.col + outer_half_width);
+                for(int col = first_col; col <= last_col; col++)
+                {
+                    int col_distance = std::abs(col - center.col);
+                    if(col_distance < inner_half_width)
+                    {
+                        col = center.col + inner_half_width - 1; // Jump over the hole
+                        continue;
+                    }
+                    visit(GridPoint(row, col), row_distance + col_distance);
+                }
+            }
+        }
+    };
+}
+#endif
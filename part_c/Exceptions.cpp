@@ -1,5 +1,6 @@
 #include <iostream>
 #include "Exceptions.h"
+#include "Instrumentation.h"
 
 namespace mtm
 {
@@ -15,7 +16,10 @@ namespace mtm
     /*        IllegalArgument        */
     /*********************************/
     IllegalArgument::IllegalArgument() :
-    GameException("IllegalArgument"), message(game_error += exception_name) { }
+    GameException("IllegalArgument"), message(game_error += exception_name)
+    {
+        Instrumentation::count(ILLEGAL_ARGUMENT_EXCEPTIONS);
+    }
     const char* IllegalArgument::what() const noexcept
     {
         return message.c_str();
@@ -25,7 +29,10 @@ namespace mtm
     /*          IllegalCell          */
     /*********************************/
     IllegalCell::IllegalCell() :
-    GameException("IllegalCell"), message(game_error += exception_name) { }
+    GameException("IllegalCell"), message(game_error += exception_name)
+    {
+        Instrumentation::count(ILLEGAL_CELL_EXCEPTIONS);
+    }
     const char* IllegalCell::what() const noexcept 
     {
        return message.c_str();
@@ -35,7 +42,10 @@ namespace mtm
     /*           CellEmpty           */
     /*********************************/
     CellEmpty::CellEmpty() :
-    GameException("CellEmpty"), message(game_error += exception_name) { }
+    GameException("CellEmpty"), message(game_error += exception_name)
+    {
+        Instrumentation::count(CELL_EMPTY_EXCEPTIONS);
+    }
     const char* CellEmpty::what() const noexcept 
     {
         return message.c_str();
@@ -45,7 +55,10 @@ namespace mtm
     /*           MoveTooFar          */
     /*********************************/
     MoveTooFar::MoveTooFar() :
-    GameException("MoveTooFar"), message(game_error += exception_name) { }
+    GameException("MoveTooFar"), message(game_error += exception_name)
+    {
+        Instrumentation::count(MOVE_TOO_FAR_EXCEPTIONS);
+    }
     const char* MoveTooFar::what() const noexcept
     {
         return message.c_str();
@@ -55,7 +68,10 @@ namespace mtm
     /*         CellOccupied          */
     /*********************************/
     CellOccupied::CellOccupied() :
-    GameException("CellOccupied"), message(game_error += exception_name) { }
+    GameException("CellOccupied"), message(game_error += exception_name)
+    {
+        Instrumentation::count(CELL_OCCUPIED_EXCEPTIONS);
+    }
     const char* CellOccupied::what() const noexcept
     {
         return message.c_str();
@@ -65,7 +81,10 @@ namespace mtm
     /*           OutOfRange          */
     /*********************************/
     OutOfRange::OutOfRange() :
-    GameException("OutOfRange"), message(game_error += exception_name) { }
+    GameException("OutOfRange"), message(game_error += exception_name)
+    {
+        Instrumentation::count(OUT_OF_RANGE_EXCEPTIONS);
+    }
     const char* OutOfRange::what() const noexcept 
     {
         return message.c_str();
@@ -75,7 +94,10 @@ namespace mtm
     /*           OutOfAmmo           */
     /*********************************/
     OutOfAmmo::OutOfAmmo() :
-    GameException("OutOfAmmo"), message(game_error += exception_name) { }
+    GameException("OutOfAmmo"), message(game_error += exception_name)
+    {
+        Instrumentation::count(OUT_OF_AMMO_EXCEPTIONS);
+    }
     const char* OutOfAmmo::what() const noexcept
     {
         return message.c_str();
@@ -85,7 +107,10 @@ namespace mtm
     /*         IllegalTarget         */
     /*********************************/
     IllegalTarget::IllegalTarget() :
-    GameException("IllegalTarget"), message(game_error += exception_name) { }
+    GameException("IllegalTarget"), message(game_error += exception_name)
+    {
+        Instrumentation::count(ILLEGAL_TARGET_EXCEPTIONS);
+    }
     const char* IllegalTarget::what() const noexcept
     {
         return message.c_str();
@@ -1,28 +1,41 @@
 #include "Game.h"
+#include "Diamond.h"
+#include "Instrumentation.h"
+#include "PoolAllocator.h"
 #include <vector>
 
 namespace mtm
 {
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        /*
+         * Buffers of soldierAttack, reused to spare allocations. Per thread,
+         * as a ConcurrentGame runs attacks on a single game from many threads.
+         */
+        thread_local std::vector<int> center_hits;
+        thread_local std::vector<int> splash_hits;
+    }
+
     /***************************************/
     /*     Ctors implementation section    */
     /***************************************/
     Game::Game(int height, int width) :
     board((height <=0 || width <= 0)?
-        throw IllegalArgument() : Matrix<std::shared_ptr<Character>>(Dimensions(height, width), nullptr))
+        throw IllegalArgument() : GameBoard(height, width, static_cast<long long>(height) * width > SPARSE_BOARD_CELLS)),
+    occupancy(height, width, board.isSparse()), journal(nullptr), renderer(nullptr), events(),
+    undo_log(), position_hash(0), hash_deferred(false)
     {
-        
+
     }
-    
+
     Game::Game(const Game& other) :
-    board(other.board)
+    board(other.board), characters(other.characters), occupancy(other.occupancy), journal(nullptr),
+    renderer(nullptr), events(), undo_log(), position_hash(other.position_hash), hash_deferred(false)
     {
-        for(std::shared_ptr<Character>& character_ptr : board)
-        {
-            if(character_ptr != nullptr)
-            {
-                character_ptr = character_ptr->clone();
-            }
-        }
+
     }
 
     /****************************************/
@@ -30,93 +43,290 @@ namespace mtm
     /****************************************/
     void Game::addCharacter(const GridPoint& coordinates, std::shared_ptr<Character> character)
     {
-        if ((coordinates.row < 0) || (coordinates.col < 0) 
-            || (coordinates.row >= board.height()) || (coordinates.col >= board.width()))
+        throwOnFailure(tryAddCharacter(coordinates, character));
+    }
+
+    void Game::move(const GridPoint & src_coordinates, const GridPoint & dst_coordinates)
+    {
+        throwOnFailure(tryMove(src_coordinates, dst_coordinates));
+    }
+
+    std::vector<GridPoint> Game::attack(const GridPoint & src_coordinates, const GridPoint & dst_coordinates)
+    {
+        std::vector<GridPoint> casualties;
+        throwOnFailure(tryAttack(src_coordinates, dst_coordinates, &casualties));
+        return casualties;
+    }
+
+    void Game::reload(const GridPoint & coordinates)
+    {
+        throwOnFailure(tryReload(coordinates));
+    }
+
+    CommandResult Game::tryAddCharacter(const GridPoint& coordinates, const std::shared_ptr<Character>& character)
+    {
+        if(character == nullptr)
         {
-            throw IllegalCell();
+            if(!isInBounds(coordinates))
+            {
+                return ILLEGAL_CELL;
+            }
+            if(board(coordinates.row, coordinates.col) != CharacterStore::NO_CHARACTER)
+            {
+                return CELL_OCCUPIED;
+            }
+            return SUCCESS;
         }
-        if(board(coordinates.row, coordinates.col) != nullptr)
+        Instrumentation::Timer timer(ADD_CHARACTER_CALL);
+        Instrumentation::count(ADD_COMMANDS);
+        CharacterType type = character->getType();
+        Team team = character->getTeam();
+        units_t health = character->getHealth(), ammo = character->getAmmo();
+        units_t range = character->getRange(), power = character->getPower();
+        int combo_count = character->getComboCount();
+        CommandResult result = applyAdd(coordinates, type, team, health, ammo, range, power, combo_count);
+        if(journal != nullptr)
         {
-            throw CellOccupied();
+            journal->recordAdd(coordinates, type, team, health, ammo, range, power, combo_count, result);
         }
-        board(coordinates.row, coordinates.col) = character;
+        return result;
     }
-    
-    void Game::move(const GridPoint & src_coordinates, const GridPoint & dst_coordinates)
+
+    CommandResult Game::tryAddCharacter(const GridPoint& coordinates, CharacterType type, Team team,
+                                        units_t health, units_t ammo, units_t range, units_t power)
     {
-        if(!(isInBounds(src_coordinates)) || !(isInBounds(dst_coordinates)))
+        Instrumentation::Timer timer(ADD_CHARACTER_CALL);
+        Instrumentation::count(ADD_COMMANDS);
+        // The checks of makeCharacter
+        if(health <= 0 || ammo < 0 || range < 0 || power < 0)
         {
-            throw IllegalCell();
+            return ILLEGAL_ARGUMENT;
         }
-        if (board(src_coordinates.row, src_coordinates.col) == nullptr)  
+        CommandResult result = applyAdd(coordinates, type, team, health, ammo, range, power, 0);
+        if(journal != nullptr)
         {
-            throw CellEmpty();
-        }  
-        if(!board(src_coordinates.row, src_coordinates.col)->
-        isLegalMove(GridPoint::distance(src_coordinates, dst_coordinates)))
+            journal->recordAdd(coordinates, type, team, health, ammo, range, power, 0, result);
+        }
+        return result;
+    }
+
+    CommandResult Game::tryMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates)
+    {
+        Instrumentation::Timer timer(MOVE_CALL);
+        Instrumentation::count(MOVE_COMMANDS);
+        CommandResult result = applyMove(src_coordinates, dst_coordinates);
+        if(journal != nullptr)
         {
-            throw MoveTooFar();
+            journal->recordCommand(Command::move(src_coordinates, dst_coordinates), result);
+        }
+        return result;
+    }
+
+    CommandResult Game::tryAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                    std::vector<GridPoint>* casualties)
+    {
+        Instrumentation::Timer timer(ATTACK_CALL);
+        Instrumentation::count(ATTACK_COMMANDS);
+        scratch_damaged.clear();
+        CommandResult result = applyAttack(src_coordinates, dst_coordinates, scratch_damaged);
+        if(journal != nullptr)
+        {
+            journal->recordCommand(Command::attack(src_coordinates, dst_coordinates), result);
         }
-        if (board(dst_coordinates.row, dst_coordinates.col) != nullptr)
+        std::vector<GridPoint>& dead = (casualties != nullptr)? *casualties : scratch_casualties;
+        dead.clear();
+        if(result == SUCCESS)
         {
-            throw CellOccupied();
+            clearDeadCharacters(scratch_damaged, dead);
         }
-        board(dst_coordinates.row, dst_coordinates.col) = board(src_coordinates.row, src_coordinates.col);
-        board(src_coordinates.row, src_coordinates.col) = nullptr;
+        return result;
     }
 
-    void Game::attack(const GridPoint & src_coordinates, const GridPoint & dst_coordinates)
+    CommandResult Game::tryReload(const GridPoint& coordinates)
     {
-        if(!isInBounds(src_coordinates) || !isInBounds(dst_coordinates))
+        Instrumentation::Timer timer(RELOAD_CALL);
+        Instrumentation::count(RELOAD_COMMANDS);
+        CommandResult result = applyReload(coordinates);
+        if(journal != nullptr)
         {
-            throw IllegalCell();
+            journal->recordCommand(Command::reload(coordinates), result);
         }
-        if (board(src_coordinates.row, src_coordinates.col) == nullptr)  
+        return result;
+    }
+
+    void Game::execute(const Command* commands, int count, CommandResult* results)
+    {
+        Instrumentation::Timer timer(EXECUTE_CALL);
+        for(int i = 0; i < count; i++)
         {
-            throw CellEmpty();
+            const Command& command = commands[i];
+            switch(command.type)
+            {
+                case MOVE:
+                results[i] = tryMove(command.src, command.dst);
+                break;
+
+                case ATTACK:
+                results[i] = tryAttack(command.src, command.dst);
+                break;
+
+                case RELOAD:
+                results[i] = tryReload(command.src);
+                break;
+            }
         }
-        if(!board(src_coordinates.row, src_coordinates.col)->
-        isInAttackRange(src_coordinates, dst_coordinates))
+    }
+
+    std::vector<CommandResult> Game::execute(const std::vector<Command>& commands)
+    {
+        std::vector<CommandResult> results(commands.size());
+        if(!commands.empty())
         {
-            throw OutOfRange();
+            execute(commands.data(), static_cast<int>(commands.size()), results.data());
         }
-        board(src_coordinates.row, src_coordinates.col)->attack(board, src_coordinates, dst_coordinates);
-        clearDeadCharacters();
+        return results;
     }
 
-    void Game::reload(const GridPoint & coordinates)
+    int Game::legalCommands(const GridPoint& coordinates, Command* commands, int capacity) const
     {
-        if ((coordinates.row < 0) || (coordinates.col < 0) 
-            || (coordinates.row >= board.height()) || (coordinates.col >= board.width()))
+        Instrumentation::Timer timer(LEGAL_COMMANDS_CALL);
+        if(!isInBounds(coordinates))
         {
             throw IllegalCell();
         }
-        if(board(coordinates.row, coordinates.col) == nullptr)
+        int id = board(coordinates.row, coordinates.col);
+        if(id == CharacterStore::NO_CHARACTER)
         {
             throw CellEmpty();
         }
-        board(coordinates.row, coordinates.col)->reload();
+        int count = 0;
+        appendLegalCommands(id, commands, capacity, count);
+        return count;
     }
-    
-    bool Game::isOver(Team* winningTeam) const noexcept
+
+    int Game::legalCommands(Team team, Command* commands, int capacity) const noexcept
     {
-        bool cppFlag = false, pythonFlag = false; //false = none exist on the board, true = otherwise
-        bool winnerFlag = false;
-        Team whoWon;
-        for (const std::shared_ptr<Character>& character_ptr : board)
+        Instrumentation::Timer timer(LEGAL_COMMANDS_CALL);
+        int count = 0;
+        for(int id = 0; id < characters.size(); id++)
         {
-            if (character_ptr != nullptr)
+            if(characters.getTeam(id) == team)
             {
-                if (character_ptr->getTeam() == CPP)
-                {
-                    cppFlag = true;
-                }
-                if (character_ptr->getTeam() == PYTHON)
-                {
-                    pythonFlag = true;
-                }
+                appendLegalCommands(id, commands, capacity, count);
             }
         }
+        return count;
+    }
+
+    void Game::attachJournal(CommandJournal* journal)
+    {
+        this->journal = journal;
+        if(journal != nullptr)
+        {
+            recordSnapshot();
+        }
+    }
+
+    void Game::attachRenderer(GameRenderer* renderer)
+    {
+        if(renderer != nullptr)
+        {
+            renderer->reset(board.height(), board.width());
+        }
+        this->renderer = renderer;
+    }
+
+    void Game::attachListener(GameEventListener* listener) noexcept
+    {
+        events.attach(listener);
+    }
+
+    void Game::begin()
+    {
+        undo_log.begin(position_hash);
+        // Rollback restores cells without allocating, so keep the tiles it may restore into
+        board.retainEmptyTiles(true);
+        occupancy.retainEmptyTiles(true);
+    }
+
+    void Game::commit() noexcept
+    {
+        undo_log.commit();
+        if(!undo_log.isActive())
+        {
+            board.retainEmptyTiles(false);
+            occupancy.retainEmptyTiles(false);
+        }
+    }
+
+    void Game::rollback()
+    {
+        if(!undo_log.isActive())
+        {
+            return;
+        }
+        if(renderer != nullptr)
+        {
+            undo_log.forEachRecordedCell([&](const GridPoint& cell) { renderer->markDirty(cell); });
+        }
+        undo_log.rollback(board, characters, occupancy, position_hash);
+        if(!undo_log.isActive())
+        {
+            board.retainEmptyTiles(false);
+            occupancy.retainEmptyTiles(false);
+        }
+        if(journal != nullptr)
+        {
+            recordSnapshot();
+        }
+    }
+
+    bool Game::inTransaction() const noexcept
+    {
+        return undo_log.isActive();
+    }
+
+    void Game::clear()
+    {
+        undo_log.clear();
+        board.retainEmptyTiles(false);
+        occupancy.retainEmptyTiles(false);
+        for(int id = 0; id < characters.size(); id++)
+        {
+            GridPoint position = characters.getPosition(id);
+            board.set(position.row, position.col, CharacterStore::NO_CHARACTER);
+            occupancy.reset(position);
+            if(renderer != nullptr)
+            {
+                renderer->markDirty(position);
+            }
+        }
+        characters.clear();
+        position_hash = 0;
+        if(journal != nullptr)
+        {
+            recordSnapshot();
+        }
+    }
+
+    void Game::characterPositions(Team team, std::vector<GridPoint>& positions) const
+    {
+        positions.clear();
+        for(int id = 0; id < characters.size(); id++)
+        {
+            if(characters.getTeam(id) == team)
+            {
+                positions.push_back(characters.getPosition(id));
+            }
+        }
+    }
+
+    bool Game::isOver(Team* winningTeam) const noexcept
+    {
+        bool cppFlag = characters.count(CPP) > 0; //false = none exist on the board, true = otherwise
+        bool pythonFlag = characters.count(PYTHON) > 0;
+        bool winnerFlag = false;
+        Team whoWon;
         if(cppFlag && !pythonFlag)
         {
             whoWon = CPP;
@@ -134,35 +344,616 @@ namespace mtm
         return winnerFlag;
     }
 
+    std::uint64_t Game::hash() const noexcept
+    {
+        return position_hash;
+    }
+
+    std::uint64_t Game::computeHash() const noexcept
+    {
+        std::uint64_t hash = 0;
+        for(int id = 0; id < characters.size(); id++)
+        {
+            hash ^= characterKey(id);
+        }
+        return hash;
+    }
+
+    int Game::height() const noexcept
+    {
+        return board.height();
+    }
+
+    int Game::width() const noexcept
+    {
+        return board.width();
+    }
+
+    const OccupancyBitboards& Game::occupancyBitboards() const noexcept
+    {
+        return occupancy;
+    }
+
+    size_t Game::boardMemoryUsage() const noexcept
+    {
+        return board.memoryUsage() + occupancy.memoryUsage();
+    }
+
+    int Game::characterCount(Team team) const noexcept
+    {
+        return characters.count(team);
+    }
+
+    units_t Game::totalHealth(Team team) const noexcept
+    {
+        return characters.totalHealth(team);
+    }
+
+    units_t Game::totalAmmo(Team team) const noexcept
+    {
+        return characters.totalAmmo(team);
+    }
+
+    std::vector<GridPoint> Game::charactersBelowHealth(units_t threshold) const
+    {
+        std::vector<int> ids;
+        characters.findBelowHealth(threshold, ids);
+        std::vector<GridPoint> result;
+        result.reserve(ids.size());
+        for(int id : ids)
+        {
+            result.push_back(characters.getPosition(id));
+        }
+        return result;
+    }
+
     bool Game::isInBounds(const GridPoint& coordinates) const
     {
-        if((coordinates.row < 0) || (coordinates.col < 0) 
+        if((coordinates.row < 0) || (coordinates.col < 0)
         || (coordinates.row >= board.height()) || (coordinates.col >= board.width()) )
         {
             return false;
         }
         return true;
     }
-    
+
     /* Private Methods */
-    void Game::clearDeadCharacters() noexcept
+    CommandResult Game::applyAdd(const GridPoint& coordinates, CharacterType type, Team team, units_t health,
+                                    units_t ammo, units_t range, units_t power, int combo_count)
+    {
+        if(!isInBounds(coordinates))
+        {
+            return ILLEGAL_CELL;
+        }
+        if(board(coordinates.row, coordinates.col) != CharacterStore::NO_CHARACTER)
+        {
+            return CELL_OCCUPIED;
+        }
+        if(undo_log.isActive())
+        {
+            undo_log.recordAdd();
+        }
+        int id = characters.add(type, team, health, ammo, range, power, combo_count, coordinates);
+        setCell(coordinates, id);
+        toggleKey(id);
+        return SUCCESS;
+    }
+
+    CommandResult Game::applyMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates)
     {
-        for(std::shared_ptr<Character>& cell : board)
+        if(!(isInBounds(src_coordinates)) || !(isInBounds(dst_coordinates)))
         {
-            if(cell != nullptr)
+            return ILLEGAL_CELL;
+        }
+        int id = board(src_coordinates.row, src_coordinates.col);
+        if (id == CharacterStore::NO_CHARACTER)
+        {
+            return CELL_EMPTY;
+        }
+        if(!CharacterRules::isLegalMove(characters.getType(id), GridPoint::distance(src_coordinates, dst_coordinates)))
+        {
+            return MOVE_TOO_FAR;
+        }
+        if (board(dst_coordinates.row, dst_coordinates.col) != CharacterStore::NO_CHARACTER)
+        {
+            return CELL_OCCUPIED;
+        }
+        setCell(dst_coordinates, id);
+        setCell(src_coordinates, CharacterStore::NO_CHARACTER);
+        setPosition(id, dst_coordinates);
+        if(events.active())
+        {
+            events.emit(MoveEvent{src_coordinates, dst_coordinates, characters.getType(id), characters.getTeam(id)});
+        }
+        return SUCCESS;
+    }
+
+    CommandResult Game::applyAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                    std::vector<GridPoint>& damaged_cells)
+    {
+        if(!isInBounds(src_coordinates) || !isInBounds(dst_coordinates))
+        {
+            return ILLEGAL_CELL;
+        }
+        int id = board(src_coordinates.row, src_coordinates.col);
+        if (id == CharacterStore::NO_CHARACTER)
+        {
+            return CELL_EMPTY;
+        }
+        if(!CharacterRules::isInAttackRange(characters.getType(id), characters.getRange(id),
+            src_coordinates, dst_coordinates))
+        {
+            return OUT_OF_RANGE;
+        }
+        switch(characters.getType(id))
+        {
+            case SOLDIER:
+            return soldierAttack(id, src_coordinates, dst_coordinates, damaged_cells);
+
+            case MEDIC:
+            return medicAttack(id, src_coordinates, dst_coordinates, damaged_cells);
+
+            case SNIPER:
+            return sniperAttack(id, src_coordinates, dst_coordinates, damaged_cells);
+        }
+        return SUCCESS;
+    }
+
+    CommandResult Game::applyReload(const GridPoint& coordinates)
+    {
+        if(!isInBounds(coordinates))
+        {
+            return ILLEGAL_CELL;
+        }
+        int id = board(coordinates.row, coordinates.col);
+        if(id == CharacterStore::NO_CHARACTER)
+        {
+            return CELL_EMPTY;
+        }
+        setAmmo(id, characters.getAmmo(id) + CHARACTER_TRAITS[characters.getType(id)].reload_amount);
+        if(events.active())
+        {
+            events.emit(ReloadEvent{coordinates, characters.getAmmo(id)});
+        }
+        return SUCCESS;
+    }
+
+    void Game::throwOnFailure(CommandResult result)
+    {
+        switch(result)
+        {
+            case SUCCESS:
+            return;
+
+            case ILLEGAL_ARGUMENT:
+            throw IllegalArgument();
+
+            case ILLEGAL_CELL:
+            throw IllegalCell();
+
+            case CELL_EMPTY:
+            throw CellEmpty();
+
+            case MOVE_TOO_FAR:
+            throw MoveTooFar();
+
+            case CELL_OCCUPIED:
+            throw CellOccupied();
+
+            case OUT_OF_RANGE:
+            throw OutOfRange();
+
+            case OUT_OF_AMMO:
+            throw OutOfAmmo();
+
+            case ILLEGAL_TARGET:
+            throw IllegalTarget();
+        }
+    }
+
+    void Game::appendLegalCommands(int id, Command* commands, int capacity, int& count) const noexcept
+    {
+        GridPoint src = characters.getPosition(id);
+        CharacterType type = characters.getType(id);
+        Team team = characters.getTeam(id);
+        units_t range = characters.getRange(id);
+        bool has_ammo = CharacterRules::hasEnoughAmmo(type, characters.getAmmo(id));
+        int height = board.height(), width = board.width();
+        auto emit = [&](const Command& command)
+        {
+            if(count < capacity)
+            {
+                commands[count] = command;
+            }
+            count++;
+        };
+
+        // Attacks. Mirrors the checks of applyAttack and the per-type attacks
+        if(type == SOLDIER)
+        {
+            // Any cell of its row or column in range, empty or not
+            if(has_ammo)
+            {
+                int reach = std::min(range, height + width); // No cell is farther, and this can not overflow
+                int first_row = std::max(0, src.row - reach), last_row = std::min(height - 1, src.row + reach);
+                int first_col = std::max(0, src.col - reach), last_col = std::min(width - 1, src.col + reach);
+                for(int row = first_row; row <= last_row; row++)
+                {
+                    emit(Command::attack(src, GridPoint(row, src.col)));
+                }
+                for(int col = first_col; col <= last_col; col++)
+                {
+                    if(col != src.col)
+                    {
+                        emit(Command::attack(src, GridPoint(src.row, col)));
+                    }
+                }
+            }
+        }
+        else
+        {
+            // Characters within the ring [minimum range, range]: a medic heals teammates
+            // without ammo, every other target is an enemy that costs ammo
+            int inner = std::max(1, CharacterRules::minimumRange(type, range));
+            bool targets_enemies = has_ammo, targets_allies = (type == MEDIC);
+            auto visit = [&](const GridPoint& dst, int)
+            {
+                emit(Command::attack(src, dst));
+            };
+            // Scan whichever takes fewer steps: the words of the ring rows, or the characters
+            long long ring_rows = std::min<long long>(2LL * range + 1, height);
+            long long ring_words = ring_rows * (std::min<long long>(2LL * range + 1, width) / 64 + 2);
+            if(ring_words <= characters.size())
+            {
+                Team enemy_team = (team == CPP)? PYTHON : CPP;
+                if(targets_enemies)
+                {
+                    occupancy.forEachInRing(enemy_team, src, inner, range, visit);
+                }
+                if(targets_allies)
+                {
+                    occupancy.forEachInRing(team, src, inner, range, visit);
+                }
+            }
+            else
+            {
+                for(int other = 0; other < characters.size(); other++)
+                {
+                    GridPoint dst = characters.getPosition(other);
+                    int distance = GridPoint::distance(src, dst);
+                    bool enemy = characters.getTeam(other) != team;
+                    if(distance >= inner && distance <= range && (enemy? targets_enemies : targets_allies))
+                    {
+                        visit(dst, distance);
+                    }
+                }
+            }
+        }
+
+        // Moves, to every empty cell within the move range
+        std::uint64_t scanned = 0;
+        ManhattanDiamond::forEachInRing(src, 1, CHARACTER_TRAITS[type].max_move_range, height, width,
+            [&](const GridPoint& dst, int)
+            {
+                scanned++;
+                if(board(dst.row, dst.col) == CharacterStore::NO_CHARACTER)
+                {
+                    emit(Command::move(src, dst));
+                }
+            });
+        Instrumentation::count(CELLS_SCANNED, scanned);
+
+        emit(Command::reload(src));
+    }
+
+    void Game::recordSnapshot()
+    {
+        journal->recordReset(board.height(), board.width());
+        for(int id = 0; id < characters.size(); id++)
+        {
+            journal->recordAdd(characters.getPosition(id), characters.getType(id), characters.getTeam(id),
+                characters.getHealth(id), characters.getAmmo(id), characters.getRange(id),
+                characters.getPower(id), characters.getComboCount(id), SUCCESS);
+        }
+    }
+
+    char Game::cellSymbol(int row, int col) const noexcept
+    {
+        Instrumentation::count(CELLS_SCANNED);
+        int id = board(row, col);
+        if(id == CharacterStore::NO_CHARACTER)
+        {
+            return EMPTY_CELL;
+        }
+        return CharacterRules::getName(characters.getType(id), characters.getTeam(id));
+    }
+
+    void Game::setCell(const GridPoint& coordinates, int id)
+    {
+        if(undo_log.isActive())
+        {
+            undo_log.recordCell(board, coordinates);
+        }
+        board.set(coordinates.row, coordinates.col, id);
+        occupancy.reset(coordinates);
+        if(id != CharacterStore::NO_CHARACTER)
+        {
+            occupancy.set(coordinates, characters.getTeam(id));
+        }
+        if(renderer != nullptr)
+        {
+            renderer->markDirty(coordinates);
+        }
+    }
+
+    void Game::setHealth(int id, units_t health)
+    {
+        if(undo_log.isActive())
+        {
+            undo_log.recordHealth(characters, id);
+        }
+        // The key only changes when the value moves to another bucket
+        bool rehash = ZobristKeys::bucket(characters.getHealth(id)) != ZobristKeys::bucket(health);
+        if(rehash)
+        {
+            toggleKey(id);
+        }
+        characters.setHealth(id, health);
+        if(rehash)
+        {
+            toggleKey(id);
+        }
+    }
+
+    void Game::setAmmo(int id, units_t ammo)
+    {
+        if(undo_log.isActive())
+        {
+            undo_log.recordAmmo(characters, id);
+        }
+        // The key only changes when the value moves to another bucket
+        bool rehash = ZobristKeys::bucket(characters.getAmmo(id)) != ZobristKeys::bucket(ammo);
+        if(rehash)
+        {
+            toggleKey(id);
+        }
+        characters.setAmmo(id, ammo);
+        if(rehash)
+        {
+            toggleKey(id);
+        }
+    }
+
+    void Game::setComboCount(int id, int combo_count)
+    {
+        if(undo_log.isActive())
+        {
+            undo_log.recordComboCount(characters, id);
+        }
+        toggleKey(id);
+        characters.setComboCount(id, combo_count);
+        toggleKey(id);
+    }
+
+    void Game::setPosition(int id, const GridPoint& position)
+    {
+        if(undo_log.isActive())
+        {
+            undo_log.recordPosition(characters, id);
+        }
+        toggleKey(id);
+        characters.setPosition(id, position);
+        toggleKey(id);
+    }
+
+    void Game::toggleKey(int id) noexcept
+    {
+        if(!hash_deferred)
+        {
+            position_hash ^= characterKey(id);
+        }
+    }
+
+    std::uint64_t Game::characterKey(int id) const noexcept
+    {
+        GridPoint position = characters.getPosition(id);
+        return ZobristKeys::characterKey(position.row, position.col, characters.getType(id),
+            characters.getTeam(id), characters.getHealth(id), characters.getAmmo(id), characters.getComboCount(id));
+    }
+
+    void Game::clearDeadCharacters(const std::vector<GridPoint>& damaged_cells,
+                                    std::vector<GridPoint>& casualties)
+    {
+        Instrumentation::count(CELLS_SCANNED, damaged_cells.size());
+        for(const GridPoint& coordinates : damaged_cells)
+        {
+            int id = board(coordinates.row, coordinates.col);
+            if(id != CharacterStore::NO_CHARACTER)
             {
-                if(cell->getHealth() <= 0)
+                if(characters.getHealth(id) <= 0)
                 {
-                    cell = nullptr;
+                    if(events.active())
+                    {
+                        events.emit(DeathEvent{coordinates, characters.getType(id), characters.getTeam(id)});
+                    }
+                    removeCharacter(coordinates);
+                    casualties.push_back(coordinates);
                 }
             }
         }
     }
 
+    void Game::removeCharacter(const GridPoint& coordinates)
+    {
+        eraseCharacter(detachCharacter(coordinates));
+    }
+
+    int Game::detachCharacter(const GridPoint& coordinates)
+    {
+        int id = board(coordinates.row, coordinates.col);
+        toggleKey(id);
+        setCell(coordinates, CharacterStore::NO_CHARACTER);
+        return id;
+    }
+
+    void Game::eraseCharacter(int id)
+    {
+        if(undo_log.isActive())
+        {
+            undo_log.recordRemove(characters, id);
+        }
+        if(characters.remove(id))
+        {
+            // The last character of the store was moved into index id
+            setCell(characters.getPosition(id), id);
+        }
+    }
+
+    CommandResult Game::soldierAttack(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                std::vector<GridPoint>& damaged_cells)
+    {
+        if(!CharacterRules::hasEnoughAmmo(characters.getType(id), characters.getAmmo(id)))
+        {
+            return OUT_OF_AMMO;
+        }
+        if((src_coordinates.col != dst_coordinates.col) && (src_coordinates.row != dst_coordinates.row))
+        {
+            return ILLEGAL_TARGET;
+        }
+        Team team = characters.getTeam(id);
+        units_t power = characters.getPower(id);
+        int area_of_effect = CharacterRules::splashRadius(SOLDIER, characters.getRange(id));
+        units_t area_of_effect_damage = CharacterRules::splashDamage(SOLDIER, power);
+        center_hits.clear();
+        splash_hits.clear();
+        // Only the cells the enemy occupies are visited
+        occupancy.forEachInRing(team == CPP ? PYTHON : CPP, dst_coordinates, 0, area_of_effect,
+            [&](const GridPoint& coordinates, int distance)
+            {
+                (distance == 0 ? center_hits : splash_hits).push_back(board(coordinates.row, coordinates.col));
+                damaged_cells.push_back(coordinates);
+            });
+        Instrumentation::count(CELLS_SCANNED, center_hits.size() + splash_hits.size());
+        if(undo_log.isActive())
+        {
+            for(int target : center_hits)
+            {
+                undo_log.recordHealth(characters, target);
+            }
+            for(int target : splash_hits)
+            {
+                undo_log.recordHealth(characters, target);
+            }
+        }
+        for(int target : center_hits)
+        {
+            toggleKey(target);
+        }
+        for(int target : splash_hits)
+        {
+            toggleKey(target);
+        }
+        characters.applyDamage(center_hits, power);
+        characters.applyDamage(splash_hits, area_of_effect_damage);
+        for(int target : center_hits)
+        {
+            toggleKey(target);
+        }
+        for(int target : splash_hits)
+        {
+            toggleKey(target);
+        }
+        if(events.active())
+        {
+            for(int target : center_hits)
+            {
+                events.emit(DamageEvent{src_coordinates, characters.getPosition(target), power,
+                    characters.getHealth(target), false});
+            }
+            for(int target : splash_hits)
+            {
+                events.emit(DamageEvent{src_coordinates, characters.getPosition(target), area_of_effect_damage,
+                    characters.getHealth(target), true});
+            }
+        }
+        setAmmo(id, characters.getAmmo(id) - CHARACTER_TRAITS[SOLDIER].ammo_cost); //Reduce ammo
+        return SUCCESS;
+    }
+
+    CommandResult Game::medicAttack(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                            std::vector<GridPoint>& damaged_cells)
+    {
+        int target = board(dst_coordinates.row, dst_coordinates.col);
+        Team team = characters.getTeam(id);
+        if(target != CharacterStore::NO_CHARACTER)
+        {
+            if((characters.getTeam(target) != team) && !CharacterRules::hasEnoughAmmo(characters.getType(id), characters.getAmmo(id)))
+            {
+                return OUT_OF_AMMO;
+            }
+        }
+        else if(!CharacterRules::hasEnoughAmmo(characters.getType(id), characters.getAmmo(id)))
+        {
+            return OUT_OF_AMMO;
+        }
+        if(target == CharacterStore::NO_CHARACTER ||
+        GridPoint::distance(src_coordinates, dst_coordinates) == 0)
+        {
+            return ILLEGAL_TARGET;
+        }
+        if(characters.getTeam(target) != team)
+        {
+            setHealth(target, characters.getHealth(target) - characters.getPower(id));
+            setAmmo(id, characters.getAmmo(id) - CHARACTER_TRAITS[MEDIC].ammo_cost);
+            damaged_cells.push_back(dst_coordinates);
+            if(events.active())
+            {
+                events.emit(DamageEvent{src_coordinates, dst_coordinates, characters.getPower(id),
+                    characters.getHealth(target), false});
+            }
+        }
+        else
+        {
+            setHealth(target, characters.getHealth(target) + characters.getPower(id));
+            if(events.active())
+            {
+                events.emit(HealEvent{src_coordinates, dst_coordinates, characters.getPower(id),
+                    characters.getHealth(target)});
+            }
+        }
+        return SUCCESS;
+    }
+
+    CommandResult Game::sniperAttack(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                            std::vector<GridPoint>& damaged_cells)
+    {
+        int target = board(dst_coordinates.row, dst_coordinates.col);
+        if(!CharacterRules::hasEnoughAmmo(characters.getType(id), characters.getAmmo(id)))
+        {
+            return OUT_OF_AMMO;
+        }
+        if(target == CharacterStore::NO_CHARACTER || (characters.getTeam(target) == characters.getTeam(id)))
+        {
+            return ILLEGAL_TARGET;
+        }
+        int combo_attack_count = characters.getComboCount(id);
+        units_t power = characters.getPower(id);
+        units_t damage = CharacterRules::attackDamage(SNIPER, power, combo_attack_count);
+        setHealth(target, characters.getHealth(target) - damage);
+        if(events.active())
+        {
+            events.emit(DamageEvent{src_coordinates, dst_coordinates, damage, characters.getHealth(target), false});
+        }
+        setComboCount(id, CharacterRules::nextComboCount(SNIPER, combo_attack_count));
+        setAmmo(id, characters.getAmmo(id) - CHARACTER_TRAITS[SNIPER].ammo_cost);
+        damaged_cells.push_back(dst_coordinates);
+        return SUCCESS;
+    }
+
     /******************************************/
     /*    Function Implementation section     */
     /******************************************/
-    std::shared_ptr<Character> Game::makeCharacter(CharacterType type, Team team, 
+    std::shared_ptr<Character> Game::makeCharacter(CharacterType type, Team team,
                                 units_t health, units_t ammo, units_t range, units_t power)
     {
         if(health <= 0 || ammo < 0 || range < 0 || power < 0)
@@ -173,15 +964,15 @@ namespace mtm
         switch(type)
         {
             case SOLDIER:
-            new_character = std::shared_ptr<Character>(new Soldier(team, health, ammo, range, power));
+            new_character = std::allocate_shared<Soldier>(PoolAllocator<Soldier>(), team, health, ammo, range, power);
             break;
 
             case MEDIC:
-            new_character = std::shared_ptr<Character>(new Medic(team, health, ammo, range, power));
+            new_character = std::allocate_shared<Medic>(PoolAllocator<Medic>(), team, health, ammo, range, power);
             break;
 
             case SNIPER:
-            new_character = std::shared_ptr<Character>(new Sniper(team, health, ammo, range, power));
+            new_character = std::allocate_shared<Sniper>(PoolAllocator<Sniper>(), team, health, ammo, range, power);
             break;
         }
         return new_character;
@@ -193,28 +984,35 @@ namespace mtm
         {
             return *this;
         }
-        Game game_copy(other);
-        board = game_copy.board;
+        board = other.board;
+        characters = other.characters;
+        occupancy = other.occupancy;
+        undo_log.clear();
+        if(renderer != nullptr)
+        {
+            renderer->reset(board.height(), board.width());
+        }
+        position_hash = other.position_hash;
+        if(journal != nullptr)
+        {
+            recordSnapshot();
+        }
         return *this;
     }
 
     std::ostream& operator<<(std::ostream& out, Game& game)
     {
-        char* container = new char[game.board.size()];
-        int i = 0;
-        for (const std::shared_ptr<Character>& character_ptr : game.board)
+        char* container = new char[static_cast<size_t>(game.board.height()) * game.board.width()];
+        size_t i = 0;
+        for (int row = 0; row < game.board.height(); row++)
         {
-            if(character_ptr == nullptr)
-            {
-                container[i++] = Game::EMPTY_CELL;
-            }
-            else
+            for (int col = 0; col < game.board.width(); col++)
             {
-                container[i++] = character_ptr->getName();
+                container[i++] = game.cellSymbol(row, col);
             }
         }
         printGameBoard(out, container, container + i, game.board.width());
         delete[] container;
         return out;
     }
-}
\ No newline at end of file
+}
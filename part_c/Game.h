@@ -1,12 +1,23 @@
 #ifndef GAME_INC
 #define GAME_INC
 // Includes
+#include <cstdint>
 #include <iostream>
 #include <memory>
-#include "Matrix.h"
+#include <vector>
 #include "Auxiliaries.h"
 #include "Exceptions.h"
 #include "Character.h"
+#include "CharacterStore.h"
+#include "CharacterTraits.h"
+#include "Command.h"
+#include "CommandJournal.h"
+#include "GameEvents.h"
+#include "GameRenderer.h"
+#include "GameBoard.h"
+#include "UndoLog.h"
+#include "Bitboard.h"
+#include "Zobrist.h"
 #include "Sniper.h"
 #include "Medic.h"
 #include "Soldier.h"
@@ -21,17 +32,130 @@ namespace mtm
         /*        Private Section        */
         /*********************************/
         /* Instance variables */
-        Matrix<std::shared_ptr<Character>> board;
+        /*
+         * The characters are kept in a columnar store, and each board cell holds
+         * the index of its character in the store (or CharacterStore::NO_CHARACTER).
+         */
+        GameBoard board;
+        CharacterStore characters;
+        OccupancyBitboards occupancy;   /* Which cells each team occupies, kept in line with board by setCell */
+        CommandJournal* journal;     /* Records the commands applied to the game, if attached */
+        GameRenderer* renderer;      /* Told about every changed cell, if attached */
+        GameEventSink events;        /* Where the events of the commands go, see GameEvents.h */
+        UndoLog undo_log;            /* Records the mutations of the open transactions */
+        std::uint64_t position_hash; /* The Zobrist hash of the position, kept up to date by every mutation */
+        bool hash_deferred;          /* Set while a ConcurrentGame applies commands, see toggleKey */
+        std::vector<GridPoint> scratch_damaged;     /* Buffers of tryAttack, reused to spare allocations */
+        std::vector<GridPoint> scratch_casualties;
         bool isInBounds(const GridPoint& coordinates) const;
         static const char EMPTY_CELL = ' ';
 
         /* Private Methods */
         /*
-         * Checks the entire board for dead characters, and
-         * removes them from the game.
+         * Checks the given cells for dead characters, removes them from the game
+         * and appends their coordinates to casualties.
+         * Only cells that were damaged by an attack can hold a dead character,
+         * so there is no need to sweep the entire board.
+         */
+        void clearDeadCharacters(const std::vector<GridPoint>& damaged_cells,
+                                    std::vector<GridPoint>& casualties);
+
+        /*
+         * Removes the character at coordinates from the board and the store.
+         * detachCharacter takes it off the board (and out of the hash), and
+         * returns its index; eraseCharacter then removes it from the store,
+         * which may move another character to index id.
+         */
+        void removeCharacter(const GridPoint& coordinates);
+        int detachCharacter(const GridPoint& coordinates);
+        void eraseCharacter(int id);
+
+        /*
+         * Every mutation of the board and of the character fields goes through
+         * these methods, which record the previous value to the undo log while
+         * a transaction is open.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (only while a transaction is open, or when a sparse board allocates a tile)
+         */
+        void setCell(const GridPoint& coordinates, int id);
+        void setHealth(int id, units_t health);
+        void setAmmo(int id, units_t ammo);
+        void setComboCount(int id, int combo_count);
+        void setPosition(int id, const GridPoint& position);
+
+        /*
+         * Returns the Zobrist key of the character at index id (see ZobristKeys).
+         * toggleKey adds (or removes) it to the hash of the position, unless the
+         * hash is deferred: threads sharing the game would race on it, so a
+         * ConcurrentGame recomputes it once they are done instead.
+         */
+        std::uint64_t characterKey(int id) const noexcept;
+        void toggleKey(int id) noexcept;
+
+        /*
+         * The non-throwing cores of move, attack and reload.
+         * Each validates and applies a single command, and returns SUCCESS or the
+         * reason the command was rejected (in which case the game is unchanged).
+         * applyAttack appends every damaged cell to damaged_cells, and leaves
+         * the removal of the casualties to the caller.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        CommandResult applyAdd(const GridPoint& coordinates, CharacterType type, Team team, units_t health,
+                                units_t ammo, units_t range, units_t power, int combo_count);
+        CommandResult applyMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
+        CommandResult applyAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                    std::vector<GridPoint>& damaged_cells);
+        CommandResult applyReload(const GridPoint& coordinates);
+
+        /*
+         * Throws the exception matching result, unless it is SUCCESS.
          */
-        void clearDeadCharacters() noexcept;
+        static void throwOnFailure(CommandResult result);
+
+        /*
+         * Writes the legal commands of the character at index id to commands,
+         * starting at index count, and advances count past them (see legalCommands).
+         */
+        void appendLegalCommands(int id, Command* commands, int capacity, int& count) const noexcept;
+
+        /*
+         * Records the dimensions of the board and every character on it to the
+         * attached journal, so a replay can start from the current state.
+         */
+        void recordSnapshot();
+        friend class CommandJournal;
+
+        /*
+         * Returns the symbol operator<< prints for the cell at (row, col).
+         */
+        char cellSymbol(int row, int col) const noexcept;
+        friend class GameRenderer;
+        friend class ConcurrentGame;
+
+        /*
+         * Attack resolution of each character type.
+         * The rest of the rules are table driven (see CharacterTraits.h).
+         * ASSUMES: the attacker with index id is at src_coordinates,
+         * and dst_coordinates is in its attack range.
+         * Every damaged cell is appended to damaged_cells.
+         * Returns SUCCESS, OUT_OF_AMMO or ILLEGAL_TARGET.
+         *
+         * Possible exceptions:
+         * std::bad_alloc.
+         */
+        CommandResult soldierAttack(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                            std::vector<GridPoint>& damaged_cells);
+        CommandResult medicAttack(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                            std::vector<GridPoint>& damaged_cells);
+        CommandResult sniperAttack(int id, const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                            std::vector<GridPoint>& damaged_cells);
     public:
+        /* Boards of more cells than this are sparse (see the constructor) */
+        static const long long SPARSE_BOARD_CELLS = 1LL << 24;
+
         /**************************************/
         /*     C'tors and D'tors section      */
         /**************************************/
@@ -42,6 +166,9 @@ namespace mtm
          * Initializes a new Game.  
          * Creates a game board with the dimension of height x width.
          * Each cell in the board is initialized to be clear of characters.
+         * Boards of more than SPARSE_BOARD_CELLS cells are sparse: their cells
+         * and occupancy bits are kept in tiles that exist only around the
+         * characters, so their memory scales with the occupied area.
          * 
          * Possible Exceptions:
          * mtm::IllegalArgument, std::bad_alloc
@@ -54,6 +181,9 @@ namespace mtm
          *                   Game new_game =other;
          * ---------------------------------------
          * Creates a game that is a copy of other.
+         * Copying a game copies the board and the character columns,
+         * without cloning any character object.
+         * The copy is not attached to other's journal.
          *
          * Possible exceptions:
          * std::bad_alloc
@@ -68,10 +198,11 @@ namespace mtm
          * Method: addCharacter
          * Usage: game.addCharacter(coordinates, character);
          * -----------------------------------
-         * Recieves a shared_ptr to character, and places him in the wanted coordinates.
+         * Recieves a shared_ptr to character, and places a copy of his stats in the wanted coordinates.
+         * Changes made to the character object after it was added do not affect the game.
          * 
          * Possible exceptions:
-         * mtm::IllegalCell, mtm::CellOccupied.
+         * mtm::IllegalCell, mtm::CellOccupied, std::bad_alloc.
          */
         void addCharacter(const GridPoint& coordinates, std::shared_ptr<Character> character);
 
@@ -87,15 +218,18 @@ namespace mtm
         void move(const GridPoint & src_coordinates, const GridPoint & dst_coordinates);
 
         /*
-         * Method: addCharacter
-         * Usage: int rows = matrix.height();
+         * Method: attack
+         * Usage: std::vector<GridPoint> casualties = game.attack(src_coordinates, dst_coordinates);
          * -----------------------------------
          * Makes a character in the cell src_coordinates send an attack to dst_coordinates.
+         * Returns the coordinates of every character that died from the attack
+         * (and was removed from the board).
          * 
          * Possible exceptions:
-         * mtm::IllegalCell,mtm::CellEmpty, mtm::MoveTooFar, mtm::CellOccupied.
+         * mtm::IllegalCell, mtm::CellEmpty, mtm::OutOfRange, mtm::OutOfAmmo,
+         * mtm::IllegalTarget, std::bad_alloc.
          */
-        void attack(const GridPoint & src_coordinates, const GridPoint & dst_coordinates);
+        std::vector<GridPoint> attack(const GridPoint & src_coordinates, const GridPoint & dst_coordinates);
 
         /*
          * Method: reload
@@ -108,6 +242,197 @@ namespace mtm
          */
         void reload(const GridPoint & coordinates);
 
+        /*
+         * Method: tryAddCharacter, tryMove, tryAttack, tryReload
+         * Usage: CommandResult result = game.tryMove(src_coordinates, dst_coordinates);
+         *        CommandResult result = game.tryAttack(src_coordinates, dst_coordinates, &casualties);
+         *        CommandResult result = game.tryAddCharacter(coordinates, type, team, health, ammo, range, power);
+         * -----------------------------------
+         * The non-throwing versions of addCharacter, move, attack and reload.
+         * Each returns SUCCESS, or the CommandResult matching the exception the
+         * throwing method would have raised, in which case the game is unchanged.
+         * tryAttack fills casualties (if not nullptr) with the coordinates of the
+         * characters that died. tryAddCharacter can also take the stats of the
+         * character instead of a character object, and then returns
+         * ILLEGAL_ARGUMENT for the stats makeCharacter would reject.
+         * Rejecting a command never allocates. A successful command only
+         * allocates when a buffer of the game grows, which stops happening once
+         * the buffers are large enough.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        CommandResult tryAddCharacter(const GridPoint& coordinates, const std::shared_ptr<Character>& character);
+        CommandResult tryAddCharacter(const GridPoint& coordinates, CharacterType type, Team team,
+                                        units_t health, units_t ammo, units_t range, units_t power);
+        CommandResult tryMove(const GridPoint& src_coordinates, const GridPoint& dst_coordinates);
+        CommandResult tryAttack(const GridPoint& src_coordinates, const GridPoint& dst_coordinates,
+                                std::vector<GridPoint>* casualties = nullptr);
+        CommandResult tryReload(const GridPoint& coordinates);
+
+        /*
+         * Method: execute
+         * Usage: game.execute(commands, count, results);
+         *        std::vector<CommandResult> results = game.execute(commands);
+         * -----------------------------------
+         * Applies a batch of move/attack/reload commands in order.
+         * Instead of throwing, the outcome of each command is written to the
+         * matching entry of results: SUCCESS, or the CommandResult matching the
+         * exception the single-command method would have thrown.
+         * A rejected command leaves the game unchanged, and the batch goes on.
+         * Casualties of an attack are removed before the next command runs,
+         * exactly as with consecutive calls to attack.
+         *
+         * Possible exceptions:
+         * std::bad_alloc.
+         */
+        void execute(const Command* commands, int count, CommandResult* results);
+        std::vector<CommandResult> execute(const std::vector<Command>& commands);
+
+        /*
+         * Method: legalCommands
+         * Usage: int count = game.legalCommands(coordinates, commands, capacity);
+         *        int count = game.legalCommands(team, commands, capacity);
+         * -----------------------------------
+         * Writes to commands every command the character at coordinates (or
+         * every character of team) may execute successfully right now: its
+         * attacks, then its moves, then its reload, character by character.
+         * Writes at most capacity commands and returns the number of legal
+         * commands, so a return value larger than capacity means the buffer was
+         * too small (commands may be nullptr when capacity is 0).
+         * Never allocates.
+         *
+         * Possible exceptions:
+         * IllegalCell, CellEmpty (the coordinates version only)
+         */
+        int legalCommands(const GridPoint& coordinates, Command* commands, int capacity) const;
+        int legalCommands(Team team, Command* commands, int capacity) const noexcept;
+
+        /*
+         * Method: attachJournal
+         * Usage: game.attachJournal(&journal);
+         *        game.attachJournal(nullptr);
+         * -----------------------------------
+         * Starts recording every addCharacter, move, attack, reload and execute call
+         * (and its outcome) to journal, which must outlive the attachment.
+         * The current state of the game is recorded first, so replaying the journal
+         * rebuilds the game. Passing nullptr stops the recording.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        void attachJournal(CommandJournal* journal);
+
+        /*
+         * Method: attachRenderer
+         * Usage: game.attachRenderer(&renderer);
+         *        game.attachRenderer(nullptr);
+         * -----------------------------------
+         * Starts telling renderer about every cell the game changes, so
+         * renderer.render(game, out) redraws only those (see GameRenderer).
+         * renderer must outlive the attachment, and its next frame redraws the
+         * whole board. Passing nullptr detaches the current renderer.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        void attachRenderer(GameRenderer* renderer);
+
+        /*
+         * Method: attachListener
+         * Usage: game.attachListener(&listener);
+         *        game.attachListener(nullptr);
+         * -----------------------------------
+         * Starts sending listener the events of the game as they happen: a
+         * DamageEvent for every character an attack damages (including each
+         * splash hit of a soldier), a HealEvent for every heal of a medic, a
+         * DeathEvent for every character removed as dead, a MoveEvent for every
+         * move, and a ReloadEvent for every reload (see GameEvents.h).
+         * Rejected commands emit nothing, and rolling a transaction back does
+         * not retract its events. The listener of a ConcurrentGame is called
+         * from all of its threads at once.
+         * listener must outlive the attachment, and copies of the game are not
+         * attached to it. Passing nullptr detaches the current listener.
+         * Events are only emitted in builds that define MTM_GAME_EVENTS; other
+         * builds compile them out, and ignore the listener.
+         */
+        void attachListener(GameEventListener* listener) noexcept;
+
+        /*
+         * Method: begin, commit, rollback
+         * Usage: game.begin(); game.move(src, dst); game.rollback();
+         *        game.begin(); game.attack(src, dst); game.commit();
+         * -----------------------------------
+         * begin opens a transaction. From then on, every cell and character field
+         * a command changes is recorded to an undo log, so that rollback can
+         * restore the state the game had at begin, in time proportional to
+         * the number of changes. commit keeps the changes and closes the transaction.
+         * Transactions can be nested: commit and rollback close the innermost one.
+         * Neither commit nor rollback do anything if no transaction is open.
+         * Assigning to the game discards every open transaction.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (begin and rollback)
+         */
+        void begin();
+        void commit() noexcept;
+        void rollback();
+
+        /*
+         * Method: inTransaction
+         * Usage: bool speculative = game.inTransaction();
+         * -----------------------------------
+         * Returns true if and only if a transaction is open.
+         */
+        bool inTransaction() const noexcept;
+
+        /*
+         * Method: clear
+         * Usage: game.clear();
+         * -----------------------------------
+         * Removes every character from the game, keeping the board dimensions
+         * and the allocated storage, so the game can be reused for a new match.
+         * Discards every open transaction, and records the new state to the
+         * attached journal.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (only when a journal is attached)
+         */
+        void clear();
+
+        /*
+         * Method: characterPositions
+         * Usage: game.characterPositions(team, positions);
+         * -----------------------------------
+         * Replaces the contents of positions with the coordinates of every
+         * character of team. Reuses the capacity of positions.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        void characterPositions(Team team, std::vector<GridPoint>& positions) const;
+
+        /*
+         * Method: hash
+         * Usage: std::uint64_t key = game.hash();
+         * -----------------------------------
+         * Returns the 64-bit Zobrist hash of the position: the cells, types,
+         * teams, sniper combo states and health and ammo buckets of the
+         * characters (see ZobristKeys).
+         * The hash is updated incrementally by every command, in time
+         * proportional to the number of characters the command changes, and is
+         * restored by rollback.
+         */
+        std::uint64_t hash() const noexcept;
+
+        /*
+         * Method: computeHash
+         * Usage: assert(game.computeHash() == game.hash());
+         * -----------------------------------
+         * Computes the hash of the position from scratch, by visiting every character.
+         */
+        std::uint64_t computeHash() const noexcept;
+
         /*
          * Method: isOver
          * Usage: bool game_over = game.isOver();
@@ -118,6 +443,63 @@ namespace mtm
          */
         bool isOver(Team* winningTeam=NULL) const noexcept;
 
+        /*
+         * Method: height, width
+         * Usage: int rows = game.height();
+         * -----------------------------------
+         * Returns the dimensions of the game board.
+         */
+        int height() const noexcept;
+        int width() const noexcept;
+
+        /*
+         * Method: characterCount
+         * Usage: int alive = game.characterCount(team);
+         * -----------------------------------
+         * Returns the number of characters of team on the board.
+         */
+        int characterCount(Team team) const noexcept;
+
+        /*
+         * Method: occupancyBitboards
+         * Usage: int enemies = game.occupancyBitboards().countInRange(team, center, radius);
+         * -----------------------------------
+         * Returns the per-team occupancy bits of the board, for fast range, ring,
+         * row and column queries (see OccupancyBitboards).
+         * The reference stays valid, and up to date, for the lifetime of the game.
+         */
+        const OccupancyBitboards& occupancyBitboards() const noexcept;
+
+        /*
+         * Method: boardMemoryUsage
+         * Usage: size_t bytes = game.boardMemoryUsage();
+         * -----------------------------------
+         * Returns the approximate number of bytes held by the board cells and
+         * their occupancy bits.
+         */
+        size_t boardMemoryUsage() const noexcept;
+
+        /*
+         * Method: totalHealth, totalAmmo
+         * Usage: units_t health = game.totalHealth(team);
+         *        units_t ammo = game.totalAmmo(team);
+         * -----------------------------------
+         * Returns the sum of the health / ammo of every character of team.
+         */
+        units_t totalHealth(Team team) const noexcept;
+        units_t totalAmmo(Team team) const noexcept;
+
+        /*
+         * Method: charactersBelowHealth
+         * Usage: std::vector<GridPoint> weak = game.charactersBelowHealth(threshold);
+         * -----------------------------------
+         * Returns the coordinates of every character whose health is lower than threshold.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        std::vector<GridPoint> charactersBelowHealth(units_t threshold) const;
+
         /**************************************/
         /*    Function definition section     */
         /**************************************/
@@ -127,6 +509,8 @@ namespace mtm
          * --------------------------------------
          * Creates a new character with the corresponding parameters, and 
          * returns a shared_ptr to his object.
+         * The character and its reference counts share a single block from a
+         * PoolAllocator, which recycles the blocks of destroyed characters.
          * 
          * Possible exceptions:
          * mtm::IllegalArgument, std::bad_alloc.
@@ -143,6 +527,8 @@ namespace mtm
          * ----------------------------------
          * Deep-copies game into game_copy.
          * Both games will be independent after the assignment.
+         * If game_copy has a journal attached, it records the new state, and if it
+         * has a renderer attached, its next frame redraws the whole board.
          * 
          * Possible Exceptions:
          * std::bad_alloc
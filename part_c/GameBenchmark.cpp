@@ -0,0 +1,263 @@
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#include "Game.h"
+#include "Instrumentation.h"
+#include "ScenarioGenerator.h"
+
+using namespace mtm;
+using std::cout;
+using std::endl;
+using std::string;
+
+// Measures the public Game API on generated scenarios (see ScenarioGenerator.h):
+// square boards from 16x16 up to --max-size (4096 by default), each sparse
+// (2% of the cells hold characters) and dense (25%), and prints one CSV row
+// per operation and scenario:
+//
+//   operation,layout,rows,cols,characters,calls,ops_per_s,mean_ns,p50_ns,p90_ns,p99_ns,p99.9_ns,max_ns
+//
+// ops_per_s is measured with the calls back to back. The latencies are then
+// measured call by call in a second run of the same calls, so they include
+// the overhead of reading the clock (a few tens of nanoseconds).
+// Every run of the benchmark plays the same calls for the same --seed.
+// Usage: GameBenchmark [--max-size N] [--calls N] [--seed N] [BENCHMARK...]
+
+#define ADD_BENCHMARK(x) benchmarks[#x]=x;
+
+static const int SIZES[] = {16, 64, 256, 1024, 4096};
+static const double DENSITIES[] = {0.02, 0.25};
+static const char* LAYOUTS[] = {"sparse", "dense"};
+static const double MIN_SECONDS = 0.1;
+static int max_size = 4096;
+static int max_calls = 20000;
+static unsigned long long seed = 1;
+
+// Results are added here so that the compiler can not drop the operations
+static volatile long long sink = 0;
+
+// A stream buffer that discards what is written to it, so printing measures
+// only the formatting
+class DiscardBuffer : public std::streambuf {
+    char buffer[4096];
+public:
+    DiscardBuffer(){
+        setp(buffer, buffer + sizeof(buffer));
+    }
+protected:
+    int overflow(int character) override {
+        setp(buffer, buffer + sizeof(buffer));
+        return traits_type::not_eof(character);
+    }
+};
+
+static std::uint64_t elapsedNanoseconds(std::chrono::steady_clock::time_point start){
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start).count());
+}
+
+// Calls run(game, i) for every i in [0, count) on a game made by prepare, and
+// again on new games until max_calls calls were made or MIN_SECONDS passed;
+// first back to back for the throughput, then timing each call
+template<typename PREPARE, typename OPERATION>
+void measure(const string& operation, const string& layout, const ScenarioGenerator& scenario, int count,
+             PREPARE prepare, OPERATION run){
+    if (count == 0){
+        return;
+    }
+    long long calls = 0;
+    std::uint64_t nanoseconds = 0;
+    while (calls < max_calls && nanoseconds < MIN_SECONDS * 1e9){
+        Game game = prepare();
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int i = 0; i < count; i++){
+            run(game, i);
+        }
+        nanoseconds += elapsedNanoseconds(start);
+        calls += count;
+    }
+    LatencyHistogram latencies;
+    while (static_cast<long long>(latencies.count()) < calls){
+        Game game = prepare();
+        for (int i = 0; i < count; i++){
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            run(game, i);
+            latencies.record(elapsedNanoseconds(start));
+        }
+    }
+    const Game& game = scenario.game();
+    cout << operation << "," << layout << "," << game.height() << "," << game.width() << ","
+         << scenario.characters().size() << "," << calls << ","
+         << std::llround(calls * 1e9 / std::max<std::uint64_t>(nanoseconds, 1)) << ","
+         << std::llround(latencies.mean()) << "," << latencies.percentile(50) << ","
+         << latencies.percentile(90) << "," << latencies.percentile(99) << ","
+         << latencies.percentile(99.9) << "," << latencies.maximum() << endl;
+}
+
+// Runs benchmark on the scenario of every size and layout
+void forEachScenario(const std::function<void(const ScenarioGenerator&, const string&)>& benchmark){
+    for (int size : SIZES){
+        if (size > max_size){
+            break;
+        }
+        for (int layout = 0; layout < 2; layout++){
+            ScenarioConfig config;
+            config.height = size;
+            config.width = size;
+            config.density = DENSITIES[layout];
+            config.seed = seed;
+            ScenarioGenerator scenario(config);
+            benchmark(scenario, LAYOUTS[layout]);
+        }
+    }
+}
+
+void benchmarkAddCharacter(){
+    forEachScenario([](const ScenarioGenerator& scenario, const string& layout){
+        // Game::addCharacter copies the stats of the character, so one prototype per kind serves every call
+        const ScenarioConfig defaults;
+        std::shared_ptr<Character> prototypes[2][3];
+        for (int team = CPP; team <= PYTHON; team++){
+            for (int type = SOLDIER; type <= SNIPER; type++){
+                const UnitStats& stats = defaults.unit_stats[type];
+                prototypes[team][type] = Game::makeCharacter(static_cast<CharacterType>(type), static_cast<Team>(team),
+                                            stats.health, stats.ammo, stats.range, stats.power);
+            }
+        }
+        const std::vector<PlacedCharacter>& characters = scenario.characters();
+        const Game& start = scenario.game();
+        measure("add_character", layout, scenario, static_cast<int>(characters.size()),
+            [&](){ return Game(start.height(), start.width()); },
+            [&](Game& game, int i){
+                const PlacedCharacter& character = characters[i];
+                game.addCharacter(character.coordinates, prototypes[character.team][character.type]);
+            });
+    });
+}
+
+void benchmarkMove(){
+    forEachScenario([](const ScenarioGenerator& scenario, const string& layout){
+        std::vector<Command> moves = scenario.commands(MOVE, max_calls);
+        measure("move", layout, scenario, static_cast<int>(moves.size()),
+            [&](){ return Game(scenario.game()); },
+            [&](Game& game, int i){ game.move(moves[i].src, moves[i].dst); });
+    });
+}
+
+void benchmarkAttack(){
+    const char* names[] = {"soldier_attack", "medic_attack", "sniper_attack"};
+    forEachScenario([&](const ScenarioGenerator& scenario, const string& layout){
+        for (int type = SOLDIER; type <= SNIPER; type++){
+            std::vector<Command> attacks = scenario.attacks(static_cast<CharacterType>(type), max_calls);
+            measure(names[type], layout, scenario, static_cast<int>(attacks.size()),
+                [&](){ return Game(scenario.game()); },
+                [&](Game& game, int i){ sink = sink + game.attack(attacks[i].src, attacks[i].dst).size(); });
+        }
+    });
+}
+
+void benchmarkReload(){
+    forEachScenario([](const ScenarioGenerator& scenario, const string& layout){
+        std::vector<Command> reloads = scenario.commands(RELOAD, max_calls);
+        measure("reload", layout, scenario, static_cast<int>(reloads.size()),
+            [&](){ return Game(scenario.game()); },
+            [&](Game& game, int i){ game.reload(reloads[i].src); });
+    });
+}
+
+void benchmarkIsOver(){
+    forEachScenario([](const ScenarioGenerator& scenario, const string& layout){
+        // isOver does not change the game, so short batches only bound the time spent on large boards
+        measure("is_over", layout, scenario, std::min(max_calls, 100),
+            [&](){ return Game(scenario.game()); },
+            [&](Game& game, int){
+                Team winner = CPP;
+                sink = sink + game.isOver(&winner) + winner;
+            });
+    });
+}
+
+void benchmarkCopy(){
+    forEachScenario([](const ScenarioGenerator& scenario, const string& layout){
+        const Game& start = scenario.game();
+        measure("copy", layout, scenario, 1,
+            [&](){ return Game(1, 1); },
+            [&](Game&, int){
+                Game copy(start);
+                sink = sink + copy.height();
+            });
+        // Assignment into a game of the same size, which may reuse its buffers
+        measure("assign", layout, scenario, 1,
+            [&](){ return Game(start.height(), start.width()); },
+            [&](Game& game, int){
+                game = start;
+                sink = sink + game.height();
+            });
+    });
+}
+
+void benchmarkPrint(){
+    forEachScenario([](const ScenarioGenerator& scenario, const string& layout){
+        DiscardBuffer buffer;
+        std::ostream out(&buffer);
+        measure("print", layout, scenario, 1,
+            [&](){ return Game(scenario.game()); },
+            [&](Game& game, int){ out << game; });
+    });
+}
+
+int main(int argc, char* argv[]){
+
+    std::map<std::string, std::function<void()>> benchmarks;
+
+    ADD_BENCHMARK(benchmarkAddCharacter);
+    ADD_BENCHMARK(benchmarkMove);
+    ADD_BENCHMARK(benchmarkAttack);
+    ADD_BENCHMARK(benchmarkReload);
+    ADD_BENCHMARK(benchmarkIsOver);
+    ADD_BENCHMARK(benchmarkCopy);
+    ADD_BENCHMARK(benchmarkPrint);
+
+    std::vector<string> selected;
+    for (int i = 1; i < argc; i++){
+        string argument = argv[i];
+        if (argument == "--max-size" && i + 1 < argc){
+            max_size = std::atoi(argv[++i]);
+        } else if (argument == "--calls" && i + 1 < argc){
+            max_calls = std::max(1, std::atoi(argv[++i]));
+        } else if (argument == "--seed" && i + 1 < argc){
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (benchmarks.count(argument) > 0){
+            selected.push_back(argument);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--max-size N] [--calls N] [--seed N] [BENCHMARK...]" << endl;
+            return 2;
+        }
+    }
+    if (selected.empty()){
+        for (std::pair<const string, std::function<void()>>& benchmark : benchmarks){
+            selected.push_back(benchmark.first);
+        }
+    }
+
+    cout << "operation,layout,rows,cols,characters,calls,ops_per_s,mean_ns,p50_ns,p90_ns,p99_ns,p99.9_ns,max_ns" << endl;
+    try {
+        for (const string& name : selected){
+            benchmarks[name]();
+        }
+    } catch (const std::exception& e){
+        // A generated command failed, so the scenario no longer reproduces
+        std::cerr << "Benchmark failed: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,52 @@
+#include "GameBoard.h"
+
+namespace mtm
+{
+    /***************************************/
+    /*     Ctors implementation section    */
+    /***************************************/
+    GameBoard::GameBoard(int height, int width, bool sparse) :
+    rows(height), cols(width), sparse(sparse),
+    cells(sparse? 0 : static_cast<size_t>(height) * width, CharacterStore::NO_CHARACTER), tiles()
+    {
+
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    void GameBoard::set(int row, int col, int id)
+    {
+        if(!sparse)
+        {
+            cells[static_cast<size_t>(row) * cols + col] = id;
+            return;
+        }
+        int tile_row = row >> TILE_BITS, tile_col = col >> TILE_BITS;
+        Tile* tile = tiles.find(tile_row, tile_col);
+        if(tile == nullptr)
+        {
+            if(id == CharacterStore::NO_CHARACTER)
+            {
+                return;
+            }
+            tile = &tiles.obtain(tile_row, tile_col);
+        }
+        int& cell = tile->cells[cellOf(row, col)];
+        bool was_occupied = (cell != CharacterStore::NO_CHARACTER);
+        cell = id;
+        if(id != CharacterStore::NO_CHARACTER)
+        {
+            tile->occupied += !was_occupied;
+        }
+        else if(was_occupied && --tile->occupied == 0)
+        {
+            tiles.vacate(tile_row, tile_col);
+        }
+    }
+
+    size_t GameBoard::memoryUsage() const noexcept
+    {
+        return sizeof(GameBoard) + cells.capacity() * sizeof(int) + tiles.size() * sizeof(Tile);
+    }
+}
@@ -0,0 +1,144 @@
+#ifndef GAME_BOARD_INC
+#define GAME_BOARD_INC
+// Includes
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include "CharacterStore.h"
+#include "TileMap.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: GameBoard
+     * ---------------------------------------
+     * The cells of a game board, each holding the store index of the character
+     * standing in it (or CharacterStore::NO_CHARACTER).
+     * A dense board is a single array of cells. A sparse board is a TileMap
+     * of TILE_SIZE x TILE_SIZE tiles, allocated on first occupancy and freed
+     * when empty, so its memory scales with the occupied area: a board of
+     * 100000 x 100000 cells that holds a few thousand characters takes a few
+     * megabytes, where the dense array would take 40 GB.
+     * Reading a cell of a sparse board costs a hash lookup.
+     */
+    class GameBoard
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        static const int TILE_BITS = 5;
+        static const int TILE_SIZE = 1 << TILE_BITS;
+        struct Tile
+        {
+            int cells[TILE_SIZE * TILE_SIZE];
+            int occupied;
+
+            Tile() : occupied(0)
+            {
+                std::fill(cells, cells + TILE_SIZE * TILE_SIZE, static_cast<int>(CharacterStore::NO_CHARACTER));
+            }
+        };
+
+        /* Instance variables */
+        int rows;
+        int cols;
+        bool sparse;
+        std::vector<int> cells;         /* Row-major, dense boards only */
+        TileMap<Tile> tiles;            /* Sparse boards only */
+
+        static int cellOf(int row, int col) noexcept
+        {
+            return ((row & (TILE_SIZE - 1)) << TILE_BITS) | (col & (TILE_SIZE - 1));
+        }
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: GameBoard
+         * Usage: GameBoard board(height, width, sparse);
+         * ---------------------------------------
+         * Creates an empty height x width board, dense or sparse.
+         * ASSUMES: height and width are positive.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        GameBoard(int height, int width, bool sparse);
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: height, width, isSparse
+         * Usage: int rows = board.height();
+         * -----------------------------------
+         * Return the dimensions of the board, and whether it is sparse.
+         */
+        int height() const noexcept
+        {
+            return rows;
+        }
+        int width() const noexcept
+        {
+            return cols;
+        }
+        bool isSparse() const noexcept
+        {
+            return sparse;
+        }
+
+        /*
+         * Method: operator()
+         * Usage: int id = board(row, col);
+         * -----------------------------------
+         * Returns the content of the cell at (row, col).
+         * ASSUMES: the cell is on the board.
+         */
+        int operator()(int row, int col) const noexcept
+        {
+            if(!sparse)
+            {
+                return cells[static_cast<size_t>(row) * cols + col];
+            }
+            const Tile* tile = tiles.find(row >> TILE_BITS, col >> TILE_BITS);
+            return (tile == nullptr)? static_cast<int>(CharacterStore::NO_CHARACTER) : tile->cells[cellOf(row, col)];
+        }
+
+        /*
+         * Method: set
+         * Usage: board.set(row, col, id);
+         * -----------------------------------
+         * Sets the content of the cell at (row, col).
+         * ASSUMES: the cell is on the board.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (only when a sparse board allocates a tile)
+         */
+        void set(int row, int col, int id);
+
+        /*
+         * Method: retainEmptyTiles
+         * Usage: board.retainEmptyTiles(true);
+         * -----------------------------------
+         * While retained, the tiles of a sparse board are not freed when they
+         * empty, so putting back any content a cell had since retaining started
+         * never allocates. Stopping frees the retained tiles that are still empty.
+         */
+        void retainEmptyTiles(bool retain) noexcept
+        {
+            tiles.retainEmptyTiles(retain);
+        }
+
+        /*
+         * Method: memoryUsage
+         * Usage: size_t bytes = board.memoryUsage();
+         * -----------------------------------
+         * Returns the approximate number of bytes held by the cells.
+         */
+        size_t memoryUsage() const noexcept;
+    };
+}
+#endif
@@ -0,0 +1,216 @@
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "CommandJournal.h"
+#include "CommandScript.h"
+#include "Game.h"
+#include "Instrumentation.h"
+#include "MappedFile.h"
+
+using namespace mtm;
+using std::cerr;
+using std::cout;
+using std::endl;
+using std::string;
+
+// Runs a command script against a Game without a user interface, and reports
+// its throughput and the final position.
+//
+// A script is either a text script (see CommandScript.h), or a binary one:
+// a CommandJournal as written by CommandJournal::write, which is replayed
+// and must reproduce every recorded outcome. Text scripts can be converted
+// to binary ones with --journal.
+
+static const char* USAGE =
+    "Usage: GameCli [--print] [--repeat N] [--journal OUTPUT] [--metrics text|json] SCRIPT\n"
+    "  --print           print the final board\n"
+    "  --repeat N        run the script N times and report the fastest run\n"
+    "  --journal OUTPUT  write the run of a text script as a binary script\n"
+    "  --metrics FORMAT  dump the counters and latencies of all the runs\n"
+    "                    (builds with MTM_INSTRUMENTATION only)\n";
+
+static const char* RESULT_NAMES[] = {"SUCCESS", "ILLEGAL_ARGUMENT", "ILLEGAL_CELL", "CELL_EMPTY",
+    "MOVE_TOO_FAR", "CELL_OCCUPIED", "OUT_OF_RANGE", "OUT_OF_AMMO", "ILLEGAL_TARGET"};
+
+struct Options {
+    bool print = false;
+    int repeat = 1;
+    string journal_path;
+    string metrics_format;
+    string script_path;
+};
+
+// Returns false if the arguments can not be understood
+bool parseOptions(int argc, char* argv[], Options& options){
+    for (int i = 1; i < argc; i++){
+        string argument = argv[i];
+        if (argument == "--print"){
+            options.print = true;
+        } else if (argument == "--repeat" && i + 1 < argc){
+            options.repeat = std::atoi(argv[++i]);
+            if (options.repeat <= 0){
+                return false;
+            }
+        } else if (argument == "--journal" && i + 1 < argc){
+            options.journal_path = argv[++i];
+        } else if (argument == "--metrics" && i + 1 < argc){
+            options.metrics_format = argv[++i];
+            if (options.metrics_format != "text" && options.metrics_format != "json"){
+                return false;
+            }
+        } else if (argument.empty() || argument[0] == '-' || !options.script_path.empty()){
+            return false;
+        } else {
+            options.script_path = argument;
+        }
+    }
+    return !options.script_path.empty();
+}
+
+// A journal starts with its little endian record and byte counts, whose high
+// bytes are zero for any realistic script; text scripts hold no such bytes
+bool isBinaryScript(const MappedFile& file){
+    for (std::size_t i = 0; i < file.size() && i < 8; i++){
+        if (static_cast<unsigned char>(file.data()[i]) < '\t'){
+            return true;
+        }
+    }
+    return false;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start){
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void reportThroughput(const string& what, long long count, double seconds){
+    cout << std::left << std::setw(12) << what << std::right << std::setw(12) << count << " in "
+         << std::fixed << std::setprecision(3) << seconds * 1000 << " ms";
+    if (seconds > 0){
+        cout << ", " << std::setprecision(0) << count / seconds << " per second";
+    }
+    cout << endl;
+}
+
+void reportGame(Game& game, bool print){
+    for (Team team : {CPP, PYTHON}){
+        cout << ((team == CPP) ? "CPP:    " : "PYTHON: ") << game.characterCount(team) << " characters, "
+             << game.totalHealth(team) << " health, " << game.totalAmmo(team) << " ammo" << endl;
+    }
+    Team winner = CPP;
+    if (game.isOver(&winner)){
+        cout << "Winner: " << ((winner == CPP) ? "CPP" : "PYTHON") << endl;
+    } else {
+        cout << "Winner: none" << endl;
+    }
+    cout << "Hash:   " << std::hex << std::setw(16) << std::setfill('0') << game.hash()
+         << std::dec << std::setfill(' ') << endl;
+    if (print){
+        cout << game;
+    }
+}
+
+void reportMetrics(const string& format){
+    if (!Instrumentation::ENABLED){
+        cerr << "Built without MTM_INSTRUMENTATION, there are no metrics" << endl;
+        return;
+    }
+    InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+    cout << ((format == "json") ? snapshot.toJson() + "\n" : snapshot.toText());
+}
+
+int runText(const MappedFile& file, const Options& options){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    CommandScript script = CommandScript::parse(file.data(), file.size());
+    double parse_seconds = secondsSince(start);
+    cout << "Text script, " << file.size() << " bytes, " << script.size() << " statements" << endl;
+    reportThroughput("Parsed", static_cast<long long>(script.size()), parse_seconds);
+
+    CommandJournal journal;
+    CommandScript::Statistics statistics;
+    Game game(1, 1);
+    double best = 0;
+    for (int run = 0; run < options.repeat; run++){
+        CommandScript::Statistics current;
+        bool record = (run == 0 && !options.journal_path.empty());
+        start = std::chrono::steady_clock::now();
+        game = script.run(current, record ? &journal : nullptr);
+        double seconds = secondsSince(start);
+        if (run == 0 || seconds < best){
+            best = seconds;
+        }
+        statistics = current;
+    }
+    reportThroughput("Executed", statistics.additions + statistics.commands, best);
+    cout << "  " << statistics.additions << " additions, " << statistics.commands << " commands" << endl;
+    for (int result = SUCCESS; result <= ILLEGAL_TARGET; result++){
+        if (statistics.outcomes[result] > 0){
+            cout << "  " << std::left << std::setw(18) << RESULT_NAMES[result] << std::right
+                 << std::setw(12) << statistics.outcomes[result] << endl;
+        }
+    }
+    reportGame(game, options.print);
+
+    if (!options.journal_path.empty()){
+        std::ofstream out(options.journal_path.c_str(), std::ios::binary);
+        journal.write(out);
+        if (!out){
+            cerr << "Can not write " << options.journal_path << endl;
+            return 1;
+        }
+        cout << "Wrote " << journal.size() << " records to " << options.journal_path << endl;
+    }
+    return 0;
+}
+
+int runBinary(const MappedFile& file, const Options& options){
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(file.data());
+    int records = CommandJournal::recordCount(data, file.size());
+    cout << "Binary script, " << file.size() << " bytes, " << records << " records" << endl;
+    Game game(1, 1);
+    double best = 0;
+    for (int run = 0; run < options.repeat; run++){
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        game = CommandJournal::replay(data, file.size());
+        double seconds = secondsSince(start);
+        if (run == 0 || seconds < best){
+            best = seconds;
+        }
+    }
+    reportThroughput("Replayed", records, best);
+    reportGame(game, options.print);
+    return 0;
+}
+
+int main(int argc, char* argv[]){
+    Options options;
+    if (!parseOptions(argc, argv, options)){
+        cerr << USAGE;
+        return 2;
+    }
+    try {
+        MappedFile file(options.script_path);
+        int status = 0;
+        if (isBinaryScript(file)){
+            if (!options.journal_path.empty()){
+                cerr << "--journal only applies to text scripts" << endl;
+                return 2;
+            }
+            status = runBinary(file, options);
+        } else {
+            status = runText(file, options);
+        }
+        if (!options.metrics_format.empty()){
+            reportMetrics(options.metrics_format);
+        }
+        return status;
+    } catch (const std::exception& e) {
+        cerr << e.what() << endl;
+        return 1;
+    }
+}
@@ -0,0 +1,143 @@
+#ifndef GAME_EVENTS_INC
+#define GAME_EVENTS_INC
+// Includes
+#include "Auxiliaries.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * The events a game emits as its commands change it.
+     * Coordinates are those of the cells at the time of the event, and every
+     * health and ammo is the value after the event.
+     */
+
+    /* A character lost health to an attack. splash is set for the splash hits of a soldier */
+    struct DamageEvent
+    {
+        GridPoint attacker;
+        GridPoint target;
+        units_t amount;
+        units_t health;
+        bool splash;
+    };
+
+    /* A medic healed a character of its own team */
+    struct HealEvent
+    {
+        GridPoint healer;
+        GridPoint target;
+        units_t amount;
+        units_t health;
+    };
+
+    /* A character died of its damage and was removed from the board */
+    struct DeathEvent
+    {
+        GridPoint coordinates;
+        CharacterType type;
+        Team team;
+    };
+
+    /* A character moved from src to dst */
+    struct MoveEvent
+    {
+        GridPoint src;
+        GridPoint dst;
+        CharacterType type;
+        Team team;
+    };
+
+    /* A character reloaded */
+    struct ReloadEvent
+    {
+        GridPoint coordinates;
+        units_t ammo;
+    };
+
+    /*
+     * Class: GameEventListener
+     * ---------------------------------------
+     * Receives the events of the game it is attached to (see Game::attachListener).
+     * Each method does nothing unless overridden. They are called in the middle
+     * of a command, so they must not throw, and must not change the game.
+     */
+    class GameEventListener
+    {
+    public:
+        virtual ~GameEventListener() = default;
+        virtual void onDamage(const DamageEvent&) noexcept { }
+        virtual void onHeal(const HealEvent&) noexcept { }
+        virtual void onDeath(const DeathEvent&) noexcept { }
+        virtual void onMove(const MoveEvent&) noexcept { }
+        virtual void onReload(const ReloadEvent&) noexcept { }
+    };
+
+    /*
+     * Class: NullEventSink, ListenerEventSink
+     * ---------------------------------------
+     * Where a game sends its events. The game only builds an event when
+     * active() is true, so with the NullEventSink, whose active() is a constant
+     * false, the compiler removes the events from the game entirely.
+     * The ListenerEventSink forwards the events to the attached listener, if any.
+     *
+     * GameEventSink is the ListenerEventSink in builds that define
+     * MTM_GAME_EVENTS, and the NullEventSink otherwise.
+     */
+    class NullEventSink
+    {
+    public:
+        static const bool ENABLED = false;
+        void attach(GameEventListener*) noexcept { }
+        constexpr bool active() const noexcept
+        {
+            return false;
+        }
+        template<typename Event>
+        void emit(const Event&) const noexcept { }
+    };
+
+    class ListenerEventSink
+    {
+    private:
+        GameEventListener* listener;
+    public:
+        static const bool ENABLED = true;
+        ListenerEventSink() : listener(nullptr) { }
+        void attach(GameEventListener* new_listener) noexcept
+        {
+            listener = new_listener;
+        }
+        bool active() const noexcept
+        {
+            return listener != nullptr;
+        }
+        void emit(const DamageEvent& event) const noexcept
+        {
+            listener->onDamage(event);
+        }
+        void emit(const HealEvent& event) const noexcept
+        {
+            listener->onHeal(event);
+        }
+        void emit(const DeathEvent& event) const noexcept
+        {
+            listener->onDeath(event);
+        }
+        void emit(const MoveEvent& event) const noexcept
+        {
+            listener->onMove(event);
+        }
+        void emit(const ReloadEvent& event) const noexcept
+        {
+            listener->onReload(event);
+        }
+    };
+
+#if defined(MTM_GAME_EVENTS)
+    typedef ListenerEventSink GameEventSink;
+#else
+    typedef NullEventSink GameEventSink;
+#endif
+}
+#endif
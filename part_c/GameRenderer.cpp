@@ -0,0 +1,154 @@
+#include <new>
+#include "GameRenderer.h"
+#include "Game.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        const char CLEAR_SCREEN[] = "\x1b[H\x1b[2J";    /* Cursor home, then erase the screen */
+        const char BORDER = '*';
+        const char SEPARATOR = '|';
+    }
+
+    /***************************************/
+    /*     Ctors implementation section    */
+    /***************************************/
+    GameRenderer::GameRenderer() : height(0), width(0), full_redraw(true)
+    {
+
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    int GameRenderer::render(const Game& game, std::ostream& out)
+    {
+        frame.clear();
+        int drawn = 0;
+        if(full_redraw)
+        {
+            drawBoard(game);
+            drawn = height * width;
+        }
+        else
+        {
+            for(const GridPoint& cell : dirty)
+            {
+                size_t index = static_cast<size_t>(cell.row) * width + cell.col;
+                is_dirty[index] = false;
+                char symbol = game.cellSymbol(cell.row, cell.col);
+                if(symbol != shown[index])
+                {
+                    // The board starts below the top border, with a separator before every cell
+                    appendCursor(cell.row + 2, 2 * cell.col + 2);
+                    frame += symbol;
+                    shown[index] = symbol;
+                    drawn++;
+                }
+            }
+            if(drawn > 0)
+            {
+                appendCursor(height + 3, 1); // Park the cursor below the board
+            }
+        }
+        dirty.clear();
+        out.write(frame.data(), frame.size());
+        out.flush();
+        return drawn;
+    }
+
+    void GameRenderer::invalidate() noexcept
+    {
+        full_redraw = true;
+    }
+
+    /* Private Methods */
+    void GameRenderer::appendCursor(int row, int col)
+    {
+        // ESC [ row ; col H, with 1-based coordinates
+        frame += "\x1b[";
+        appendNumber(row);
+        frame += ';';
+        appendNumber(col);
+        frame += 'H';
+    }
+
+    void GameRenderer::appendNumber(int value)
+    {
+        char digits[16];
+        int length = 0;
+        do
+        {
+            digits[length++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while(value > 0);
+        while(length > 0)
+        {
+            frame += digits[--length];
+        }
+    }
+
+    void GameRenderer::drawBoard(const Game& game)
+    {
+        frame.reserve(sizeof(CLEAR_SCREEN) + static_cast<size_t>(height + 2) * (2 * width + 2));
+        frame += CLEAR_SCREEN;
+        frame.append(2 * width + 1, BORDER);
+        frame += '\n';
+        for(int row = 0; row < height; row++)
+        {
+            for(int col = 0; col < width; col++)
+            {
+                char symbol = game.cellSymbol(row, col);
+                shown[static_cast<size_t>(row) * width + col] = symbol;
+                frame += SEPARATOR;
+                frame += symbol;
+            }
+            frame += SEPARATOR;
+            frame += '\n';
+        }
+        frame.append(2 * width + 1, BORDER);
+        frame += '\n';
+        for(const GridPoint& cell : dirty)
+        {
+            is_dirty[static_cast<size_t>(cell.row) * width + cell.col] = false;
+        }
+        full_redraw = false;
+    }
+
+    void GameRenderer::reset(int height, int width)
+    {
+        size_t cells = static_cast<size_t>(height) * width;
+        shown.assign(cells, '\0');
+        is_dirty.assign(cells, false);
+        dirty.clear();
+        this->height = height;
+        this->width = width;
+        full_redraw = true;
+    }
+
+    void GameRenderer::markDirty(const GridPoint& cell) noexcept
+    {
+        if(full_redraw)
+        {
+            return; // The next frame draws every cell anyway
+        }
+        unsigned char& flag = is_dirty[static_cast<size_t>(cell.row) * width + cell.col];
+        if(flag)
+        {
+            return;
+        }
+        try
+        {
+            dirty.push_back(cell);
+            flag = true;
+        }
+        catch(const std::bad_alloc&)
+        {
+            full_redraw = true;
+        }
+    }
+}
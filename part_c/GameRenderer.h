@@ -0,0 +1,104 @@
+#ifndef GAME_RENDERER_INC
+#define GAME_RENDERER_INC
+// Includes
+#include <iostream>
+#include <string>
+#include <vector>
+#include "Auxiliaries.h"
+//---------
+
+namespace mtm
+{
+    class Game;
+
+    /*
+     * Class: GameRenderer
+     * ---------------------------------------
+     * Draws a game to an ANSI terminal, redrawing only what changed.
+     * Once attached to a game (see Game::attachRenderer), the renderer is told
+     * about every cell the game changes. A frame then moves the cursor to each
+     * changed cell whose symbol differs from the one on the screen, and writes
+     * the new symbol, so its cost is proportional to the changes since the
+     * previous frame and not to the size of the board.
+     * A frame is built in a reused buffer and written to the stream in a single
+     * write, followed by a single flush.
+     * The first frame (and the first one after invalidate) clears the screen
+     * and draws the whole board, in the layout of operator<<(ostream&, Game&).
+     * The renderer keeps two bytes per cell of the board.
+     */
+    class GameRenderer
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        /* Instance variables */
+        int height;
+        int width;
+        std::vector<char> shown;                /* The symbol of every cell as the screen shows it */
+        std::vector<unsigned char> is_dirty;    /* Whether each cell is in dirty */
+        std::vector<GridPoint> dirty;           /* The cells changed since the previous frame */
+        std::string frame;
+        bool full_redraw;
+
+        /* Private Methods */
+        void appendCursor(int row, int col);
+        void appendNumber(int value);
+        void drawBoard(const Game& game);
+
+        /*
+         * Called by the game the renderer is attached to.
+         */
+        friend class Game;
+        void reset(int height, int width);
+        void markDirty(const GridPoint& cell) noexcept;
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: GameRenderer
+         * Usage: GameRenderer renderer;
+         * ---------------------------------------
+         * Creates a renderer that is not attached to any game.
+         */
+        GameRenderer();
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: render
+         * Usage: int drawn = renderer.render(game, std::cout);
+         * -----------------------------------
+         * Writes the next frame of game to out, and returns the number of cells
+         * it drew.
+         * ASSUMES: the renderer is attached to game.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        int render(const Game& game, std::ostream& out);
+
+        /*
+         * Method: invalidate
+         * Usage: renderer.invalidate();
+         * -----------------------------------
+         * Makes the next frame redraw the whole screen, as when the terminal was
+         * cleared or resized behind the renderer's back.
+         */
+        void invalidate() noexcept;
+
+        /*
+         * Method: lastFrameSize
+         * Usage: size_t bytes = renderer.lastFrameSize();
+         * -----------------------------------
+         * Returns the number of bytes the previous frame wrote.
+         */
+        size_t lastFrameSize() const noexcept
+        {
+            return frame.size();
+        }
+    };
+}
+#endif
@@ -0,0 +1,422 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include "GameSearch.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        const int INFINITE_SCORE = 2000000000;
+        const int CHARACTER_BONUS = 10;         /* The evaluation of a surviving character, on top of its health */
+        const double EXPLORATION = 1.4;         /* The UCT exploration constant */
+        const double EVALUATION_SCALE = 10.0;   /* Maps evaluations of unfinished playouts to win chances */
+        const int ATTACK_ATTEMPTS = 4;          /* Random draws a playout makes looking for an attack */
+
+        Team opponent(Team team)
+        {
+            return (team == CPP)? PYTHON : CPP;
+        }
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    GameSearch::GameSearch(const Game& game, Team team) :
+    state(game), team(team), table(nullptr), nodes(0), next_check(0), aborted(false)
+    {
+
+    }
+
+    SearchResult GameSearch::alphaBeta(const SearchLimits& limits)
+    {
+        if(limits.max_depth < 1)
+        {
+            throw IllegalArgument();
+        }
+        startSearch(limits);
+        if(static_cast<int>(ply_commands.size()) < limits.max_depth + 1)
+        {
+            ply_commands.resize(limits.max_depth + 1);
+        }
+        SearchResult result;
+        std::vector<Command> root;
+        generateLegal(team, root);
+        if(root.empty())
+        {
+            finishSearch(result);
+            return result;
+        }
+        result.found = true;
+        result.best = root.front();
+        for(int depth = 1; depth <= limits.max_depth; depth++)
+        {
+            int alpha = -INFINITE_SCORE;
+            int best_index = 0;
+            for(int i = 0; i < static_cast<int>(root.size()); i++)
+            {
+                make(root[i]);
+                int score = -negamax(depth - 1, 1, opponent(team), -INFINITE_SCORE, -alpha);
+                state.rollback();
+                if(aborted)
+                {
+                    break;
+                }
+                if(score > alpha)
+                {
+                    alpha = score;
+                    best_index = i;
+                }
+            }
+            if(aborted)
+            {
+                // A partial iteration can only be trusted when nothing better is known
+                if(depth == 1 && alpha > -INFINITE_SCORE)
+                {
+                    result.best = root[best_index];
+                    result.score = alpha;
+                }
+                break;
+            }
+            // Search the best command first on the next iteration, to prune more
+            std::rotate(root.begin(), root.begin() + best_index, root.begin() + best_index + 1);
+            result.best = root.front();
+            result.score = alpha;
+            result.depth = depth;
+            if(std::abs(alpha) >= WIN_SCORE - limits.max_depth)
+            {
+                break; // The outcome is forced, deeper iterations can not change it
+            }
+        }
+        finishSearch(result);
+        return result;
+    }
+
+    SearchResult GameSearch::monteCarlo(const SearchLimits& limits)
+    {
+        if(limits.time_budget_ms <= 0 && limits.max_nodes <= 0)
+        {
+            throw IllegalArgument();
+        }
+        startSearch(limits);
+        if(ply_commands.empty())
+        {
+            ply_commands.resize(1);
+        }
+        std::vector<Command>& buffer = ply_commands[0];
+        generator.seed(limits.seed);
+        tree.clear();
+        Node root = {Command(), -1, 0, 0, false, opponent(team), 0, 0};
+        tree.push_back(root);
+
+        SearchResult result;
+        if(state.isOver())
+        {
+            finishSearch(result);
+            return result;
+        }
+        // Stop early when the root turns out to have no legal command
+        while(!limitReached() && !(tree.front().expanded && tree.front().child_count == 0))
+        {
+            state.begin();
+            int node = 0;
+            Team side = team;
+            // Selection
+            while(tree[node].expanded && tree[node].child_count > 0)
+            {
+                node = selectChild(node);
+                make(tree[node].command);
+                state.commit(); // Keep the command in the iteration's transaction
+                side = opponent(side);
+            }
+            // Expansion
+            if(!tree[node].expanded && !state.isOver())
+            {
+                generateLegal(side, buffer);
+                tree[node].expanded = true;
+                tree[node].first_child = static_cast<int>(tree.size());
+                tree[node].child_count = static_cast<int>(buffer.size());
+                for(const Command& command : buffer)
+                {
+                    Node child = {command, node, 0, 0, false, side, 0, 0};
+                    tree.push_back(child);
+                }
+                if(!buffer.empty())
+                {
+                    node = tree[node].first_child +
+                        std::uniform_int_distribution<int>(0, tree[node].child_count - 1)(generator);
+                    make(tree[node].command);
+                    state.commit();
+                    side = opponent(side);
+                }
+            }
+            // Simulation and backpropagation
+            double value = rollout(side);
+            state.rollback();
+            for(int current = node; current != -1; current = tree[current].parent)
+            {
+                tree[current].visits++;
+                tree[current].reward += (tree[current].mover == team)? value : 1 - value;
+            }
+        }
+
+        const Node& root_node = tree.front();
+        int best = -1;
+        for(int child = root_node.first_child; child < root_node.first_child + root_node.child_count; child++)
+        {
+            if(best == -1 || tree[child].visits > tree[best].visits)
+            {
+                best = child;
+            }
+        }
+        if(best != -1)
+        {
+            result.found = true;
+            result.best = tree[best].command;
+            result.score = (tree[best].visits == 0)? 0 :
+                static_cast<int>(std::lround(1000 * tree[best].reward / tree[best].visits));
+        }
+        finishSearch(result);
+        return result;
+    }
+
+    void GameSearch::setTranspositionTable(TranspositionTable* table) noexcept
+    {
+        this->table = table;
+    }
+
+    int GameSearch::evaluate(const Game& game, Team team) noexcept
+    {
+        Team other = opponent(team);
+        return game.totalHealth(team) - game.totalHealth(other) +
+            CHARACTER_BONUS * (game.characterCount(team) - game.characterCount(other));
+    }
+
+    /* Private Methods */
+    void GameSearch::startSearch(const SearchLimits& limits)
+    {
+        this->limits = limits;
+        start = Clock::now();
+        nodes = 0;
+        next_check = CHECK_INTERVAL;
+        aborted = false;
+    }
+
+    bool GameSearch::limitReached()
+    {
+        if(aborted)
+        {
+            return true;
+        }
+        if(limits.max_nodes > 0 && nodes >= limits.max_nodes)
+        {
+            aborted = true;
+        }
+        else if(limits.time_budget_ms > 0 && nodes >= next_check)
+        {
+            next_check = nodes + CHECK_INTERVAL;
+            aborted = Clock::now() - start >= std::chrono::milliseconds(limits.time_budget_ms);
+        }
+        return aborted;
+    }
+
+    void GameSearch::finishSearch(SearchResult& result) const
+    {
+        result.nodes = nodes;
+        result.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    void GameSearch::generateLegal(Team side, std::vector<Command>& commands)
+    {
+        // Use the whole capacity of the buffer, and grow it only when it is too small
+        commands.resize(commands.capacity());
+        int count = state.legalCommands(side, commands.data(), static_cast<int>(commands.size()));
+        if(count > static_cast<int>(commands.size()))
+        {
+            commands.resize(count);
+            state.legalCommands(side, commands.data(), count);
+        }
+        commands.resize(count);
+    }
+
+    void GameSearch::make(const Command& command)
+    {
+        // Only legal commands are made, so the command always succeeds
+        CommandResult result = SUCCESS;
+        state.begin();
+        state.execute(&command, 1, &result);
+        nodes++;
+    }
+
+    int GameSearch::negamax(int depth, int ply, Team side, int alpha, int beta)
+    {
+        if(limitReached())
+        {
+            return 0;
+        }
+        Team winner = CPP;
+        if(state.isOver(&winner))
+        {
+            // Prefer the quickest win and the slowest loss
+            return (winner == side)? WIN_SCORE - ply : ply - WIN_SCORE;
+        }
+        if(depth == 0)
+        {
+            return evaluate(state, side);
+        }
+        std::uint64_t key = state.hash() ^ ZobristKeys::sideKey(side);
+        TranspositionTable::Entry entry;
+        bool hit = (table != nullptr) && table->probe(key, entry);
+        if(hit && entry.depth >= depth)
+        {
+            int score = fromTable(entry.score, ply);
+            if(entry.bound == TranspositionTable::EXACT ||
+                (entry.bound == TranspositionTable::LOWER && score >= beta) ||
+                (entry.bound == TranspositionTable::UPPER && score <= alpha))
+            {
+                return score;
+            }
+        }
+        std::vector<Command>& commands = ply_commands[ply];
+        generateLegal(side, commands);
+        if(hit && entry.has_command)
+        {
+            // Search the best command of an earlier visit first
+            for(Command& command : commands)
+            {
+                if(command.type == entry.command.type && command.src == entry.command.src &&
+                    command.dst == entry.command.dst)
+                {
+                    std::swap(command, commands.front());
+                    break;
+                }
+            }
+        }
+        int original_alpha = alpha;
+        int best = -INFINITE_SCORE;
+        int best_index = -1;
+        for(int i = 0; i < static_cast<int>(commands.size()); i++)
+        {
+            make(commands[i]);
+            int score = -negamax(depth - 1, ply + 1, opponent(side), -beta, -alpha);
+            state.rollback();
+            if(aborted)
+            {
+                return 0;
+            }
+            if(score > best)
+            {
+                best = score;
+                best_index = i;
+                alpha = std::max(alpha, score);
+                if(alpha >= beta)
+                {
+                    break;
+                }
+            }
+        }
+        if(best_index == -1)
+        {
+            best = -negamax(depth - 1, ply + 1, opponent(side), -beta, -alpha); // Pass the turn
+            if(aborted)
+            {
+                return 0;
+            }
+        }
+        if(table != nullptr)
+        {
+            entry.score = toTable(best, ply);
+            entry.depth = depth;
+            entry.bound = (best <= original_alpha)? TranspositionTable::UPPER :
+                            (best >= beta)? TranspositionTable::LOWER : TranspositionTable::EXACT;
+            entry.has_command = best_index != -1;
+            if(entry.has_command)
+            {
+                entry.command = commands[best_index];
+            }
+            table->store(key, entry);
+        }
+        return best;
+    }
+
+    int GameSearch::toTable(int score, int ply) noexcept
+    {
+        // Win scores count plies from the root; the table counts them from the stored position
+        if(score > WIN_SCORE - MAX_WIN_PLY)
+        {
+            return score + ply;
+        }
+        if(score < MAX_WIN_PLY - WIN_SCORE)
+        {
+            return score - ply;
+        }
+        return score;
+    }
+
+    int GameSearch::fromTable(int score, int ply) noexcept
+    {
+        if(score > WIN_SCORE - MAX_WIN_PLY)
+        {
+            return score - ply;
+        }
+        if(score < MAX_WIN_PLY - WIN_SCORE)
+        {
+            return score + ply;
+        }
+        return score;
+    }
+
+    int GameSearch::selectChild(int node) const
+    {
+        const Node& parent = tree[node];
+        double log_visits = std::log(static_cast<double>(std::max(1, parent.visits)));
+        int best = parent.first_child;
+        double best_value = -1;
+        for(int child = parent.first_child; child < parent.first_child + parent.child_count; child++)
+        {
+            if(tree[child].visits == 0)
+            {
+                return child;
+            }
+            double value = tree[child].reward / tree[child].visits +
+                            EXPLORATION * std::sqrt(log_visits / tree[child].visits);
+            if(value > best_value)
+            {
+                best_value = value;
+                best = child;
+            }
+        }
+        return best;
+    }
+
+    double GameSearch::rollout(Team side)
+    {
+        std::vector<Command>& commands = ply_commands[0];
+        Team winner = CPP;
+        for(int ply = 0; ply < limits.rollout_depth && !state.isOver(); ply++)
+        {
+            generateLegal(side, commands);
+            if(!commands.empty())
+            {
+                // Attacks would drown among the moves, so draw a few times looking for one
+                std::uniform_int_distribution<int> pick(0, static_cast<int>(commands.size()) - 1);
+                int choice = pick(generator);
+                for(int attempt = 1; attempt < ATTACK_ATTEMPTS && commands[choice].type != ATTACK; attempt++)
+                {
+                    choice = pick(generator);
+                }
+                make(commands[choice]);
+                state.commit(); // Keep the command in the iteration's transaction
+            }
+            side = opponent(side);
+        }
+        if(state.isOver(&winner))
+        {
+            return (winner == team)? 1 : 0;
+        }
+        return 1 / (1 + std::exp(-evaluate(state, team) / EVALUATION_SCALE));
+    }
+}
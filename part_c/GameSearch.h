@@ -0,0 +1,189 @@
+#ifndef GAME_SEARCH_INC
+#define GAME_SEARCH_INC
+// Includes
+#include <chrono>
+#include <random>
+#include <vector>
+#include "Auxiliaries.h"
+#include "Exceptions.h"
+#include "Command.h"
+#include "Game.h"
+#include "TranspositionTable.h"
+#include "Zobrist.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Struct: SearchLimits
+     * ---------------------------------------
+     * Bounds a single search. A search stops at the first limit it reaches;
+     * a zero time budget or node count means no limit of that kind.
+     */
+    struct SearchLimits
+    {
+        int max_depth = 6;                  /* Alpha-beta: the deepest iteration, in plies */
+        int time_budget_ms = 100;
+        long long max_nodes = 0;            /* Commands applied while searching */
+        int rollout_depth = 24;             /* MCTS: the plies of each random playout */
+        unsigned long long seed = 0;        /* MCTS: seeds the random choices */
+    };
+
+    /*
+     * Struct: SearchResult
+     * ---------------------------------------
+     * The outcome of a search.
+     * score is from the searching team's point of view: the evaluation of the
+     * principal line for alpha-beta, and the expected result in thousandths
+     * (0 is a sure loss, 1000 a sure win) for MCTS.
+     */
+    struct SearchResult
+    {
+        bool found = false;                 /* false if the team has no legal command */
+        Command best;
+        int score = 0;
+        int depth = 0;                      /* Alpha-beta: the deepest completed iteration */
+        long long nodes = 0;
+        double seconds = 0;
+    };
+
+    /*
+     * Class: GameSearch
+     * ---------------------------------------
+     * Picks a command for a team by searching the tree of the future states of
+     * a game, where the teams take turns applying a single command.
+     * The search works on a private copy of the game, and makes and unmakes
+     * commands with the game's transactions (begin / execute / rollback), so
+     * visiting a node costs time proportional to the changes of its command,
+     * and never to the size of the board.
+     */
+    class GameSearch
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        typedef std::chrono::steady_clock Clock;
+        static const int WIN_SCORE = 1000000;
+        static const int MAX_WIN_PLY = 10000;       /* Scores this close to WIN_SCORE are wins */
+        static const int CHECK_INTERVAL = 256;      /* Nodes between two limit checks */
+
+        /*
+         * A node of the MCTS tree. reward accumulates the results from the point
+         * of view of the team that applied command.
+         */
+        struct Node
+        {
+            Command command;
+            int parent;
+            int first_child;
+            int child_count;
+            bool expanded;
+            Team mover;
+            int visits;
+            double reward;
+        };
+
+        /* Instance variables */
+        Game state;
+        Team team;
+        TranspositionTable* table;                          /* Shared with other searches, if set */
+        std::vector<std::vector<Command>> ply_commands;     /* Reused candidate buffers, one per ply */
+        std::vector<GridPoint> own_positions;
+        std::vector<GridPoint> other_positions;
+        std::vector<Node> tree;
+        std::mt19937_64 generator;
+        SearchLimits limits;
+        Clock::time_point start;
+        long long nodes;
+        long long next_check;                       /* The node count of the next time check */
+        bool aborted;
+
+        /* Private Methods */
+        void startSearch(const SearchLimits& limits);
+        bool limitReached();
+        void finishSearch(SearchResult& result) const;
+        void generateLegal(Team side, std::vector<Command>& commands);
+        void make(const Command& command);
+        int negamax(int depth, int ply, Team side, int alpha, int beta);
+        static int toTable(int score, int ply) noexcept;
+        static int fromTable(int score, int ply) noexcept;
+        int selectChild(int node) const;
+        double rollout(Team side);
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: GameSearch
+         * Usage: GameSearch search(game, team);
+         * ---------------------------------------
+         * Prepares a search for the best command of team in the current state of game.
+         * Later changes to game do not affect the search.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        GameSearch(const Game& game, Team team);
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: setTranspositionTable
+         * Usage: search.setTranspositionTable(&table);
+         * -----------------------------------
+         * Makes alphaBeta cache its results in table, keyed by the position hash
+         * and the team to play, and reuse them when it reaches the same
+         * position again. table must outlive its use, and may be shared by
+         * searches running on other threads. Pass nullptr to stop using it.
+         * As positions that only differ in large health or ammo values share a
+         * hash, a cached result may stand for a slightly different position.
+         */
+        void setTranspositionTable(TranspositionTable* table) noexcept;
+
+        /*
+         * Method: alphaBeta
+         * Usage: SearchResult result = search.alphaBeta(limits);
+         * -----------------------------------
+         * Runs an iterative-deepening negamax search with alpha-beta pruning,
+         * one ply deeper on every iteration, until limits.max_depth or another
+         * limit is reached. Returns the best command of the deepest completed
+         * iteration (or of the interrupted first iteration).
+         * A team that has no legal command passes its turn.
+         *
+         * Possible exceptions:
+         * IllegalArgument if limits.max_depth is lower than 1.
+         * std::bad_alloc
+         */
+        SearchResult alphaBeta(const SearchLimits& limits);
+
+        /*
+         * Method: monteCarlo
+         * Usage: SearchResult result = search.monteCarlo(limits);
+         * -----------------------------------
+         * Runs a Monte Carlo tree search (UCT) until the time budget or the node
+         * count is exhausted. Every iteration ends with a random playout of
+         * limits.rollout_depth plies, and an unfinished playout is scored by
+         * evaluate(). Returns the most visited command of the root.
+         *
+         * Possible exceptions:
+         * IllegalArgument if neither a time budget nor a node count is set.
+         * std::bad_alloc
+         */
+        SearchResult monteCarlo(const SearchLimits& limits);
+
+        /**************************************/
+        /*    Function definition section     */
+        /**************************************/
+        /*
+         * Function: evaluate
+         * Usage: int score = GameSearch::evaluate(game, team);
+         * -----------------------------------
+         * Returns a static evaluation of game from the point of view of team:
+         * the difference in health, plus a bonus for each surviving character.
+         */
+        static int evaluate(const Game& game, Team team) noexcept;
+    };
+}
+#endif
@@ -0,0 +1,326 @@
+#include <cmath>
+#include <iomanip>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include "Instrumentation.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        const char* COUNTER_NAMES[COUNTER_COUNT] = {
+            "add_commands", "move_commands", "attack_commands", "reload_commands",
+            "illegal_argument_exceptions", "illegal_cell_exceptions", "cell_empty_exceptions",
+            "move_too_far_exceptions", "cell_occupied_exceptions", "out_of_range_exceptions",
+            "out_of_ammo_exceptions", "illegal_target_exceptions",
+            "matrix_allocations", "matrix_copies", "cells_scanned"
+        };
+
+        const char* OPERATION_NAMES[TIMED_OPERATION_COUNT] = {
+            "add_character", "move", "attack", "reload", "execute", "legal_commands"
+        };
+
+        /* The percentiles the dumps show, and their names */
+        const double PERCENTILES[] = {50, 90, 99, 99.9};
+        const char* PERCENTILE_NAMES[] = {"p50", "p90", "p99", "p99.9"};
+        const int PERCENTILE_COUNT = 4;
+    }
+
+    /***************************************/
+    /*           LatencyHistogram          */
+    /***************************************/
+    LatencyHistogram::LatencyHistogram() : counts(), total(0), sum(0)
+    {
+
+    }
+
+    std::uint64_t LatencyHistogram::lowestValue(int bucket) noexcept
+    {
+        if(bucket < 2 * SUB_BUCKETS)
+        {
+            return static_cast<std::uint64_t>(bucket);
+        }
+        int shift = bucket / SUB_BUCKETS - 1;
+        return static_cast<std::uint64_t>(bucket % SUB_BUCKETS + SUB_BUCKETS) << shift;
+    }
+
+    std::uint64_t LatencyHistogram::highestValue(int bucket) noexcept
+    {
+        if(bucket < 2 * SUB_BUCKETS)
+        {
+            return static_cast<std::uint64_t>(bucket);
+        }
+        int shift = bucket / SUB_BUCKETS - 1;
+        return lowestValue(bucket) + (1ULL << shift) - 1;
+    }
+
+    void LatencyHistogram::record(std::uint64_t value, std::uint64_t count) noexcept
+    {
+        counts[bucketOf(value)] += count;
+        total += count;
+        sum += value * count;
+    }
+
+    void LatencyHistogram::add(const LatencyHistogram& other) noexcept
+    {
+        for(int bucket = 0; bucket < BUCKETS; bucket++)
+        {
+            counts[bucket] += other.counts[bucket];
+        }
+        total += other.total;
+        sum += other.sum;
+    }
+
+    void LatencyHistogram::reset() noexcept
+    {
+        *this = LatencyHistogram();
+    }
+
+    std::uint64_t LatencyHistogram::count() const noexcept
+    {
+        return total;
+    }
+
+    double LatencyHistogram::mean() const noexcept
+    {
+        return (total == 0)? 0 : static_cast<double>(sum) / total;
+    }
+
+    std::uint64_t LatencyHistogram::minimum() const noexcept
+    {
+        for(int bucket = 0; bucket < BUCKETS; bucket++)
+        {
+            if(counts[bucket] > 0)
+            {
+                return lowestValue(bucket);
+            }
+        }
+        return 0;
+    }
+
+    std::uint64_t LatencyHistogram::maximum() const noexcept
+    {
+        for(int bucket = BUCKETS - 1; bucket >= 0; bucket--)
+        {
+            if(counts[bucket] > 0)
+            {
+                return highestValue(bucket);
+            }
+        }
+        return 0;
+    }
+
+    std::uint64_t LatencyHistogram::percentile(double percentage) const noexcept
+    {
+        if(total == 0)
+        {
+            return 0;
+        }
+        // The rank of the value, counting from 1
+        std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(percentage / 100 * total));
+        rank = (rank == 0)? 1 : rank;
+        std::uint64_t seen = 0;
+        for(int bucket = 0; bucket < BUCKETS; bucket++)
+        {
+            seen += counts[bucket];
+            if(seen >= rank)
+            {
+                return highestValue(bucket);
+            }
+        }
+        return maximum();
+    }
+
+    /***************************************/
+    /*       InstrumentationSnapshot       */
+    /***************************************/
+    const char* InstrumentationSnapshot::counterName(Counter counter) noexcept
+    {
+        return COUNTER_NAMES[counter];
+    }
+
+    const char* InstrumentationSnapshot::operationName(TimedOperation operation) noexcept
+    {
+        return OPERATION_NAMES[operation];
+    }
+
+    std::string InstrumentationSnapshot::toText() const
+    {
+        std::ostringstream out;
+        out << "Counters" << std::endl;
+        for(int counter = 0; counter < COUNTER_COUNT; counter++)
+        {
+            out << "  " << std::left << std::setw(28) << COUNTER_NAMES[counter] << std::right
+                << std::setw(14) << counters[counter] << std::endl;
+        }
+        out << "Latencies (ns)  " << std::setw(12) << "count" << std::setw(10) << "mean" << std::setw(10) << "min";
+        for(int i = 0; i < PERCENTILE_COUNT; i++)
+        {
+            out << std::setw(10) << PERCENTILE_NAMES[i];
+        }
+        out << std::setw(10) << "max" << std::endl;
+        for(int operation = 0; operation < TIMED_OPERATION_COUNT; operation++)
+        {
+            const LatencyHistogram& latency = latencies[operation];
+            out << "  " << std::left << std::setw(14) << OPERATION_NAMES[operation] << std::right
+                << std::setw(12) << latency.count() << std::setw(10) << std::llround(latency.mean())
+                << std::setw(10) << latency.minimum();
+            for(int i = 0; i < PERCENTILE_COUNT; i++)
+            {
+                out << std::setw(10) << latency.percentile(PERCENTILES[i]);
+            }
+            out << std::setw(10) << latency.maximum() << std::endl;
+        }
+        return out.str();
+    }
+
+    std::string InstrumentationSnapshot::toJson() const
+    {
+        std::ostringstream out;
+        out << "{\"counters\":{";
+        for(int counter = 0; counter < COUNTER_COUNT; counter++)
+        {
+            out << ((counter == 0)? "" : ",") << '"' << COUNTER_NAMES[counter] << "\":" << counters[counter];
+        }
+        out << "},\"latencies_ns\":{";
+        for(int operation = 0; operation < TIMED_OPERATION_COUNT; operation++)
+        {
+            const LatencyHistogram& latency = latencies[operation];
+            out << ((operation == 0)? "" : ",") << '"' << OPERATION_NAMES[operation] << "\":{"
+                << "\"count\":" << latency.count() << ",\"mean\":" << std::llround(latency.mean())
+                << ",\"min\":" << latency.minimum();
+            for(int i = 0; i < PERCENTILE_COUNT; i++)
+            {
+                out << ",\"" << PERCENTILE_NAMES[i] << "\":" << latency.percentile(PERCENTILES[i]);
+            }
+            out << ",\"max\":" << latency.maximum() << '}';
+        }
+        out << "}}";
+        return out.str();
+    }
+
+    /***************************************/
+    /*        ActiveInstrumentation        */
+    /***************************************/
+    thread_local ActiveInstrumentation::ThreadMetrics* ActiveInstrumentation::metrics = nullptr;
+
+    ActiveInstrumentation::ThreadMetrics::ThreadMetrics() : next(nullptr)
+    {
+        zero(*this);
+    }
+
+    ActiveInstrumentation::ThreadMetrics* ActiveInstrumentation::registerThread() noexcept
+    {
+        static thread_local ThreadRetirer retirer;
+        ThreadMetrics* thread_metrics = new(std::nothrow) ThreadMetrics();
+        std::lock_guard<std::mutex> guard(registryLock());
+        if(thread_metrics == nullptr)
+        {
+            // Count into the shared retired set, which may lose counts but never fails
+            return &retired();
+        }
+        thread_metrics->next = retired().next;
+        retired().next = thread_metrics;
+        return thread_metrics;
+    }
+
+    ActiveInstrumentation::ThreadRetirer::~ThreadRetirer()
+    {
+        ThreadMetrics* thread_metrics = metrics;
+        metrics = nullptr;
+        if(thread_metrics == nullptr || thread_metrics == &retired())
+        {
+            return;
+        }
+        std::lock_guard<std::mutex> guard(registryLock());
+        ThreadMetrics& total = retired();
+        for(int counter = 0; counter < COUNTER_COUNT; counter++)
+        {
+            increase(total.counters[counter], thread_metrics->counters[counter].load(std::memory_order_relaxed));
+        }
+        for(int operation = 0; operation < TIMED_OPERATION_COUNT; operation++)
+        {
+            for(int bucket = 0; bucket < LatencyHistogram::BUCKETS; bucket++)
+            {
+                increase(total.buckets[operation][bucket],
+                    thread_metrics->buckets[operation][bucket].load(std::memory_order_relaxed));
+            }
+            increase(total.sums[operation], thread_metrics->sums[operation].load(std::memory_order_relaxed));
+        }
+        ThreadMetrics* previous = &total;
+        while(previous->next != thread_metrics)
+        {
+            previous = previous->next;
+        }
+        previous->next = thread_metrics->next;
+        delete thread_metrics;
+    }
+
+    std::mutex& ActiveInstrumentation::registryLock() noexcept
+    {
+        static std::mutex* lock = new std::mutex();
+        return *lock;
+    }
+
+    ActiveInstrumentation::ThreadMetrics& ActiveInstrumentation::retired() noexcept
+    {
+        static ThreadMetrics* total = new ThreadMetrics();
+        return *total;
+    }
+
+    void ActiveInstrumentation::zero(ThreadMetrics& thread_metrics) noexcept
+    {
+        for(int counter = 0; counter < COUNTER_COUNT; counter++)
+        {
+            thread_metrics.counters[counter].store(0, std::memory_order_relaxed);
+        }
+        for(int operation = 0; operation < TIMED_OPERATION_COUNT; operation++)
+        {
+            for(int bucket = 0; bucket < LatencyHistogram::BUCKETS; bucket++)
+            {
+                thread_metrics.buckets[operation][bucket].store(0, std::memory_order_relaxed);
+            }
+            thread_metrics.sums[operation].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    InstrumentationSnapshot ActiveInstrumentation::snapshot()
+    {
+        InstrumentationSnapshot snapshot;
+        std::lock_guard<std::mutex> guard(registryLock());
+        // The retired set heads the list of the live ones
+        for(const ThreadMetrics* thread_metrics = &retired(); thread_metrics != nullptr;
+            thread_metrics = thread_metrics->next)
+        {
+            for(int counter = 0; counter < COUNTER_COUNT; counter++)
+            {
+                snapshot.counters[counter] += thread_metrics->counters[counter].load(std::memory_order_relaxed);
+            }
+            for(int operation = 0; operation < TIMED_OPERATION_COUNT; operation++)
+            {
+                LatencyHistogram& latency = snapshot.latencies[operation];
+                for(int bucket = 0; bucket < LatencyHistogram::BUCKETS; bucket++)
+                {
+                    std::uint64_t count = thread_metrics->buckets[operation][bucket].load(std::memory_order_relaxed);
+                    latency.counts[bucket] += count;
+                    latency.total += count;
+                }
+                latency.sum += thread_metrics->sums[operation].load(std::memory_order_relaxed);
+            }
+        }
+        return snapshot;
+    }
+
+    void ActiveInstrumentation::reset() noexcept
+    {
+        std::lock_guard<std::mutex> guard(registryLock());
+        for(ThreadMetrics* thread_metrics = &retired(); thread_metrics != nullptr; thread_metrics = thread_metrics->next)
+        {
+            zero(*thread_metrics);
+        }
+    }
+}
@@ -0,0 +1,343 @@
+#ifndef INSTRUMENTATION_INC
+#define INSTRUMENTATION_INC
+// Includes
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+//---------
+
+namespace mtm
+{
+    /*
+     * The events the instrumentation counts.
+     * The *_EXCEPTIONS counters count the exceptions of Exceptions.h constructed,
+     * CELLS_SCANNED counts the board cells read by scans (printing, rendering,
+     * legal move generation, splash damage and the search for casualties).
+     */
+    enum Counter
+    {
+        ADD_COMMANDS, MOVE_COMMANDS, ATTACK_COMMANDS, RELOAD_COMMANDS,
+        ILLEGAL_ARGUMENT_EXCEPTIONS, ILLEGAL_CELL_EXCEPTIONS, CELL_EMPTY_EXCEPTIONS, MOVE_TOO_FAR_EXCEPTIONS,
+        CELL_OCCUPIED_EXCEPTIONS, OUT_OF_RANGE_EXCEPTIONS, OUT_OF_AMMO_EXCEPTIONS, ILLEGAL_TARGET_EXCEPTIONS,
+        MATRIX_ALLOCATIONS, MATRIX_COPIES, CELLS_SCANNED,
+        COUNTER_COUNT
+    };
+
+    /* The Game methods whose latency is measured, each with the throwing form that calls it */
+    enum TimedOperation
+    {
+        ADD_CHARACTER_CALL, MOVE_CALL, ATTACK_CALL, RELOAD_CALL, EXECUTE_CALL, LEGAL_COMMANDS_CALL,
+        TIMED_OPERATION_COUNT
+    };
+
+    /*
+     * Class: LatencyHistogram
+     * ---------------------------------------
+     * A histogram of latencies in nanoseconds, in the layout of an HDR histogram:
+     * values below 2 * SUB_BUCKETS have a bucket each, and every further power
+     * of two is split into SUB_BUCKETS buckets, so any value is known to within
+     * 1 / SUB_BUCKETS (about 3%) over the whole range, in a fixed BUCKETS counts.
+     * Values above MAX_VALUE (about 18 minutes) are recorded as MAX_VALUE.
+     */
+    class LatencyHistogram
+    {
+    public:
+        static const int SUB_BUCKET_BITS = 5;
+        static const int SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+        static const int VALUE_BITS = 40;
+        static const std::uint64_t MAX_VALUE = (1ULL << VALUE_BITS) - 1;
+        static const int BUCKETS = (VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        /* Instance variables */
+        std::uint64_t counts[BUCKETS];
+        std::uint64_t total;
+        std::uint64_t sum;
+
+        static int highestBit(std::uint64_t value) noexcept
+        {
+#if defined(__GNUC__)
+            return 63 - __builtin_clzll(value);
+#else
+            int bit = 0;
+            while(value >>= 1)
+            {
+                bit++;
+            }
+            return bit;
+#endif
+        }
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: LatencyHistogram
+         * Usage: LatencyHistogram histogram;
+         * ---------------------------------------
+         * Creates an empty histogram.
+         */
+        LatencyHistogram();
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Function: bucketOf, lowestValue, highestValue
+         * Usage: int bucket = LatencyHistogram::bucketOf(nanoseconds);
+         * -----------------------------------
+         * Return the bucket a value is counted in, and the range of values
+         * the bucket holds.
+         */
+        static int bucketOf(std::uint64_t value) noexcept
+        {
+            if(value > MAX_VALUE)
+            {
+                value = MAX_VALUE;
+            }
+            if(value < 2 * SUB_BUCKETS)
+            {
+                return static_cast<int>(value);
+            }
+            int shift = highestBit(value) - SUB_BUCKET_BITS;
+            return (shift + 1) * SUB_BUCKETS + static_cast<int>(value >> shift) - SUB_BUCKETS;
+        }
+        static std::uint64_t lowestValue(int bucket) noexcept;
+        static std::uint64_t highestValue(int bucket) noexcept;
+
+        /*
+         * Method: record, add, reset
+         * Usage: histogram.record(nanoseconds);
+         *        total.add(histogram);
+         * -----------------------------------
+         * record counts value count times, add counts every value of other,
+         * and reset empties the histogram.
+         */
+        void record(std::uint64_t value, std::uint64_t count = 1) noexcept;
+        void add(const LatencyHistogram& other) noexcept;
+        void reset() noexcept;
+
+        /*
+         * Method: count, mean, minimum, maximum, percentile
+         * Usage: std::uint64_t p99 = histogram.percentile(99);
+         * -----------------------------------
+         * Return the number of values recorded and statistics of them.
+         * mean is exact, and the others are the highest value of the bucket
+         * they fall in (minimum the lowest). All return 0 for an empty histogram.
+         * percentile takes a percentage in [0, 100].
+         */
+        std::uint64_t count() const noexcept;
+        double mean() const noexcept;
+        std::uint64_t minimum() const noexcept;
+        std::uint64_t maximum() const noexcept;
+        std::uint64_t percentile(double percentage) const noexcept;
+
+        /*
+         * Method: bucketCount
+         * Usage: std::uint64_t count = histogram.bucketCount(bucket);
+         * -----------------------------------
+         * Returns the number of values counted in the given bucket.
+         */
+        std::uint64_t bucketCount(int bucket) const noexcept
+        {
+            return counts[bucket];
+        }
+        friend class ActiveInstrumentation;
+    };
+
+    /*
+     * Struct: InstrumentationSnapshot
+     * ---------------------------------------
+     * The counters and latencies of every thread, summed, at one point in time.
+     */
+    struct InstrumentationSnapshot
+    {
+        std::uint64_t counters[COUNTER_COUNT];
+        LatencyHistogram latencies[TIMED_OPERATION_COUNT];
+
+        InstrumentationSnapshot() : counters(), latencies() { }
+
+        /*
+         * Function: counterName, operationName
+         * Usage: const char* name = InstrumentationSnapshot::counterName(CELLS_SCANNED);
+         * -----------------------------------
+         * Return the names the dumps use, such as "cells_scanned" and "move".
+         */
+        static const char* counterName(Counter counter) noexcept;
+        static const char* operationName(TimedOperation operation) noexcept;
+
+        /*
+         * Method: toText, toJson
+         * Usage: std::cout << snapshot.toText();
+         * -----------------------------------
+         * Return a dump of the counters and of the latencies of every operation
+         * (count, mean, min, p50, p90, p99, p99.9 and max, in nanoseconds), as
+         * aligned text or as a single-line JSON object.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        std::string toText() const;
+        std::string toJson() const;
+    };
+
+    /*
+     * Class: ActiveInstrumentation, NullInstrumentation
+     * ---------------------------------------
+     * Where the game and the matrices report what they do.
+     * Every thread counts into a set of counters and histograms of its own,
+     * so counting is a load and a store, with no lock and no contention.
+     * snapshot sums the sets of all the threads (and of the threads that
+     * exited), and reset zeroes them; counts a thread makes while they read
+     * may or may not be included, and may be lost by a reset.
+     * Timer measures the lifetime of its scope, and records it to the
+     * histogram of an operation.
+     *
+     * The NullInstrumentation does nothing, and its snapshot is all zeros.
+     * Instrumentation is the ActiveInstrumentation in builds that define
+     * MTM_INSTRUMENTATION, and the NullInstrumentation otherwise, so that the
+     * instrumentation is compiled out of other builds entirely.
+     */
+    class ActiveInstrumentation
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        struct ThreadMetrics
+        {
+            std::atomic<std::uint64_t> counters[COUNTER_COUNT];
+            std::atomic<std::uint64_t> buckets[TIMED_OPERATION_COUNT][LatencyHistogram::BUCKETS];
+            std::atomic<std::uint64_t> sums[TIMED_OPERATION_COUNT];
+            ThreadMetrics* next;
+
+            ThreadMetrics();
+        };
+
+        /* Hands the set of a thread over to the retired set when the thread exits */
+        struct ThreadRetirer
+        {
+            ~ThreadRetirer();
+        };
+
+        /* Class variables */
+        static thread_local ThreadMetrics* metrics;    /* The set of the calling thread */
+
+        /* Private Methods */
+        static ThreadMetrics* registerThread() noexcept;
+        static void zero(ThreadMetrics& thread_metrics) noexcept;
+
+        /*
+         * The sets of the live threads are listed after the retired set, which
+         * holds the sums of the threads that exited. Neither is ever destroyed,
+         * so threads can still count during static destruction.
+         */
+        static std::mutex& registryLock() noexcept;
+        static ThreadMetrics& retired() noexcept;
+        static ThreadMetrics& local() noexcept
+        {
+            if(metrics == nullptr)
+            {
+                metrics = registerThread();
+            }
+            return *metrics;
+        }
+
+        /* Only the owning thread writes to its set, so an increment need not be atomic */
+        static void increase(std::atomic<std::uint64_t>& value, std::uint64_t amount) noexcept
+        {
+            value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+    public:
+        static const bool ENABLED = true;
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Function: count, recordLatency
+         * Usage: Instrumentation::count(CELLS_SCANNED, cells);
+         *        Instrumentation::recordLatency(MOVE_CALL, nanoseconds);
+         * -----------------------------------
+         * Add amount to a counter of the calling thread, and a latency to the
+         * histogram of one of its operations.
+         */
+        static void count(Counter counter, std::uint64_t amount = 1) noexcept
+        {
+            increase(local().counters[counter], amount);
+        }
+        static void recordLatency(TimedOperation operation, std::uint64_t nanoseconds) noexcept
+        {
+            ThreadMetrics& local_metrics = local();
+            increase(local_metrics.buckets[operation][LatencyHistogram::bucketOf(nanoseconds)], 1);
+            increase(local_metrics.sums[operation], nanoseconds);
+        }
+
+        /*
+         * Function: snapshot, reset
+         * Usage: InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+         *        Instrumentation::reset();
+         * -----------------------------------
+         * snapshot returns the counters and latencies of all the threads so
+         * far, and reset starts them all over from zero.
+         */
+        static InstrumentationSnapshot snapshot();
+        static void reset() noexcept;
+
+        /*
+         * Class: Timer
+         * Usage: Instrumentation::Timer timer(MOVE_CALL);
+         * -----------------------------------
+         * Records the time from its construction to its destruction as a
+         * latency of operation.
+         */
+        class Timer
+        {
+        private:
+            TimedOperation operation;
+            std::chrono::steady_clock::time_point start;
+        public:
+            explicit Timer(TimedOperation operation) noexcept :
+            operation(operation), start(std::chrono::steady_clock::now()) { }
+            ~Timer()
+            {
+                std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - start;
+                recordLatency(operation, static_cast<std::uint64_t>(elapsed.count()));
+            }
+            Timer(const Timer&) = delete;
+            Timer& operator=(const Timer&) = delete;
+        };
+    };
+
+    class NullInstrumentation
+    {
+    public:
+        static const bool ENABLED = false;
+        static void count(Counter, std::uint64_t = 1) noexcept { }
+        static void recordLatency(TimedOperation, std::uint64_t) noexcept { }
+        static InstrumentationSnapshot snapshot()
+        {
+            return InstrumentationSnapshot();
+        }
+        static void reset() noexcept { }
+
+        class Timer
+        {
+        public:
+            explicit Timer(TimedOperation) noexcept { }
+            Timer(const Timer&) = delete;
+            Timer& operator=(const Timer&) = delete;
+        };
+    };
+
+#if defined(MTM_INSTRUMENTATION)
+    typedef ActiveInstrumentation Instrumentation;
+#else
+    typedef NullInstrumentation Instrumentation;
+#endif
+}
+#endif
@@ -0,0 +1,68 @@
+#include <fstream>
+#include <iterator>
+#include "MappedFile.h"
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define MTM_HAS_MMAP 1
+#endif
+
+namespace mtm
+{
+    /***************************************/
+    /*     Ctors implementation section    */
+    /***************************************/
+    MappedFile::MappedFile(const std::string& path) : contents(""), length(0), mapping(nullptr), buffer()
+    {
+#if defined(MTM_HAS_MMAP)
+        int descriptor = open(path.c_str(), O_RDONLY);
+        if(descriptor < 0)
+        {
+            throw OpenError(path);
+        }
+        struct stat status;
+        if(fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode))
+        {
+            close(descriptor);
+            throw OpenError(path);
+        }
+        length = static_cast<std::size_t>(status.st_size);
+        if(length > 0) // Empty files can not be mapped
+        {
+            void* pages = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, descriptor, 0);
+            if(pages == MAP_FAILED)
+            {
+                close(descriptor);
+                throw OpenError(path);
+            }
+            mapping = pages;
+            contents = static_cast<const char*>(pages);
+        }
+        close(descriptor); // The mapping keeps the file open
+#else
+        std::ifstream in(path.c_str(), std::ios::binary);
+        if(!in)
+        {
+            throw OpenError(path);
+        }
+        buffer.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        length = buffer.size();
+        if(length > 0)
+        {
+            contents = buffer.data();
+        }
+#endif
+    }
+
+    MappedFile::~MappedFile()
+    {
+#if defined(MTM_HAS_MMAP)
+        if(mapping != nullptr)
+        {
+            munmap(mapping, length);
+        }
+#endif
+    }
+}
@@ -0,0 +1,85 @@
+#ifndef MAPPED_FILE_INC
+#define MAPPED_FILE_INC
+// Includes
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "Exceptions.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: MappedFile
+     * ---------------------------------------
+     * The read-only contents of a file, as one contiguous range of bytes.
+     * On POSIX systems the file is memory-mapped, so opening it copies
+     * nothing, and its pages are read in by the kernel as they are touched.
+     * Elsewhere the file is read into memory.
+     */
+    class MappedFile
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        /* Instance variables */
+        const char* contents;
+        std::size_t length;
+        void* mapping;                  /* The mapped pages, if the file is mapped */
+        std::vector<char> buffer;       /* The contents, if the file is read */
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: MappedFile
+         * Usage: MappedFile file(path);
+         * ---------------------------------------
+         * Opens the file at path.
+         *
+         * Possible exceptions:
+         * MappedFile::OpenError, std::bad_alloc
+         */
+        explicit MappedFile(const std::string& path);
+        ~MappedFile();
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: data, size
+         * Usage: const char* bytes = file.data();
+         *        size_t length = file.size();
+         * -----------------------------------
+         * Return the contents of the file, and their length.
+         */
+        const char* data() const noexcept
+        {
+            return contents;
+        }
+        std::size_t size() const noexcept
+        {
+            return length;
+        }
+
+        /*********************************/
+        /*       Exception Section       */
+        /*********************************/
+        class OpenError : public Exception
+        {
+        private:
+            std::string message;
+        public:
+            explicit OpenError(const std::string& path) : message("Mtm file error: Can not read " + path) { }
+            virtual ~OpenError() = default;
+            const char* what() const noexcept override
+            {
+                return message.c_str();
+            }
+        };
+    };
+}
+#endif
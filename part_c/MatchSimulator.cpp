@@ -0,0 +1,330 @@
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include "MatchSimulator.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        const int CHARACTER_TYPES = sizeof(CHARACTER_TRAITS) / sizeof(CHARACTER_TRAITS[0]);
+
+        /* The smallest max_move_range of the character types from type on */
+        constexpr int minMoveRange(int type)
+        {
+            return (type == CHARACTER_TYPES - 1)? CHARACTER_TRAITS[type].max_move_range :
+                (CHARACTER_TRAITS[type].max_move_range < minMoveRange(type + 1))?
+                    CHARACTER_TRAITS[type].max_move_range : minMoveRange(type + 1);
+        }
+
+        /* The longest move every character type can make */
+        const int MIN_MOVE_RANGE = minMoveRange(0);
+
+        /*
+         * A queue of chunk indices owned by a single worker.
+         * The owner pops from the back and thieves pop from the front, so the two
+         * rarely contend for the same chunk.
+         */
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<int> chunks;
+        };
+
+        bool takeChunk(std::vector<WorkQueue>& queues, int self, int& chunk)
+        {
+            int count = static_cast<int>(queues.size());
+            for(int i = 0; i < count; i++)
+            {
+                WorkQueue& queue = queues[(self + i) % count];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if(queue.chunks.empty())
+                {
+                    continue;
+                }
+                if(i == 0)
+                {
+                    chunk = queue.chunks.back();
+                    queue.chunks.pop_back();
+                }
+                else
+                {
+                    chunk = queue.chunks.front();
+                    queue.chunks.pop_front();
+                }
+                return true;
+            }
+            return false; // No chunk is ever added back, so every queue stays empty from now on
+        }
+
+        /*
+         * SplitMix64 finalizer: spreads consecutive match indices over unrelated seeds.
+         */
+        unsigned long long matchSeed(unsigned long long seed, int match)
+        {
+            unsigned long long z = seed + 0x9E3779B97F4A7C15ULL * (static_cast<unsigned long long>(match) + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        int randomInt(std::mt19937_64& generator, int min, int max)
+        {
+            return std::uniform_int_distribution<int>(min, max)(generator);
+        }
+
+        int sign(int value)
+        {
+            return (value > 0) - (value < 0);
+        }
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    void SimulationStats::merge(const SimulationStats& other) noexcept
+    {
+        long long decided = wins[CPP] + wins[PYTHON];
+        long long other_decided = other.wins[CPP] + other.wins[PYTHON];
+        if(other_decided > 0)
+        {
+            min_turns = (decided == 0)? other.min_turns : std::min(min_turns, other.min_turns);
+            max_turns = (decided == 0)? other.max_turns : std::max(max_turns, other.max_turns);
+        }
+        matches += other.matches;
+        wins[CPP] += other.wins[CPP];
+        wins[PYTHON] += other.wins[PYTHON];
+        draws += other.draws;
+        total_turns += other.total_turns;
+    }
+
+    MatchSimulator::Worker::Worker(const SimulationConfig& config) :
+    game(config.height, config.width)
+    {
+        // Game::addCharacter copies the stats of the character it is given, so a
+        // single prototype per team and type serves every match of the worker
+        Team teams[] = {CPP, PYTHON};
+        CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+        for(Team team : teams)
+        {
+            for(CharacterType type : types)
+            {
+                const UnitStats& stats = config.unit_stats[type];
+                prototypes[team][type] = Game::makeCharacter(type, team, stats.health, stats.ammo,
+                                                                stats.range, stats.power);
+            }
+        }
+        int half = (config.height / 2) * config.width;
+        cells.reserve(half);
+        own_positions.reserve(config.characters_per_team);
+        enemy_positions.reserve(config.characters_per_team);
+    }
+
+    MatchSimulator::MatchSimulator(const SimulationConfig& config) : config(config)
+    {
+        if(config.height < 2 || config.width < 1 || config.characters_per_team < 1 ||
+            config.characters_per_team > (config.height / 2) * config.width ||
+            config.max_turns < 0 || config.matches < 0 || config.threads < 0)
+        {
+            throw IllegalArgument();
+        }
+        for(const UnitStats& stats : config.unit_stats)
+        {
+            if(stats.health <= 0 || stats.ammo < 0 || stats.range < 0 || stats.power < 0)
+            {
+                throw IllegalArgument();
+            }
+        }
+    }
+
+    SimulationStats MatchSimulator::run() const
+    {
+        SimulationStats total;
+        int chunk_count = (config.matches + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        if(chunk_count == 0)
+        {
+            return total;
+        }
+        int thread_count = config.threads;
+        if(thread_count == 0)
+        {
+            thread_count = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+        }
+        thread_count = std::min(thread_count, chunk_count);
+
+        // Deal the chunks evenly, in contiguous blocks
+        std::vector<WorkQueue> queues(thread_count);
+        for(int worker = 0; worker < thread_count; worker++)
+        {
+            int first = static_cast<int>(static_cast<long long>(chunk_count) * worker / thread_count);
+            int last = static_cast<int>(static_cast<long long>(chunk_count) * (worker + 1) / thread_count);
+            for(int chunk = first; chunk < last; chunk++)
+            {
+                queues[worker].chunks.push_back(chunk);
+            }
+        }
+
+        std::vector<SimulationStats> stats(thread_count);
+        std::vector<std::exception_ptr> errors(thread_count);
+        auto work = [&](int self)
+        {
+            try
+            {
+                Worker worker(config);
+                int chunk = 0;
+                while(takeChunk(queues, self, chunk))
+                {
+                    int end = std::min(config.matches, (chunk + 1) * CHUNK_SIZE);
+                    for(int match = chunk * CHUNK_SIZE; match < end; match++)
+                    {
+                        playMatch(worker, match);
+                    }
+                }
+                stats[self] = worker.stats;
+            } catch (...) {
+                errors[self] = std::current_exception();
+            }
+        };
+
+        // The calling thread acts as worker 0
+        std::vector<std::thread> threads;
+        threads.reserve(thread_count - 1);
+        try
+        {
+            for(int worker = 1; worker < thread_count; worker++)
+            {
+                threads.push_back(std::thread(work, worker));
+            }
+        } catch (...) {
+            for(std::thread& thread : threads)
+            {
+                thread.join();
+            }
+            throw;
+        }
+        work(0);
+        for(std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        for(int worker = 0; worker < thread_count; worker++)
+        {
+            if(errors[worker])
+            {
+                std::rethrow_exception(errors[worker]);
+            }
+            total.merge(stats[worker]);
+        }
+        return total;
+    }
+
+    /* Private Methods */
+    void MatchSimulator::placeTeam(Worker& worker, Team team) const
+    {
+        // A partial Fisher-Yates shuffle of the team's half picks distinct cells
+        int half_height = config.height / 2;
+        int first_row = (team == CPP)? 0 : config.height - half_height;
+        worker.cells.clear();
+        for(int cell = 0; cell < half_height * config.width; cell++)
+        {
+            worker.cells.push_back(cell);
+        }
+        for(int i = 0; i < config.characters_per_team; i++)
+        {
+            int pick = randomInt(worker.generator, i, static_cast<int>(worker.cells.size()) - 1);
+            std::swap(worker.cells[i], worker.cells[pick]);
+            GridPoint coordinates(first_row + worker.cells[i] / config.width, worker.cells[i] % config.width);
+            CharacterType type = static_cast<CharacterType>(randomInt(worker.generator, SOLDIER, SNIPER));
+            worker.game.addCharacter(coordinates, worker.prototypes[team][type]);
+        }
+    }
+
+    void MatchSimulator::playTurn(Worker& worker, Team team) const
+    {
+        Team enemy = (team == CPP)? PYTHON : CPP;
+        worker.game.characterPositions(team, worker.own_positions);
+        worker.game.characterPositions(enemy, worker.enemy_positions);
+        const GridPoint& src = worker.own_positions[randomInt(worker.generator, 0,
+                                    static_cast<int>(worker.own_positions.size()) - 1)];
+        const GridPoint& target = worker.enemy_positions[randomInt(worker.generator, 0,
+                                    static_cast<int>(worker.enemy_positions.size()) - 1)];
+        Command command = Command::attack(src, target);
+        CommandResult result = SUCCESS;
+
+        // Now and then wander instead of chasing, so no pair of characters stays stuck
+        if(randomInt(worker.generator, 0, 7) == 0)
+        {
+            int row_offset = randomInt(worker.generator, -MIN_MOVE_RANGE, MIN_MOVE_RANGE);
+            int col_reach = MIN_MOVE_RANGE - std::abs(row_offset);
+            GridPoint dst(src.row + row_offset, src.col + randomInt(worker.generator, -col_reach, col_reach));
+            command = Command::move(src, dst);
+            worker.game.execute(&command, 1, &result);
+            return;
+        }
+
+        worker.game.execute(&command, 1, &result);
+        if(result == OUT_OF_AMMO)
+        {
+            command = Command::reload(src);
+            worker.game.execute(&command, 1, &result);
+        }
+        else if(result == OUT_OF_RANGE || result == ILLEGAL_TARGET)
+        {
+            // Step towards the target, stopping next to it
+            int row_distance = std::abs(target.row - src.row);
+            int col_distance = std::abs(target.col - src.col);
+            int steps = std::min(MIN_MOVE_RANGE, row_distance + col_distance - 1);
+            if(steps <= 0)
+            {
+                return;
+            }
+            int row_steps = std::min(row_distance, randomInt(worker.generator, 0, steps));
+            int col_steps = std::min(col_distance, steps - row_steps);
+            row_steps = std::min(row_distance, steps - col_steps);
+            GridPoint dst(src.row + sign(target.row - src.row) * row_steps,
+                            src.col + sign(target.col - src.col) * col_steps);
+            command = Command::move(src, dst);
+            worker.game.execute(&command, 1, &result);
+        }
+    }
+
+    void MatchSimulator::playMatch(Worker& worker, int match) const
+    {
+        worker.game.clear();
+        worker.generator.seed(matchSeed(config.seed, match));
+        placeTeam(worker, CPP);
+        placeTeam(worker, PYTHON);
+
+        SimulationStats& stats = worker.stats;
+        stats.matches++;
+        Team winner = CPP;
+        for(int turn = 0; ; turn++)
+        {
+            if(worker.game.isOver(&winner))
+            {
+                if(stats.wins[CPP] + stats.wins[PYTHON] == 0)
+                {
+                    stats.min_turns = stats.max_turns = turn;
+                }
+                stats.min_turns = std::min(stats.min_turns, turn);
+                stats.max_turns = std::max(stats.max_turns, turn);
+                stats.wins[winner]++;
+                stats.total_turns += turn;
+                return;
+            }
+            if(turn == config.max_turns)
+            {
+                stats.draws++;
+                return;
+            }
+            playTurn(worker, (turn % 2 == 0)? CPP : PYTHON);
+        }
+    }
+}
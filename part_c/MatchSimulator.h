@@ -0,0 +1,167 @@
+#ifndef MATCH_SIMULATOR_INC
+#define MATCH_SIMULATOR_INC
+// Includes
+#include <memory>
+#include <random>
+#include <vector>
+#include "Auxiliaries.h"
+#include "Exceptions.h"
+#include "Game.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Struct: UnitStats
+     * ---------------------------------------
+     * The starting stats of every character of a single type in a simulated match.
+     */
+    struct UnitStats
+    {
+        units_t health;
+        units_t ammo;
+        units_t range;
+        units_t power;
+    };
+
+    /*
+     * Struct: SimulationConfig
+     * ---------------------------------------
+     * The parameters of a simulation run.
+     * Each match places characters_per_team characters of random types per team,
+     * the CPP team in the upper half of the board and the PYTHON team in the lower
+     * half, and alternates single-command turns (CPP first) until one team is
+     * wiped out or max_turns turns have passed (a draw).
+     * Every match is seeded from seed and its index alone, so the statistics of a
+     * run do not depend on the number of threads.
+     */
+    struct SimulationConfig
+    {
+        int height = 12;
+        int width = 12;
+        int characters_per_team = 6;
+        int max_turns = 1000;
+        int matches = 1000;
+        int threads = 0;                    /* 0 uses every hardware thread */
+        unsigned long long seed = 0;
+        UnitStats unit_stats[3] = {         /* Indexed by CharacterType */
+            {10, 6, 3, 2},                  /* SOLDIER */
+            {8, 4, 3, 2},                   /* MEDIC */
+            {6, 3, 5, 3}                    /* SNIPER */
+        };
+    };
+
+    /*
+     * Struct: SimulationStats
+     * ---------------------------------------
+     * The aggregated outcome of a simulation run.
+     * Turn counts only cover the matches that ended with a winner.
+     */
+    struct SimulationStats
+    {
+        long long matches = 0;
+        long long wins[2] = {0, 0};         /* Indexed by Team */
+        long long draws = 0;
+        long long total_turns = 0;
+        int min_turns = 0;
+        int max_turns = 0;
+
+        double winRate(Team team) const noexcept
+        {
+            return (matches == 0)? 0 : static_cast<double>(wins[team]) / matches;
+        }
+        double drawRate() const noexcept
+        {
+            return (matches == 0)? 0 : static_cast<double>(draws) / matches;
+        }
+        double averageTurns() const noexcept
+        {
+            long long decided = wins[CPP] + wins[PYTHON];
+            return (decided == 0)? 0 : static_cast<double>(total_turns) / decided;
+        }
+
+        /*
+         * Method: merge
+         * Usage: total.merge(partial);
+         * -----------------------------------
+         * Adds the matches of other to these statistics.
+         */
+        void merge(const SimulationStats& other) noexcept;
+    };
+
+    /*
+     * Class: MatchSimulator
+     * ---------------------------------------
+     * Plays many independent random matches across a pool of worker threads.
+     * The matches are split into fixed-size chunks, dealt evenly to per-worker
+     * queues; a worker that runs out of chunks steals from the front of the
+     * other queues, so uneven match lengths do not leave cores idle.
+     * Each worker keeps a single Game, random generator and set of buffers for
+     * its whole share of the run, and resets the game between matches, so a
+     * match does not allocate once the worker has warmed up.
+     */
+    class MatchSimulator
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        static const int CHUNK_SIZE = 16;   /* Matches per unit of work */
+
+        /*
+         * The state a worker reuses from match to match.
+         */
+        struct Worker
+        {
+            Game game;
+            std::mt19937_64 generator;
+            std::vector<int> cells;
+            std::vector<GridPoint> own_positions;
+            std::vector<GridPoint> enemy_positions;
+            std::shared_ptr<Character> prototypes[2][3];   /* Indexed by Team, CharacterType */
+            SimulationStats stats;
+
+            explicit Worker(const SimulationConfig& config);
+        };
+
+        /* Instance variables */
+        SimulationConfig config;
+
+        /* Private Methods */
+        void placeTeam(Worker& worker, Team team) const;
+        void playTurn(Worker& worker, Team team) const;
+        void playMatch(Worker& worker, int match) const;
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: MatchSimulator
+         * Usage: MatchSimulator simulator(config);
+         * ---------------------------------------
+         * Creates a simulator for the given configuration.
+         *
+         * Possible exceptions:
+         * IllegalArgument if the board is smaller than 2x1, if a team does not fit
+         * in its half of the board, or if any count or unit stat is invalid.
+         */
+        explicit MatchSimulator(const SimulationConfig& config);
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: run
+         * Usage: SimulationStats stats = simulator.run();
+         * -----------------------------------
+         * Plays config.matches matches on config.threads threads and returns
+         * the aggregated statistics.
+         * An exception thrown by any worker is rethrown once every worker ended.
+         *
+         * Possible exceptions:
+         * std::bad_alloc, std::system_error
+         */
+        SimulationStats run() const;
+    };
+}
+#endif
@@ -1,9 +1,14 @@
 #ifndef MATRIX_INCLUDE
 #define MATRIX_INCLUDE
+#include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
 #include "Array.h"
 #include "Auxiliaries.h"
 #include "Exceptions.h"
+#include "Instrumentation.h"
 
 namespace mtm
 {
@@ -19,7 +24,33 @@ namespace mtm
 
         mtm::Dimensions dimensions;  /* The allocated size of the array   */
         Array<T> elements;           /* A dynamic array of the elements   */
-        
+
+        /* Returns the number of elements of a matrix of dimensions dim, which must not be empty */
+        static int checkedSize(const mtm::Dimensions& dim)
+        {
+            if(dim.getCol() <= 0 || dim.getRow() <= 0)
+            {
+                throw IllegalInitialization();
+            }
+            return dim.getCol() * dim.getRow();
+        }
+
+        /* Destroys the elements past the first size ones, after a row failed to be appended */
+        void truncate(int size) noexcept
+        {
+            while(elements.size() > size)
+            {
+                elements.pop_back();
+            }
+        }
+
+        /* Takes storage, which must hold exactly the elements of a matrix of dimensions dim */
+        Matrix(const mtm::Dimensions& dim, Array<T>&& storage) :
+        dimensions(dim), elements(std::move(storage))
+        {
+            Instrumentation::count(MATRIX_ALLOCATIONS);
+        }
+
     public:
         /*
          * Constructor: Matrix<T>
@@ -36,22 +67,13 @@ namespace mtm
          * Matrix::IllegalInitialization, std::bad_alloc
          * 
          * Assumptions on T:
-         * • Has an assignment operator. (=)
-         * • Has a default/no argument constructor.
+         * • Has a copy ctor.
+         * • Has a default/no argument constructor, if init_value is missing.
          */ 
         explicit Matrix(const mtm::Dimensions dim, const T& init_value = T()) :
-        dimensions(dim)
+        dimensions(dim), elements(checkedSize(dim), init_value)
         {
-            if(dim.getCol() <= 0 || dim.getRow() <= 0)
-            {
-                throw IllegalInitialization();
-            }
-            int size = dim.getCol() * dim.getRow();
-            elements = Array<T>(size);
-            for(int i = 0; i < size; i++)
-            {
-                elements[i] = init_value;
-            }
+            Instrumentation::count(MATRIX_ALLOCATIONS);
         }
 
         /*
@@ -63,14 +85,17 @@ namespace mtm
          * Creates a new matrix that is a copy of matrix.
          * 
          * Assumptions on T:
-         * • Has an assignment operator. (=)
-         * • Has a default/no argument constructor.
+         * • Has a copy ctor.
          * 
          * Possible exceptions:
          * std::bad_aloc if allocation fail.
          */ 
         Matrix(const Matrix<T>& matrix) :
-        dimensions(matrix.dimensions) , elements(matrix.elements) { }
+        dimensions(matrix.dimensions) , elements(matrix.elements)
+        {
+            Instrumentation::count(MATRIX_ALLOCATIONS);
+            Instrumentation::count(MATRIX_COPIES);
+        }
 
                 
         /*
@@ -111,6 +136,45 @@ namespace mtm
             return diag;
         }
 
+        /*
+         * Method: FromRow
+         * Usage: Matrix<T> matrix = Matrix<T>::FromRow(row.begin(), row.end());
+         * -----------------------------------
+         * Creates a new Matrix<T> of dimensions (1 x n) holding the n elements
+         * in the range [first, last), to be grown with appendRow.
+         * The range is read once, so it can come from an input iterator.
+         *
+         * Possible Exceptions:
+         * Matrix::IllegalInitialization if the range is empty, std::bad_alloc
+         *
+         * Assumptions on T:
+         * • Has a copy ctor.
+         */
+        template<typename ITERATOR>
+        static Matrix FromRow(ITERATOR first, ITERATOR last)
+        {
+            Array<T> row;
+            for(; first != last; ++first)
+            {
+                row.push_back(*first);
+            }
+            if(row.size() == 0)
+            {
+                throw IllegalInitialization();
+            }
+            return Matrix(mtm::Dimensions(1, row.size()), std::move(row));
+        }
+        static Matrix FromRow(std::initializer_list<T> row)
+        {
+            Array<T> elements;
+            elements.reserve(checkedSize(mtm::Dimensions(1, static_cast<int>(row.size()))));
+            for(const T& element : row)
+            {
+                elements.push_back(element);
+            }
+            return Matrix(mtm::Dimensions(1, elements.size()), std::move(elements));
+        }
+
         /*
          * Method: height
          * Usage: int rows = matrix.height();
@@ -144,6 +208,78 @@ namespace mtm
             return height() * width();
         }
 
+        /*
+         * Method: appendRow, reserveRows
+         * Usage: matrix.appendRow(row.begin(), row.end());
+         *        matrix.appendRow({1, 2, 3});
+         *        matrix.reserveRows(rows);
+         * -----------------------------------
+         * appendRow adds the elements in the range [first, last) as a new last
+         * row of the matrix. The storage grows geometrically, and moves the
+         * elements rather than copying them when it can, so appending a row
+         * takes amortized O(width) time. The range is read once, so it can
+         * come from an input iterator (such as std::istream_iterator).
+         * If appending fails the elements of the matrix are left unchanged.
+         * reserveRows makes room for a total of rows rows, so that appending
+         * up to that many never reallocates.
+         * Both invalidate references to the elements (but not iterators).
+         * The range ASSUMES not to point into the elements of the matrix.
+         *
+         * Possible Exceptions:
+         * Matrix::DimensionMismatch if the row is not as wide as the matrix,
+         * std::bad_alloc, std::length_error if the matrix would hold more than
+         * INT_MAX elements.
+         *
+         * Assumptions on T:
+         * • Has a copy ctor.
+         */
+        template<typename ITERATOR>
+        void appendRow(ITERATOR first, ITERATOR last)
+        {
+            if(elements.capacity() - size() < width())
+            {
+                reserveRows(std::max(height() + 1, height() * 2));
+            }
+            int row_width = 0;
+            try
+            {
+                for(; first != last && row_width < width(); ++first, row_width++)
+                {
+                    elements.push_back(*first);
+                }
+            } catch (...) {
+                truncate(size());
+                throw;
+            }
+            // Count the rest of a row that is too wide, without storing it
+            for(; first != last; ++first)
+            {
+                row_width++;
+            }
+            if(row_width != width())
+            {
+                truncate(size());
+                throw DimensionMismatch(dimensions, mtm::Dimensions(1, row_width));
+            }
+            dimensions = mtm::Dimensions(height() + 1, width());
+        }
+        void appendRow(std::initializer_list<T> row)
+        {
+            appendRow(row.begin(), row.end());
+        }
+        void reserveRows(int rows)
+        {
+            if(rows > std::numeric_limits<int>::max() / width())
+            {
+                throw std::length_error("Matrix is too large");
+            }
+            if(rows * width() > elements.capacity())
+            {
+                Instrumentation::count(MATRIX_ALLOCATIONS);
+                elements.reserve(rows * width());
+            }
+        }
+
         /*
          * Method: transpose
          * Usage: Matrix<T> matrix_trans = matrix.transpose();
@@ -154,21 +290,21 @@ namespace mtm
          * std::bad_alloc
          * 
          * Assumptions on T:
-         * • Has an assignment operator. (=)
-         * • Has a default/no argument constructor
+         * • Has a copy ctor.
          */
         Matrix transpose() const
         {
-            Dimensions transpose_dim(width(), height());
-            Matrix transpose(transpose_dim);
-            for(int i = 0; i < height(); i++)
+            // Copy-construct the elements in transposed order, rather than assigning over copies
+            Array<T> transposed;
+            transposed.reserve(size());
+            for(int j = 0; j < width(); j++)
             {
-                for(int j = 0; j < width(); j++)
+                for(int i = 0; i < height(); i++)
                 {
-                    transpose(j, i) = (*this)(i, j);
+                    transposed.push_back((*this)(i, j));
                 }
             }
-            return transpose;
+            return Matrix(Dimensions(width(), height()), std::move(transposed));
         }
 
         /*
@@ -300,7 +436,7 @@ namespace mtm
          * 
          * Assumptions on T:
          * • Has an assignment operator. (=)
-         * • Has a default/no argument constructor
+         * • Has a copy ctor.
          */
         Matrix& operator=(const Matrix<T>& target_matrix)
         {
@@ -308,9 +444,13 @@ namespace mtm
             {
                 return *this;
             }
+            if(size() != target_matrix.size())
+            {
+                Instrumentation::count(MATRIX_ALLOCATIONS);
+            }
+            Instrumentation::count(MATRIX_COPIES);
+            elements = target_matrix.elements;
             dimensions = target_matrix.dimensions;
-            Array<T> tmp_arr = target_matrix.elements;
-            elements = tmp_arr;
             return *this;
         }
 
@@ -318,17 +458,34 @@ namespace mtm
          * Operator: +=
          * Usage: matrix += value.
          * ----------------------
-         * Adds number to every single element in the matrix and returns the matrix' reference.
+         * Adds number to every single element in the matrix and returns the
+         * matrix' reference. The elements are updated in place when adding
+         * and assigning them can not throw; otherwise the sums are built in a
+         * copy first, so a failed addition leaves the matrix unchanged.
          * Assumptions on T:
          * • Has an + operator. 
-         * 
+         * • Has an assignment operator. (=)
+         * • Has a copy ctor, if + or = may throw.
+         *
          * Possible exceptions:
-         * std::bad_aloc if allocation fail.
+         * std::bad_alloc, or whatever the + and = operators of T throw.
          */
         Matrix& operator+=(const T& value)
         {
-            Matrix add_matrix(dimensions, value);
-            *this = *this + add_matrix;
+            if(noexcept(std::declval<T&>() = std::declval<const T&>() + std::declval<const T&>()))
+            {
+                for(T& element : *this)
+                {
+                    element = element + value;
+                }
+                return *this;
+            }
+            Matrix sum(*this);
+            for(T& element : sum)
+            {
+                element = element + value;
+            }
+            elements = std::move(sum.elements);
             return *this;
         }
 
@@ -553,10 +710,13 @@ namespace mtm
             std::string message;
             const std::string description;
         public:
-            explicit DimensionMismatch(const Matrix& mat1, const Matrix& mat2) : description("Mtm matrix error: Dimension mismatch: ")
+            explicit DimensionMismatch(const Matrix& mat1, const Matrix& mat2) :
+            DimensionMismatch(mat1.dimensions, mat2.dimensions) { }
+            explicit DimensionMismatch(const mtm::Dimensions& dim1, const mtm::Dimensions& dim2) :
+            description("Mtm matrix error: Dimension mismatch: ")
             {
-                message = description + "(" + std::to_string(mat1.height()) + "," + std::to_string(mat1.width()) + ") "
-                + "(" + std::to_string(mat2.height()) + "," + std::to_string(mat2.width()) + ")";
+                message = description + "(" + std::to_string(dim1.getRow()) + "," + std::to_string(dim1.getCol()) + ") "
+                + "(" + std::to_string(dim2.getRow()) + "," + std::to_string(dim2.getCol()) + ")";
             }
             virtual ~DimensionMismatch() = default;
             const char* what() const noexcept override
@@ -607,15 +767,22 @@ namespace mtm
     template<typename T>
     Matrix<T> operator+(const Matrix<T>& matrix, const T& value)
     {
-        return typename Matrix<T>::Matrix(matrix) += value;
+        Matrix<T> result(matrix);
+        for(T& element : result)
+        {
+            element = element + value;
+        }
+        return result;
     }
 
     template<typename T>
     Matrix<T> operator+(const T& value, const Matrix<T>& matrix)
     {
-        Dimensions copy_dim(matrix.height(),matrix.width());
-        Matrix<T> value_matrix(copy_dim, value);
-        Matrix<T> result = (value_matrix + matrix); 
+        Matrix<T> result(matrix);
+        for(T& element : result)
+        {
+            element = value + element;
+        }
         return result;
     }
 
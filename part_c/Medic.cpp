@@ -1,4 +1,5 @@
 #include "Medic.h"
+#include "PoolAllocator.h"
 
 namespace mtm
 {
@@ -14,6 +15,11 @@ namespace mtm
         return PYTHON_NAME;
     }
 
+    CharacterType Medic::getType() const noexcept
+    {
+        return MEDIC;
+    }
+
     void Medic::reload() noexcept
     {           
         ammo += RELOAD_AMMOUNT;
@@ -46,41 +52,9 @@ namespace mtm
         }
         return true;
     }
- 
-    void Medic::attack(Matrix<std::shared_ptr<Character>>board, const GridPoint& src_coordinates , const GridPoint& dst_coordinates)
-    {
-        std::shared_ptr<Character> target_ptr = board(dst_coordinates.row, dst_coordinates.col);
-        if(target_ptr != nullptr)
-        {
-            if((target_ptr->getTeam() != getTeam()) &&
-            (!board(src_coordinates.row, src_coordinates.col)->hasEnoughAmmo()))
-            {
-                throw OutOfAmmo();
-            }
-        }
-        else if(!board(src_coordinates.row, src_coordinates.col)->hasEnoughAmmo())
-        {
-            throw OutOfAmmo();
-        }
-        if(target_ptr == nullptr || 
-        GridPoint::distance(src_coordinates, dst_coordinates) == 0)
-        {
-            throw IllegalTarget();
-        }
-        if(target_ptr->getTeam() != getTeam())
-        {
-            target_ptr->setHealth(target_ptr->getHealth() - getPower());
-            ammo -= AMMO_COST;
-        }
-        else
-        {
-            target_ptr->setHealth(target_ptr->getHealth() + getPower());
-        }
-    }
 
     std::shared_ptr<Character> Medic::clone() const 
     {
-        std::shared_ptr<Character> copy(new Medic(*this));
-        return copy;
+        return std::allocate_shared<Medic>(PoolAllocator<Medic>(), *this);
     }
 }
\ No newline at end of file
@@ -2,6 +2,7 @@
 #define MEDIC_INC
 // Includes
 #include "Character.h"
+#include "CharacterTraits.h"
 //---------
 
 namespace mtm
@@ -14,11 +15,12 @@ namespace mtm
         /*********************************/
         /* Const instance variables */
 
-        static const char CPP_NAME = 'M';
-        static const char PYTHON_NAME = 'm';
-        static const int MAX_MOVE_RANGE = 5;
-        static const units_t RELOAD_AMMOUNT = 5;
-        static const units_t AMMO_COST = 1;
+        static const char CPP_NAME = CHARACTER_TRAITS[MEDIC].cpp_name;
+        static const char PYTHON_NAME = CHARACTER_TRAITS[MEDIC].python_name;
+        static const int MAX_MOVE_RANGE = CHARACTER_TRAITS[MEDIC].max_move_range;
+        static const units_t RELOAD_AMMOUNT = CHARACTER_TRAITS[MEDIC].reload_amount;
+        static const units_t AMMO_COST = CHARACTER_TRAITS[MEDIC].ammo_cost;
+        friend class Game;
     public:
         /*
          * Constructor: Medic
@@ -46,6 +48,14 @@ namespace mtm
          */
         char getName() const noexcept override;
 
+        /*
+         * Method: getType
+         * Usage: CharacterType type = character.getType();
+         * -----------------------------------
+         * Returns MEDIC.
+         */
+        CharacterType getType() const noexcept override;
+
         /*
          * Method: clone
          * Usage: shared_ptr<Character> copied_character = character.clone();
@@ -88,23 +98,6 @@ namespace mtm
          * Returns true if and only if the medic has enough ammo to attack.
          */
         bool hasEnoughAmmo() const noexcept override;
-
-        /*
-         * Method: attack
-         * Usage: medic.attack(board, src_coords, dst_coords);
-         * -----------------------------------
-         * ASSUMES: src_coords and dst_coords are legal and contain
-         * the corresponding character(*this) and the target.
-         * 
-         * If the character in dst_coords is on the same team as *this, 
-         * heal him for an amount equal to the power of *this.
-         * Otherwise, deal damage equals to the power of *this.
-         * 
-         * Possible Exceptions:
-         * mtm::OutOfAmmo, mtm::IllegalTarget.
-         */
-        void attack(Matrix<std::shared_ptr<Character>>board,
-            const GridPoint& src_coordinates , const GridPoint& dst_coordinates) override;
     };
 }
 #endif
\ No newline at end of file
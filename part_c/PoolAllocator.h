@@ -0,0 +1,271 @@
+#ifndef POOL_ALLOCATOR_INC
+#define POOL_ALLOCATOR_INC
+// Includes
+#include <cstddef>
+#include <mutex>
+#include <new>
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: BlockPool
+     * ---------------------------------------
+     * A process-wide pool of BLOCK_SIZE-byte blocks.
+     * Every thread takes blocks from, and gives them back to, a free list of
+     * its own, so allocating and freeing a block is a couple of pointer moves,
+     * with no lock and no call to operator new. A thread whose list runs dry
+     * takes up to BLOCKS_PER_CHUNK blocks from a shared list, or else carves
+     * BLOCKS_PER_CHUNK new blocks out of a single operator new.
+     * A block may be freed by another thread than the one that allocated it.
+     * A thread keeps at most MAX_CACHED_BLOCKS free blocks, and spills the
+     * others to the shared list (as does a thread that exits), so a thread that
+     * frees what another one allocates does not hoard the blocks.
+     * Blocks are recycled but never given back to the system: the pool holds
+     * as many blocks as were ever in use at once, plus up to
+     * MAX_CACHED_BLOCKS free ones per thread.
+     */
+    template<std::size_t BLOCK_SIZE>
+    class BlockPool
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        static const std::size_t BLOCKS_PER_CHUNK = 64;
+        static const std::size_t MAX_CACHED_BLOCKS = 2 * BLOCKS_PER_CHUNK;
+
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+        static_assert(BLOCK_SIZE >= sizeof(FreeBlock), "A block must be able to hold a free list link");
+
+        struct Cache
+        {
+            FreeBlock* head;
+            std::size_t count;  /* The number of blocks in the list */
+            bool alive;
+
+            Cache() : head(nullptr), count(0), alive(true) { }
+            ~Cache()
+            {
+                giveBack(head);
+                head = nullptr;
+                count = 0;
+                alive = false;
+            }
+        };
+
+        /* Class variables */
+        static thread_local Cache cache;    /* The free list of the calling thread */
+
+        /*
+         * The blocks of the threads that exited, and those spilled by full
+         * lists. Never destroyed, so blocks freed during static destruction
+         * still have somewhere to go.
+         */
+        static std::mutex& orphanedLock()
+        {
+            static std::mutex* lock = new std::mutex();
+            return *lock;
+        }
+        static FreeBlock*& orphaned()
+        {
+            static FreeBlock* head = nullptr;
+            return head;
+        }
+
+        /* Moves the list of blocks from first to last onto the shared list */
+        static void giveBack(FreeBlock* first, FreeBlock* last) noexcept
+        {
+            std::lock_guard<std::mutex> guard(orphanedLock());
+            last->next = orphaned();
+            orphaned() = first;
+        }
+        static void giveBack(FreeBlock* list) noexcept
+        {
+            if(list == nullptr)
+            {
+                return;
+            }
+            FreeBlock* last = list;
+            while(last->next != nullptr)
+            {
+                last = last->next;
+            }
+            giveBack(list, last);
+        }
+
+        /* Returns a list of blocks for an empty free list, and sets count to its length */
+        static FreeBlock* refill(std::size_t& count)
+        {
+            {
+                std::lock_guard<std::mutex> guard(orphanedLock());
+                FreeBlock* list = orphaned();
+                if(list != nullptr)
+                {
+                    FreeBlock* last = list;
+                    count = 1;
+                    while(count < BLOCKS_PER_CHUNK && last->next != nullptr)
+                    {
+                        last = last->next;
+                        count++;
+                    }
+                    orphaned() = last->next;
+                    last->next = nullptr;
+                    return list;
+                }
+            }
+            char* chunk = static_cast<char*>(::operator new(BLOCK_SIZE * BLOCKS_PER_CHUNK));
+            FreeBlock* list = nullptr;
+            for(std::size_t i = BLOCKS_PER_CHUNK; i > 0; i--)
+            {
+                FreeBlock* block = reinterpret_cast<FreeBlock*>(chunk + (i - 1) * BLOCK_SIZE);
+                block->next = list;
+                list = block;
+            }
+            count = BLOCKS_PER_CHUNK;
+            return list;
+        }
+    public:
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: allocate
+         * Usage: void* block = BlockPool<64>::allocate();
+         * -----------------------------------
+         * Returns an uninitialized block of BLOCK_SIZE bytes, aligned for any
+         * object that fits in it.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        static void* allocate()
+        {
+            Cache& local = cache;
+            if(local.head == nullptr)
+            {
+                local.head = refill(local.count);
+            }
+            FreeBlock* block = local.head;
+            local.head = block->next;
+            local.count--;
+            return block;
+        }
+
+        /*
+         * Method: deallocate
+         * Usage: BlockPool<64>::deallocate(block);
+         * -----------------------------------
+         * Gives back a block returned by allocate.
+         */
+        static void deallocate(void* pointer) noexcept
+        {
+            FreeBlock* block = static_cast<FreeBlock*>(pointer);
+            Cache& local = cache;
+            if(!local.alive)
+            {
+                // The thread is exiting and its list was already given back
+                block->next = nullptr;
+                giveBack(block);
+                return;
+            }
+            block->next = local.head;
+            local.head = block;
+            if(++local.count > MAX_CACHED_BLOCKS)
+            {
+                // Spill the BLOCKS_PER_CHUNK blocks freed last
+                FreeBlock* last = block;
+                for(std::size_t i = 1; i < BLOCKS_PER_CHUNK; i++)
+                {
+                    last = last->next;
+                }
+                local.head = last->next;
+                local.count -= BLOCKS_PER_CHUNK;
+                giveBack(block, last);
+            }
+        }
+    };
+
+    template<std::size_t BLOCK_SIZE>
+    thread_local typename BlockPool<BLOCK_SIZE>::Cache BlockPool<BLOCK_SIZE>::cache;
+
+    /*
+     * Class: PoolAllocator
+     * ---------------------------------------
+     * A stateless allocator handing out single objects from the BlockPool of
+     * their size, meant for std::allocate_shared:
+     *     std::allocate_shared<Soldier>(PoolAllocator<Soldier>(), ...);
+     * puts the object and its reference counts in one pooled block, where
+     * std::shared_ptr<Character>(new Soldier(...)) makes two calls to
+     * operator new. Arrays are left to operator new.
+     */
+    template<typename T>
+    class PoolAllocator
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        static const std::size_t ALIGNMENT = alignof(std::max_align_t);
+        static const std::size_t BLOCK_SIZE = (sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+        static_assert(alignof(T) <= ALIGNMENT, "Over-aligned types are not supported");
+    public:
+        typedef T value_type;
+
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        PoolAllocator() noexcept { }
+        template<typename U>
+        PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: allocate, deallocate
+         * Usage: T* object = allocator.allocate(1);
+         *        allocator.deallocate(object, 1);
+         * -----------------------------------
+         * The allocator requirements of the standard library.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (allocate only)
+         */
+        T* allocate(std::size_t count)
+        {
+            if(count != 1)
+            {
+                return static_cast<T*>(::operator new(count * sizeof(T)));
+            }
+            return static_cast<T*>(BlockPool<BLOCK_SIZE>::allocate());
+        }
+        void deallocate(T* pointer, std::size_t count) noexcept
+        {
+            if(count != 1)
+            {
+                ::operator delete(pointer);
+                return;
+            }
+            BlockPool<BLOCK_SIZE>::deallocate(pointer);
+        }
+    };
+
+    /*
+     * Every PoolAllocator can free what any other one allocated.
+     */
+    template<typename T, typename U>
+    bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept
+    {
+        return true;
+    }
+    template<typename T, typename U>
+    bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept
+    {
+        return false;
+    }
+}
+#endif
@@ -0,0 +1,174 @@
+#include <cmath>
+#include "ScenarioGenerator.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        /* Consecutive characters without a legal command that end a sequence early */
+        const int MAX_FAILED_PICKS = 1000;
+
+        /*
+         * SplitMix64 finalizer: gives every stream of a scenario an unrelated seed.
+         */
+        unsigned long long streamSeed(unsigned long long seed, int stream)
+        {
+            unsigned long long z = seed + 0x9E3779B97F4A7C15ULL * (static_cast<unsigned long long>(stream) + 1);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        }
+
+        int randomInt(std::mt19937_64& generator, int min, int max)
+        {
+            return std::uniform_int_distribution<int>(min, max)(generator);
+        }
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    ScenarioGenerator::ScenarioGenerator(const ScenarioConfig& config) :
+    config(config), start(config.height, config.width)
+    {
+        if(!(config.density >= 0 && config.density <= 1))
+        {
+            throw IllegalArgument();
+        }
+        for(const UnitStats& stats : config.unit_stats)
+        {
+            if(stats.health <= 0 || stats.ammo < 0 || stats.range < 0 || stats.power < 0)
+            {
+                throw IllegalArgument();
+            }
+        }
+        long long cells = static_cast<long long>(config.height) * config.width;
+        long long count = std::llround(config.density * cells);
+        placed.reserve(static_cast<size_t>(count));
+
+        // Draw cells until a free one comes up, which takes few draws unless the board is nearly full
+        std::mt19937_64 generator(streamSeed(config.seed, 0));
+        while(static_cast<long long>(placed.size()) < count)
+        {
+            GridPoint coordinates(randomInt(generator, 0, config.height - 1), randomInt(generator, 0, config.width - 1));
+            CharacterType type = static_cast<CharacterType>(randomInt(generator, SOLDIER, SNIPER));
+            Team team = static_cast<Team>(randomInt(generator, CPP, PYTHON));
+            const UnitStats& stats = config.unit_stats[type];
+            if(start.tryAddCharacter(coordinates, type, team, stats.health, stats.ammo,
+                                        stats.range, stats.power) == SUCCESS)
+            {
+                PlacedCharacter character = {coordinates, type, team};
+                placed.push_back(character);
+            }
+        }
+    }
+
+    const Game& ScenarioGenerator::game() const noexcept
+    {
+        return start;
+    }
+
+    const std::vector<PlacedCharacter>& ScenarioGenerator::characters() const noexcept
+    {
+        return placed;
+    }
+
+    std::vector<Command> ScenarioGenerator::commands(CommandType type, int count) const
+    {
+        return generate(type, true, SOLDIER, count);
+    }
+
+    std::vector<Command> ScenarioGenerator::attacks(CharacterType attacker, int count) const
+    {
+        return generate(ATTACK, false, attacker, count);
+    }
+
+    /* Private Methods */
+    std::vector<Command> ScenarioGenerator::generate(CommandType type, bool any_type, CharacterType attacker,
+                                                        int count) const
+    {
+        if(count < 0)
+        {
+            throw IllegalArgument();
+        }
+        std::vector<Command> sequence;
+        sequence.reserve(count);
+
+        // Play the sequence on a copy, tracking which character is in which cell
+        Game game(start);
+        std::vector<PlacedCharacter> alive(placed);
+        std::vector<int> index_of(static_cast<size_t>(config.height) * config.width, -1);
+        for(int i = 0; i < static_cast<int>(alive.size()); i++)
+        {
+            index_of[alive[i].coordinates.row * config.width + alive[i].coordinates.col] = i;
+        }
+        std::mt19937_64 generator(streamSeed(config.seed, 1 + type * 4 + (any_type? 3 : attacker)));
+        std::vector<Command> legal;
+        std::vector<GridPoint> casualties;
+        int failed_picks = 0;
+        while(static_cast<int>(sequence.size()) < count && !alive.empty() && failed_picks < MAX_FAILED_PICKS)
+        {
+            int index = randomInt(generator, 0, static_cast<int>(alive.size()) - 1);
+            GridPoint src = alive[index].coordinates;
+            if(!any_type && alive[index].type != attacker)
+            {
+                failed_picks++;
+                continue;
+            }
+            int legal_count = game.legalCommands(src, legal.data(), static_cast<int>(legal.size()));
+            if(legal_count > static_cast<int>(legal.size()))
+            {
+                legal.resize(static_cast<size_t>(legal_count));
+                game.legalCommands(src, legal.data(), legal_count);
+            }
+            int matching = 0;
+            for(int i = 0; i < legal_count; i++)
+            {
+                if(legal[i].type == type)
+                {
+                    legal[matching++] = legal[i];
+                }
+            }
+            if(matching == 0)
+            {
+                failed_picks++;
+                continue;
+            }
+            failed_picks = 0;
+            Command command = legal[randomInt(generator, 0, matching - 1)];
+            sequence.push_back(command);
+
+            switch(type)
+            {
+                case MOVE:
+                game.tryMove(src, command.dst);
+                alive[index].coordinates = command.dst;
+                index_of[src.row * config.width + src.col] = -1;
+                index_of[command.dst.row * config.width + command.dst.col] = index;
+                break;
+
+                case ATTACK:
+                casualties.clear();
+                game.tryAttack(src, command.dst, &casualties);
+                for(const GridPoint& casualty : casualties)
+                {
+                    int& dead = index_of[casualty.row * config.width + casualty.col];
+                    const GridPoint& last = alive.back().coordinates;
+                    index_of[last.row * config.width + last.col] = dead;
+                    alive[dead] = alive.back();
+                    alive.pop_back();
+                    dead = -1;
+                }
+                break;
+
+                case RELOAD:
+                game.tryReload(src);
+                break;
+            }
+        }
+        return sequence;
+    }
+}
@@ -0,0 +1,118 @@
+#ifndef SCENARIO_GENERATOR_INC
+#define SCENARIO_GENERATOR_INC
+// Includes
+#include <random>
+#include <vector>
+#include "Auxiliaries.h"
+#include "Command.h"
+#include "Exceptions.h"
+#include "Game.h"
+#include "MatchSimulator.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Struct: ScenarioConfig
+     * ---------------------------------------
+     * The parameters of a generated scenario: a board of height x width cells,
+     * of which a density fraction hold characters of random types and teams.
+     * The default ammo is high enough that attacks rarely run out.
+     */
+    struct ScenarioConfig
+    {
+        int height = 64;
+        int width = 64;
+        double density = 0.1;
+        unsigned long long seed = 0;
+        UnitStats unit_stats[3] = {         /* Indexed by CharacterType */
+            {20, 1000, 3, 2},               /* SOLDIER */
+            {16, 1000, 3, 2},               /* MEDIC */
+            {12, 1000, 5, 3}                /* SNIPER */
+        };
+    };
+
+    /*
+     * Struct: PlacedCharacter
+     * ---------------------------------------
+     * A character of a scenario, and the cell it was placed in.
+     */
+    struct PlacedCharacter
+    {
+        GridPoint coordinates;
+        CharacterType type;
+        Team team;
+    };
+
+    /*
+     * Class: ScenarioGenerator
+     * ---------------------------------------
+     * Builds a reproducible game for benchmarks and tests, and sequences of
+     * commands to play on it.
+     * Everything it generates depends on the config alone (seed included):
+     * every sequence is drawn from a generator of its own, so the sequences do
+     * not depend on which others were generated, or in which order.
+     */
+    class ScenarioGenerator
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        /* Instance variables */
+        ScenarioConfig config;
+        Game start;
+        std::vector<PlacedCharacter> placed;
+
+        /* Private Methods */
+        std::vector<Command> generate(CommandType type, bool any_type, CharacterType attacker, int count) const;
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: ScenarioGenerator
+         * Usage: ScenarioGenerator scenario(config);
+         * ---------------------------------------
+         * Creates the game of the scenario: round(density * height * width)
+         * characters, each in a random free cell.
+         *
+         * Possible exceptions:
+         * IllegalArgument if the board is empty, if density is not in [0, 1],
+         * or if any unit stat is invalid.
+         * std::bad_alloc
+         */
+        explicit ScenarioGenerator(const ScenarioConfig& config);
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: game, characters
+         * Usage: Game game(scenario.game());
+         * -----------------------------------
+         * Return the game of the scenario, and its characters in the order
+         * they were added.
+         */
+        const Game& game() const noexcept;
+        const std::vector<PlacedCharacter>& characters() const noexcept;
+
+        /*
+         * Method: commands, attacks
+         * Usage: std::vector<Command> moves = scenario.commands(MOVE, 1000);
+         *        std::vector<Command> shots = scenario.attacks(SNIPER, 1000);
+         * -----------------------------------
+         * Return count commands of the given type by random characters (of
+         * the given type, for attacks), each a random legal command of its
+         * character, that all succeed when applied in order to a copy of game().
+         * Fewer commands are returned if the characters run out of legal ones.
+         *
+         * Possible exceptions:
+         * IllegalArgument if count is negative.
+         * std::bad_alloc
+         */
+        std::vector<Command> commands(CommandType type, int count) const;
+        std::vector<Command> attacks(CharacterType attacker, int count) const;
+    };
+}
+#endif
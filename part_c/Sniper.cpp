@@ -1,4 +1,5 @@
 #include "Sniper.h"
+#include "PoolAllocator.h"
 
 namespace mtm
 {
@@ -14,6 +15,16 @@ namespace mtm
         return PYTHON_NAME;
     }
 
+    CharacterType Sniper::getType() const noexcept
+    {
+        return SNIPER;
+    }
+
+    int Sniper::getComboCount() const noexcept
+    {
+        return combo_attack_count;
+    }
+
     void Sniper::reload() noexcept
     {           
         ammo += RELOAD_AMMOUNT;
@@ -21,12 +32,7 @@ namespace mtm
 
     bool Sniper::isInAttackRange(const GridPoint& src_coordinates , const GridPoint& dst_coordinates) const noexcept
     {
-        int distance = GridPoint::distance(src_coordinates, dst_coordinates);
-        if(distance > getRange() || distance < static_cast<int>(std::ceil(static_cast<double>(getRange())/2)))
-        {
-            return false;
-        }
-        return true;
+        return CharacterRules::isInAttackRange(SNIPER, getRange(), src_coordinates, dst_coordinates);
     }
 
     bool Sniper::isLegalMove(int distance) const noexcept
@@ -47,26 +53,8 @@ namespace mtm
         return true;
     }
 
-    void Sniper::attack(Matrix<std::shared_ptr<Character>>board, const GridPoint& src_coordinates , const GridPoint& dst_coordinates)
-    {
-        std::shared_ptr<Character> target_ptr = board(dst_coordinates.row, dst_coordinates.col);
-        if(!board(src_coordinates.row, src_coordinates.col)->hasEnoughAmmo())
-        {
-            throw OutOfAmmo();
-        }
-        if(target_ptr == nullptr || (target_ptr->getTeam() == getTeam()) )
-        {
-            throw IllegalTarget();
-        }
-        units_t damage = (combo_attack_count++ == (MAX_COMBO - 1))? getPower()*CRITICAL_MULTIPLIER : getPower();
-        target_ptr->setHealth(target_ptr->getHealth() - damage);
-        combo_attack_count %= MAX_COMBO;
-        ammo -= AMMO_COST;
-    }
-
     std::shared_ptr<Character> Sniper::clone() const 
     {
-        std::shared_ptr<Character> copy(new Sniper(*this));
-        return copy;
+        return std::allocate_shared<Sniper>(PoolAllocator<Sniper>(), *this);
     }
 }
@@ -3,6 +3,7 @@
 // Includes
 
 #include "Character.h"
+#include "CharacterTraits.h"
 #include <map>
 //---------
 
@@ -18,13 +19,12 @@ namespace mtm
         int combo_attack_count;
         
         /* Const instance variables */
-        static const char CPP_NAME = 'N';
-        static const char PYTHON_NAME = 'n';
-        static const int MAX_MOVE_RANGE = 4;
-        static const int MAX_COMBO = 3;
-        static const units_t CRITICAL_MULTIPLIER = 2;
-        static const units_t RELOAD_AMMOUNT = 2;
-        static const units_t AMMO_COST = 1;
+        static const char CPP_NAME = CHARACTER_TRAITS[SNIPER].cpp_name;
+        static const char PYTHON_NAME = CHARACTER_TRAITS[SNIPER].python_name;
+        static const int MAX_MOVE_RANGE = CHARACTER_TRAITS[SNIPER].max_move_range;
+        static const units_t RELOAD_AMMOUNT = CHARACTER_TRAITS[SNIPER].reload_amount;
+        static const units_t AMMO_COST = CHARACTER_TRAITS[SNIPER].ammo_cost;
+        friend class Game;
     public:
         /*
          * Constructor: Sniper
@@ -52,6 +52,22 @@ namespace mtm
          */
         char getName() const noexcept override;
 
+        /*
+         * Method: getType
+         * Usage: CharacterType type = character.getType();
+         * -----------------------------------
+         * Returns SNIPER.
+         */
+        CharacterType getType() const noexcept override;
+
+        /*
+         * Method: getComboCount
+         * Usage: int combo = sniper.getComboCount();
+         * -----------------------------------
+         * Returns the number of attacks made since the last critical attack.
+         */
+        int getComboCount() const noexcept override;
+
         /*
          * Method: clone
          * Usage: shared_ptr<Character> copied_character = character.clone();
@@ -94,20 +110,6 @@ namespace mtm
          * Returns true if and only if the sniper has enough ammo to attack.
          */
         bool hasEnoughAmmo() const noexcept override;
-
-        /*
-         * Method: attack
-         * Usage: sniper.attack(board, src_coords, dst_coords);
-         * -----------------------------------
-         * ASSUMES: src_coords is legal and contains the corresponding character (*this).
-         * 
-         * Attempts to attack the enemy character at grid dst_coords.
-         * 
-         * Possible Exceptions:
-         * mtm::OutOfAmmo, mtm::IllegalTarget.
-         */
-        void attack(Matrix<std::shared_ptr<Character>>board,
-            const GridPoint& src_coordinates , const GridPoint& dst_coordinates) override;
     };
 }
 #endif
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "Soldier.h"
+#include "PoolAllocator.h"
 
 namespace mtm
 {
@@ -14,6 +15,11 @@ namespace mtm
         return PYTHON_NAME;
     }
 
+    CharacterType Soldier::getType() const noexcept
+    {
+        return SOLDIER;
+    }
+
     void Soldier::reload() noexcept
     {
         ammo += RELOAD_AMMOUNT;
@@ -47,50 +53,8 @@ namespace mtm
         return true;
     }
 
-    void Soldier::attack(Matrix<std::shared_ptr<Character>>board, const GridPoint& src_coordinates , const GridPoint& dst_coordinates)
-    {
-        if(!board(src_coordinates.row, src_coordinates.col)->hasEnoughAmmo())
-        {
-            throw OutOfAmmo();
-        }
-        if((src_coordinates.col != dst_coordinates.col) && (src_coordinates.row != dst_coordinates.row))
-        {
-            throw IllegalTarget();
-        }
-        int distance;
-        std::shared_ptr<Character> cell;
-        int area_of_effect = std::ceil(static_cast<double>(getRange())/COLATERAL_RANGE);
-        units_t area_of_effect_damage = std::ceil(static_cast<double>(getPower())/COLATERAL_DAMAGE);
-        for(int row = 0; row < board.height(); row++)
-        {
-            for(int col = 0; col < board.width(); col++)
-            {
-                cell = board(row, col);
-                distance = GridPoint::distance(GridPoint(row, col), dst_coordinates);
-                if(distance <= area_of_effect) //Checks to see if the cell is in the area of effect
-                {
-                    if(cell != nullptr && cell->getTeam() != getTeam()) //Makes sure that the target is an enemy
-                    {
-                        switch(distance)
-                        {
-                            case 0: //Means that the target is exactly in the dst_coordinates
-                            cell->setHealth(cell->getHealth() - getPower());
-                            break;
-
-                            default: //Means that the target is in the area of effect, but not center
-                            cell->setHealth(cell->getHealth() - area_of_effect_damage);
-                            break;
-                        }
-                    }
-                }
-            }
-        }
-        ammo -= AMMO_COST; //Reduce ammo
-    }
-
     std::shared_ptr<Character> Soldier::clone() const 
     {
-        std::shared_ptr<Character> copy(new Soldier(*this));
-        return copy;
+        return std::allocate_shared<Soldier>(PoolAllocator<Soldier>(), *this);
     }
 }
@@ -2,6 +2,7 @@
 #define SOLDIER_INC
 // Includes
 #include "Character.h"
+#include "CharacterTraits.h"
 //---------
 
 namespace mtm
@@ -13,13 +14,12 @@ namespace mtm
         /*        Private Section        */
         /*********************************/
         /* Const instance variables */
-        static const char CPP_NAME = 'S';
-        static const char PYTHON_NAME = 's';
-        static const units_t COLATERAL_RANGE = 3;
-        static const units_t COLATERAL_DAMAGE = 2;
-        static const int MAX_MOVE_RANGE = 3;
-        static const units_t RELOAD_AMMOUNT = 3;
-        static const units_t AMMO_COST = 1;
+        static const char CPP_NAME = CHARACTER_TRAITS[SOLDIER].cpp_name;
+        static const char PYTHON_NAME = CHARACTER_TRAITS[SOLDIER].python_name;
+        static const int MAX_MOVE_RANGE = CHARACTER_TRAITS[SOLDIER].max_move_range;
+        static const units_t RELOAD_AMMOUNT = CHARACTER_TRAITS[SOLDIER].reload_amount;
+        static const units_t AMMO_COST = CHARACTER_TRAITS[SOLDIER].ammo_cost;
+        friend class Game;
     public:
         /*
          * Constructor: Soldier
@@ -47,6 +47,14 @@ namespace mtm
          */
         char getName() const noexcept override;
 
+        /*
+         * Method: getType
+         * Usage: CharacterType type = character.getType();
+         * -----------------------------------
+         * Returns SOLDIER.
+         */
+        CharacterType getType() const noexcept override;
+
         /*
          * Method: clone
          * Usage: shared_ptr<Character> copied_character = character.clone();
@@ -89,21 +97,6 @@ namespace mtm
          * Returns true if and only if the soldier has enough ammo to attack.
          */
         bool hasEnoughAmmo() const noexcept override;
-
-        /*
-         * Method: attack
-         * Usage: soldier.attack(board, src_coords, dst_coords);
-         * -----------------------------------
-         * ASSUMES: src_coords is legal and contains the corresponding character(*this),
-         * and dst_coordinates is in range.
-         * 
-         * Attempts to attack the area around grid dst_coords.
-         * 
-         * Possible Exceptions:
-         * mtm::OutOfAmmo, mtm::IllegalTarget.
-         */
-        void attack(Matrix<std::shared_ptr<Character>>board,
-            const GridPoint& src_coordinates , const GridPoint& dst_coordinates) override;
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,212 @@
+#ifndef TILE_MAP_INC
+#define TILE_MAP_INC
+// Includes
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: TileMap
+     * ---------------------------------------
+     * A hash of fixed-size tiles of a sparse board, keyed by tile coordinates.
+     * A tile is allocated by its first occupant and freed by its owner once it
+     * holds none, so the memory scales with the occupied area of the board and
+     * not with its size.
+     * While empty tiles are retained (see retainEmptyTiles), a tile that loses
+     * its last occupant is kept, so putting the occupants back never allocates.
+     * Such tiles are linked through the tiles themselves, so keeping track of
+     * them does not allocate either.
+     *
+     * Assumptions on TILE:
+     * • Default constructible, to an empty tile.
+     * • Copy constructible.
+     * • Has an int member named occupied, counting its occupants.
+     */
+    template<typename TILE>
+    class TileMap
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        struct Slot
+        {
+            TILE tile;
+            std::uint64_t key;
+            bool listed;            /* Whether the slot is on the list of emptied tiles */
+            Slot* next_emptied;
+        };
+
+        /* Instance variables */
+        std::unordered_map<std::uint64_t, std::unique_ptr<Slot>> slots;
+        bool retain_empty;
+        Slot* emptied;              /* The tiles that lost their last occupant while retained */
+
+        static std::uint64_t keyOf(int tile_row, int tile_col) noexcept
+        {
+            return static_cast<std::uint64_t>(static_cast<std::uint32_t>(tile_row)) << 32
+                    | static_cast<std::uint32_t>(tile_col);
+        }
+    public:
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        TileMap() : slots(), retain_empty(false), emptied(nullptr)
+        {
+
+        }
+
+        /*
+         * Copies only the occupied tiles, and never retains empty ones.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        TileMap(const TileMap& other) : slots(), retain_empty(false), emptied(nullptr)
+        {
+            slots.reserve(other.slots.size());
+            for(const auto& element : other.slots)
+            {
+                if(element.second->tile.occupied > 0)
+                {
+                    std::unique_ptr<Slot> slot(new Slot(*element.second));
+                    slot->listed = false;
+                    slot->next_emptied = nullptr;
+                    slots.emplace(element.first, std::move(slot));
+                }
+            }
+        }
+
+        TileMap& operator=(const TileMap& other)
+        {
+            if(&other != this)
+            {
+                TileMap copy(other);
+                slots.swap(copy.slots);
+                retain_empty = false;
+                emptied = nullptr;
+            }
+            return *this;
+        }
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: find
+         * Usage: const Tile* tile = tiles.find(tile_row, tile_col);
+         * -----------------------------------
+         * Returns the tile at the given tile coordinates, or nullptr if it is
+         * not allocated.
+         */
+        const TILE* find(int tile_row, int tile_col) const noexcept
+        {
+            auto element = slots.find(keyOf(tile_row, tile_col));
+            return (element == slots.end())? nullptr : &element->second->tile;
+        }
+        TILE* find(int tile_row, int tile_col) noexcept
+        {
+            auto element = slots.find(keyOf(tile_row, tile_col));
+            return (element == slots.end())? nullptr : &element->second->tile;
+        }
+
+        /*
+         * Method: obtain
+         * Usage: Tile& tile = tiles.obtain(tile_row, tile_col);
+         * -----------------------------------
+         * Returns the tile at the given tile coordinates, allocating an empty
+         * one if needed.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        TILE& obtain(int tile_row, int tile_col)
+        {
+            std::uint64_t key = keyOf(tile_row, tile_col);
+            std::unique_ptr<Slot>& slot = slots[key];
+            if(!slot)
+            {
+                slot.reset(new Slot());
+                slot->key = key;
+                slot->listed = false;
+                slot->next_emptied = nullptr;
+            }
+            return slot->tile;
+        }
+
+        /*
+         * Method: vacate
+         * Usage: if(--tile->occupied == 0) tiles.vacate(tile_row, tile_col);
+         * -----------------------------------
+         * Tells the map that the tile at the given tile coordinates lost its last
+         * occupant. Frees it, unless empty tiles are retained.
+         */
+        void vacate(int tile_row, int tile_col) noexcept
+        {
+            auto element = slots.find(keyOf(tile_row, tile_col));
+            if(element == slots.end())
+            {
+                return;
+            }
+            if(!retain_empty)
+            {
+                slots.erase(element);
+                return;
+            }
+            Slot* slot = element->second.get();
+            if(!slot->listed)
+            {
+                slot->listed = true;
+                slot->next_emptied = emptied;
+                emptied = slot;
+            }
+        }
+
+        /*
+         * Method: retainEmptyTiles
+         * Usage: tiles.retainEmptyTiles(true);
+         * -----------------------------------
+         * Starts or stops retaining the tiles that lose their last occupant.
+         * Stopping frees the retained tiles that are still empty.
+         */
+        void retainEmptyTiles(bool retain) noexcept
+        {
+            retain_empty = retain;
+            if(retain)
+            {
+                return;
+            }
+            while(emptied != nullptr)
+            {
+                Slot* slot = emptied;
+                emptied = slot->next_emptied;
+                slot->listed = false;
+                if(slot->tile.occupied == 0)
+                {
+                    slots.erase(slot->key);
+                }
+            }
+        }
+
+        /*
+         * Method: clear, size
+         * Usage: tiles.clear();
+         *        size_t allocated = tiles.size();
+         * -----------------------------------
+         * clear frees every tile, and size returns the number of allocated tiles.
+         */
+        void clear() noexcept
+        {
+            slots.clear();
+            emptied = nullptr;
+        }
+        size_t size() const noexcept
+        {
+            return slots.size();
+        }
+    };
+}
+#endif
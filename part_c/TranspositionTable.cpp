@@ -0,0 +1,112 @@
+#include <algorithm>
+#include "TranspositionTable.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*        Local helpers section         */
+    /****************************************/
+    namespace
+    {
+        /* Layout of the data word */
+        const int DEPTH_SHIFT = 32;
+        const int BOUND_SHIFT = 40;
+        const int HAS_COMMAND_SHIFT = 42;
+        const std::uint64_t VALID_BIT = 1ULL << 63;    /* Tells a stored entry from an empty slot */
+    }
+
+    /***************************************/
+    /*     Ctors implementation section    */
+    /***************************************/
+    TranspositionTable::TranspositionTable(int log2_size) :
+    slots((log2_size < 0 || log2_size > 30)? throw IllegalArgument() : new Slot[1ULL << log2_size]),
+    mask((1ULL << log2_size) - 1)
+    {
+        clear();
+    }
+
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    void TranspositionTable::store(std::uint64_t key, const Entry& entry) noexcept
+    {
+        Slot& slot = slots[key & mask];
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t command = slot.command.load(std::memory_order_relaxed);
+        bool same_position = (slot.check.load(std::memory_order_relaxed) ^ data ^ command) == key;
+        int depth = std::min(255, std::max(0, entry.depth));
+        if(same_position && (data & VALID_BIT) && static_cast<int>((data >> DEPTH_SHIFT) & 0xFF) > depth)
+        {
+            return; // Keep the deeper result
+        }
+        command = 0;
+        bool has_command = entry.has_command && packCommand(entry.command, command);
+        data = static_cast<std::uint64_t>(static_cast<std::uint32_t>(entry.score))
+                | static_cast<std::uint64_t>(depth) << DEPTH_SHIFT
+                | static_cast<std::uint64_t>(entry.bound) << BOUND_SHIFT
+                | static_cast<std::uint64_t>(has_command) << HAS_COMMAND_SHIFT
+                | VALID_BIT;
+        slot.data.store(data, std::memory_order_relaxed);
+        slot.command.store(command, std::memory_order_relaxed);
+        slot.check.store(key ^ data ^ command, std::memory_order_relaxed);
+    }
+
+    bool TranspositionTable::probe(std::uint64_t key, Entry& entry) const noexcept
+    {
+        const Slot& slot = slots[key & mask];
+        std::uint64_t check = slot.check.load(std::memory_order_relaxed);
+        std::uint64_t data = slot.data.load(std::memory_order_relaxed);
+        std::uint64_t command = slot.command.load(std::memory_order_relaxed);
+        if(!(data & VALID_BIT) || (check ^ data ^ command) != key)
+        {
+            return false;
+        }
+        entry.score = static_cast<int>(static_cast<std::uint32_t>(data));
+        entry.depth = static_cast<int>((data >> DEPTH_SHIFT) & 0xFF);
+        entry.bound = static_cast<Bound>((data >> BOUND_SHIFT) & 0x3);
+        entry.has_command = (data >> HAS_COMMAND_SHIFT) & 1;
+        if(entry.has_command)
+        {
+            entry.command = unpackCommand(command);
+        }
+        return true;
+    }
+
+    void TranspositionTable::clear() noexcept
+    {
+        for(std::uint64_t i = 0; i <= mask; i++)
+        {
+            slots[i].check.store(0, std::memory_order_relaxed);
+            slots[i].data.store(0, std::memory_order_relaxed);
+            slots[i].command.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /* Private Methods */
+    bool TranspositionTable::packCommand(const Command& command, std::uint64_t& packed) noexcept
+    {
+        int coordinates[] = {command.src.row, command.src.col, command.dst.row, command.dst.col};
+        packed = static_cast<std::uint64_t>(command.type);
+        for(int i = 0; i < 4; i++)
+        {
+            if(coordinates[i] < 0 || coordinates[i] >= (1 << COORDINATE_BITS))
+            {
+                packed = 0;
+                return false;
+            }
+            packed |= static_cast<std::uint64_t>(coordinates[i]) << (2 + i * COORDINATE_BITS);
+        }
+        return true;
+    }
+
+    Command TranspositionTable::unpackCommand(std::uint64_t packed) noexcept
+    {
+        int coordinates[4];
+        for(int i = 0; i < 4; i++)
+        {
+            coordinates[i] = static_cast<int>((packed >> (2 + i * COORDINATE_BITS)) & ((1 << COORDINATE_BITS) - 1));
+        }
+        return Command(static_cast<CommandType>(packed & 0x3), GridPoint(coordinates[0], coordinates[1]),
+                        GridPoint(coordinates[2], coordinates[3]));
+    }
+}
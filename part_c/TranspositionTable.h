@@ -0,0 +1,130 @@
+#ifndef TRANSPOSITION_TABLE_INC
+#define TRANSPOSITION_TABLE_INC
+// Includes
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "Auxiliaries.h"
+#include "Exceptions.h"
+#include "Command.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: TranspositionTable
+     * ---------------------------------------
+     * A fixed-size, lock-free cache of search results keyed by position hashes
+     * (see Game::hash), which any number of threads may probe and store into
+     * concurrently.
+     * Every slot holds two data words and a check word, which is the XOR of
+     * the key and both data words. A reader accepts a slot only if its check
+     * word matches, so a slot that was torn by two racing writers reads as a
+     * miss rather than as a mix of two entries.
+     * A slot is overwritten by every store, except by a shallower result for
+     * the position it already holds.
+     */
+    class TranspositionTable
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        struct Slot
+        {
+            std::atomic<std::uint64_t> check;
+            std::atomic<std::uint64_t> data;
+            std::atomic<std::uint64_t> command;
+        };
+
+        /* Instance variables */
+        std::unique_ptr<Slot[]> slots;
+        std::uint64_t mask;
+
+        /* Private Methods */
+        static const int COORDINATE_BITS = 15;
+        static bool packCommand(const Command& command, std::uint64_t& packed) noexcept;
+        static Command unpackCommand(std::uint64_t packed) noexcept;
+    public:
+        /*
+         * Enum: Bound
+         * ---------------------------------------
+         * How a stored score relates to the true score of the position.
+         */
+        enum Bound { EXACT, LOWER, UPPER };
+
+        /*
+         * Struct: Entry
+         * ---------------------------------------
+         * A search result. The command is only kept if its coordinates are
+         * lower than 2^15.
+         */
+        struct Entry
+        {
+            int score;
+            int depth;              /* Clamped to 0..255 */
+            Bound bound;
+            bool has_command;
+            Command command;
+
+            Entry() : score(0), depth(0), bound(EXACT), has_command(false), command() { }
+        };
+
+        /**************************************/
+        /*     C'tors and D'tors section      */
+        /**************************************/
+        /*
+         * Constructor: TranspositionTable
+         * Usage: TranspositionTable table(log2_size);
+         * ---------------------------------------
+         * Creates an empty table of 2^log2_size slots (24 bytes each).
+         *
+         * Possible exceptions:
+         * IllegalArgument if log2_size is not between 0 and 30.
+         * std::bad_alloc
+         */
+        explicit TranspositionTable(int log2_size);
+        TranspositionTable(const TranspositionTable&) = delete;
+        TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: size
+         * Usage: std::uint64_t slots = table.size();
+         * -----------------------------------
+         * Returns the number of slots of the table.
+         */
+        std::uint64_t size() const noexcept
+        {
+            return mask + 1;
+        }
+
+        /*
+         * Method: store
+         * Usage: table.store(key, entry);
+         * -----------------------------------
+         * Stores entry as the result for the position with hash key.
+         */
+        void store(std::uint64_t key, const Entry& entry) noexcept;
+
+        /*
+         * Method: probe
+         * Usage: if(table.probe(key, entry)) ...
+         * -----------------------------------
+         * Returns true and fills entry if the table holds a result for the
+         * position with hash key, and false otherwise.
+         */
+        bool probe(std::uint64_t key, Entry& entry) const noexcept;
+
+        /*
+         * Method: clear
+         * Usage: table.clear();
+         * -----------------------------------
+         * Empties the table. Must not race with store or probe.
+         */
+        void clear() noexcept;
+    };
+}
+#endif
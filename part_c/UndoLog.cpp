@@ -0,0 +1,118 @@
+#include "UndoLog.h"
+
+namespace mtm
+{
+    /****************************************/
+    /*     Method implementation section    */
+    /****************************************/
+    void UndoLog::begin(std::uint64_t hash)
+    {
+        Mark mark = {static_cast<int>(entries.size()), static_cast<int>(removed.size()), hash};
+        marks.push_back(mark);
+    }
+
+    void UndoLog::commit() noexcept
+    {
+        if(marks.empty())
+        {
+            return;
+        }
+        marks.pop_back();
+        if(marks.empty())
+        {
+            entries.clear();
+            removed.clear();
+        }
+    }
+
+    void UndoLog::rollback(GameBoard& board, CharacterStore& store, OccupancyBitboards& occupancy,
+                            std::uint64_t& hash) noexcept
+    {
+        if(marks.empty())
+        {
+            return;
+        }
+        Mark mark = marks.back();
+        marks.pop_back();
+        for(int i = static_cast<int>(entries.size()) - 1; i >= mark.entries; i--)
+        {
+            const Entry& entry = entries[i];
+            switch(entry.kind)
+            {
+                case CELL:
+                // The cell held entry.value when the transaction recorded it, so a sparse
+                // board still has its tile, and setting it back does not allocate
+                board.set(entry.index, entry.extra, entry.value);
+                break;
+
+                case HEALTH:
+                store.setHealth(entry.index, entry.value);
+                break;
+
+                case AMMO:
+                store.setAmmo(entry.index, entry.value);
+                break;
+
+                case COMBO:
+                store.setComboCount(entry.index, entry.value);
+                break;
+
+                case POSITION:
+                store.setPosition(entry.index, GridPoint(entry.value, entry.extra));
+                break;
+
+                case ADD:
+                store.remove(store.size() - 1);
+                break;
+
+                case REMOVE:
+                {
+                    // The removal moved the last character into the freed index; move it back
+                    // (the store never shrinks its capacity, so adding back does not allocate)
+                    const CharacterStore::Record& record = removed[entry.extra];
+                    CharacterStore::Record moved = (entry.index < store.size())? store.getRecord(entry.index) : record;
+                    store.add(moved.type, moved.team, moved.health, moved.ammo, moved.range, moved.power,
+                                moved.combo_count, GridPoint(moved.row, moved.col));
+                    store.setRecord(entry.index, record);
+                    break;
+                }
+            }
+        }
+        // The teams of the restored cells are only known once the store is restored too
+        for(int i = mark.entries; i < static_cast<int>(entries.size()); i++)
+        {
+            if(entries[i].kind == CELL)
+            {
+                GridPoint cell(entries[i].index, entries[i].extra);
+                int id = board(cell.row, cell.col);
+                occupancy.reset(cell);
+                if(id != CharacterStore::NO_CHARACTER)
+                {
+                    occupancy.set(cell, store.getTeam(id));
+                }
+            }
+        }
+        entries.erase(entries.begin() + mark.entries, entries.end());
+        removed.erase(removed.begin() + mark.removed, removed.end());
+        hash = mark.hash;
+    }
+
+    void UndoLog::clear() noexcept
+    {
+        entries.clear();
+        removed.clear();
+        marks.clear();
+    }
+
+    void UndoLog::recordRemove(const CharacterStore& store, int id)
+    {
+        removed.push_back(store.getRecord(id));
+        try
+        {
+            push(REMOVE, id, 0, static_cast<int>(removed.size()) - 1);
+        } catch (...) {
+            removed.pop_back();
+            throw;
+        }
+    }
+}
@@ -0,0 +1,172 @@
+#ifndef UNDO_LOG_INC
+#define UNDO_LOG_INC
+// Includes
+#include <cstdint>
+#include <vector>
+#include "GameBoard.h"
+#include "CharacterStore.h"
+#include "Bitboard.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: UndoLog
+     * ---------------------------------------
+     * Records the previous value of every board cell and character field a game
+     * mutates, so the mutations can be reverted in reverse order.
+     * The log supports nested transactions: each begin() sets a mark, and
+     * rollback() reverts everything recorded since the latest mark.
+     * Both the memory and the time it takes are proportional to the number of
+     * mutations, and never to the size of the board.
+     */
+    class UndoLog
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        enum EntryKind { CELL, HEALTH, AMMO, COMBO, POSITION, ADD, REMOVE };
+        struct Entry
+        {
+            EntryKind kind;
+            int index;      /* The character index, or the row for CELL */
+            int value;      /* The previous value (or row, for POSITION) */
+            int extra;      /* The column for CELL, the previous column for POSITION, the saved record for REMOVE */
+        };
+        struct Mark
+        {
+            int entries;
+            int removed;
+            std::uint64_t hash;     /* The position hash of the game when the transaction began */
+        };
+
+        /* Instance variables */
+        std::vector<Entry> entries;
+        std::vector<CharacterStore::Record> removed;
+        std::vector<Mark> marks;
+
+        void push(EntryKind kind, int index, int value, int extra = 0)
+        {
+            Entry entry = {kind, index, value, extra};
+            entries.push_back(entry);
+        }
+    public:
+        /**************************************/
+        /*     Method definition section      */
+        /**************************************/
+        /*
+         * Method: isActive
+         * Usage: if(log.isActive()) ...
+         * -----------------------------------
+         * Returns true if and only if at least one transaction is open.
+         */
+        bool isActive() const noexcept
+        {
+            return !marks.empty();
+        }
+
+        /*
+         * Method: depth
+         * Usage: int open_transactions = log.depth();
+         * -----------------------------------
+         * Returns the number of open (nested) transactions.
+         */
+        int depth() const noexcept
+        {
+            return static_cast<int>(marks.size());
+        }
+
+        /*
+         * Method: begin, commit, rollback
+         * Usage: log.begin(hash); ... log.commit();
+         *        log.begin(hash); ... log.rollback(board, store, occupancy, hash);
+         * -----------------------------------
+         * begin opens a (nested) transaction, saving the position hash of the game.
+         * commit closes the innermost transaction and keeps its mutations; they
+         * remain revertible by the enclosing transaction, if any.
+         * rollback reverts every mutation of the innermost transaction on
+         * board and store, brings the occupancy bits of the reverted cells back in
+         * line with them, restores hash to its saved value, and closes it.
+         * Neither commit nor rollback do anything if no transaction is open.
+         *
+         * Possible exceptions:
+         * std::bad_alloc (begin only)
+         */
+        void begin(std::uint64_t hash);
+        void commit() noexcept;
+        void rollback(GameBoard& board, CharacterStore& store, OccupancyBitboards& occupancy,
+                        std::uint64_t& hash) noexcept;
+
+        /*
+         * Method: clear
+         * Usage: log.clear();
+         * -----------------------------------
+         * Forgets every recorded mutation and closes every transaction.
+         */
+        void clear() noexcept;
+
+        /*
+         * Method: forEachRecordedCell
+         * Usage: log.forEachRecordedCell(visit);
+         * -----------------------------------
+         * Calls visit(cell) for every cell recorded by the innermost transaction,
+         * that is, every cell rollback would restore.
+         *
+         * Assumptions on VISITOR:
+         * • Callable as visit(const GridPoint&).
+         */
+        template<typename VISITOR>
+        void forEachRecordedCell(VISITOR visit) const
+        {
+            if(marks.empty())
+            {
+                return;
+            }
+            for(size_t i = marks.back().entries; i < entries.size(); i++)
+            {
+                if(entries[i].kind == CELL)
+                {
+                    visit(GridPoint(entries[i].index, entries[i].extra));
+                }
+            }
+        }
+
+        /*
+         * Methods: record*
+         * -----------------------------------
+         * Record the state about to be overwritten by a mutation.
+         * Must be called before the mutation, and only while a transaction is open.
+         *
+         * Possible exceptions:
+         * std::bad_alloc
+         */
+        void recordCell(const GameBoard& board, const GridPoint& coordinates)
+        {
+            push(CELL, coordinates.row, board(coordinates.row, coordinates.col), coordinates.col);
+        }
+        void recordHealth(const CharacterStore& store, int id)
+        {
+            push(HEALTH, id, store.getHealth(id));
+        }
+        void recordAmmo(const CharacterStore& store, int id)
+        {
+            push(AMMO, id, store.getAmmo(id));
+        }
+        void recordComboCount(const CharacterStore& store, int id)
+        {
+            push(COMBO, id, store.getComboCount(id));
+        }
+        void recordPosition(const CharacterStore& store, int id)
+        {
+            GridPoint position = store.getPosition(id);
+            push(POSITION, id, position.row, position.col);
+        }
+        void recordAdd()
+        {
+            push(ADD, 0, 0);
+        }
+        void recordRemove(const CharacterStore& store, int id);
+    };
+}
+#endif
@@ -0,0 +1,106 @@
+#ifndef ZOBRIST_INC
+#define ZOBRIST_INC
+// Includes
+#include <cstdint>
+#include "Auxiliaries.h"
+//---------
+
+namespace mtm
+{
+    /*
+     * Class: ZobristKeys
+     * ---------------------------------------
+     * The keys of the Zobrist hash of a game position.
+     * The hash of a position is the XOR of the key of every character on the
+     * board, so changing a character updates the hash by XORing its old key out
+     * and its new key in.
+     * A character's key covers its cell, type, team, sniper combo state and
+     * buckets of its health and ammo. Values up to EXACT_VALUES are exact, and
+     * larger values share one bucket per power of two, so two positions that
+     * only differ in large health or ammo values may share a hash.
+     * Instead of a random table per cell (which would not fit large boards), the
+     * keys are derived by a 64-bit mixing function from the packed features.
+     */
+    class ZobristKeys
+    {
+    private:
+        /*********************************/
+        /*        Private Section        */
+        /*********************************/
+        static const std::uint64_t SEED = 0x2545F4914F6CDD1DULL;
+
+        /* SplitMix64 finalizer */
+        static std::uint64_t mix(std::uint64_t value) noexcept
+        {
+            value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+            return value ^ (value >> 31);
+        }
+    public:
+        /* The health and ammo values that get a bucket of their own */
+        static const int EXACT_VALUES = 15;
+
+        /**************************************/
+        /*    Function definition section     */
+        /**************************************/
+        /*
+         * Function: bucket
+         * Usage: int health_bucket = ZobristKeys::bucket(health);
+         * -----------------------------------
+         * Returns the bucket of a health or ammo value, between 0 and 63.
+         */
+        static int bucket(units_t value) noexcept
+        {
+            if(value <= 0)
+            {
+                return 0;
+            }
+            if(value <= EXACT_VALUES)
+            {
+                return value;
+            }
+#if defined(__GNUC__)
+            int bits = 31 - __builtin_clz(static_cast<unsigned int>(value));
+#else
+            int bits = 0;
+            while(value >>= 1)
+            {
+                bits++;
+            }
+#endif
+            return EXACT_VALUES + bits - 3; // 16..31 is the first shared bucket
+        }
+
+        /*
+         * Function: characterKey
+         * Usage: std::uint64_t key = ZobristKeys::characterKey(row, col, type, team, health, ammo, combo_count);
+         * -----------------------------------
+         * Returns the key of a character standing at (row, col).
+         */
+        static std::uint64_t characterKey(int row, int col, CharacterType type, Team team, units_t health,
+                                            units_t ammo, int combo_count) noexcept
+        {
+            std::uint64_t features = static_cast<std::uint64_t>(type)
+                                    | static_cast<std::uint64_t>(team) << 2
+                                    | static_cast<std::uint64_t>(combo_count & 0x7) << 3
+                                    | static_cast<std::uint64_t>(bucket(health)) << 6
+                                    | static_cast<std::uint64_t>(bucket(ammo)) << 12;
+            std::uint64_t cell = static_cast<std::uint64_t>(static_cast<std::uint32_t>(row)) << 32
+                                | static_cast<std::uint32_t>(col);
+            return mix(mix(SEED ^ cell) ^ features);
+        }
+
+        /*
+         * Function: sideKey
+         * Usage: std::uint64_t key = game.hash() ^ ZobristKeys::sideKey(team);
+         * -----------------------------------
+         * Returns a key to mix into a position hash when the team to play is part
+         * of the position, as in a game-tree search.
+         */
+        static std::uint64_t sideKey(Team team) noexcept
+        {
+            return mix(SEED + 1 + static_cast<std::uint64_t>(team));
+        }
+    };
+}
+#endif
@@ -0,0 +1,556 @@
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "Game.h"
+#include "ConcurrentGame.h"
+#include "MatchSimulator.h"
+#include "GameSearch.h"
+#include "TranspositionTable.h"
+
+using namespace mtm;
+using std::cout;
+using std::endl;
+using std::string;
+
+#define ADD_BENCHMARK(x) benchmarks[#x]=x;
+
+// Plenty of ammo so that no benchmark runs dry
+static const units_t UNLIMITED = 1 << 28;
+
+// Runs operation iterations times and returns the average time of a single call in nanoseconds
+template<typename OPERATION>
+double measure(int iterations, OPERATION operation){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++){
+        operation(i);
+    }
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+void report(const string& name, double ns_per_op){
+    cout << std::left << std::setw(48) << name << std::right << std::setw(14)
+         << std::fixed << std::setprecision(1) << ns_per_op << " ns/op" << endl;
+}
+
+void benchmarkSoldierAttack(){
+    int sizes[] = {16, 256, 2048};
+    for (int size : sizes){
+        Game game(size, size);
+        GridPoint soldier(size / 2, size / 2);
+        game.addCharacter(soldier, Game::makeCharacter(SOLDIER, CPP, 1, UNLIMITED, 9, 1));
+        // Enemies around the targets, tough enough to survive the whole run
+        for (int i = 1; i <= 3; i++){
+            game.addCharacter(GridPoint(soldier.row + i, soldier.col + 1),
+                Game::makeCharacter(SOLDIER, PYTHON, UNLIMITED, 0, 0, 0));
+        }
+        GridPoint targets[] = {GridPoint(soldier.row + 2, soldier.col), GridPoint(soldier.row, soldier.col + 5)};
+        double ns = measure(100000, [&](int i){ game.attack(soldier, targets[i % 2]); });
+        report("Soldier attack on " + std::to_string(size) + "x" + std::to_string(size) + " board", ns);
+    }
+}
+
+// Runs the per-command rule checks of the engine over a mixed population of characters,
+// once through the virtual methods of Character and once through the CharacterTraits table
+void benchmarkRuleDispatch(){
+    const int population = 4096;
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    std::vector<std::shared_ptr<Character>> objects;
+    std::vector<CharacterType> type_column;
+    std::vector<Team> team_column;
+    std::vector<units_t> ammo_column;
+    std::vector<units_t> range_column;
+    for (int i = 0; i < population; i++){
+        CharacterType type = types[(i * 7) % 3];
+        Team team = (i % 2 == 0) ? CPP : PYTHON;
+        objects.push_back(Game::makeCharacter(type, team, 10, i % 3, 1 + i % 9, 1));
+        type_column.push_back(type);
+        team_column.push_back(team);
+        ammo_column.push_back(i % 3);
+        range_column.push_back(1 + i % 9);
+    }
+    GridPoint src(0, 0);
+    GridPoint destinations[] = {GridPoint(0, 1), GridPoint(2, 3), GridPoint(4, 4), GridPoint(0, 7)};
+    volatile int sink = 0;
+
+    double ns = measure(4000000, [&](int i){
+        const Character& character = *objects[i % population];
+        const GridPoint& dst = destinations[i % 4];
+        sink = sink + character.isLegalMove(GridPoint::distance(src, dst)) + character.hasEnoughAmmo()
+            + character.isInAttackRange(src, dst) + character.getName();
+    });
+    report("Rule checks through Character virtuals", ns);
+
+    ns = measure(4000000, [&](int i){
+        int id = i % population;
+        const GridPoint& dst = destinations[i % 4];
+        CharacterType type = type_column[id];
+        sink = sink + CharacterRules::isLegalMove(type, GridPoint::distance(src, dst))
+            + CharacterRules::hasEnoughAmmo(type, ammo_column[id])
+            + CharacterRules::isInAttackRange(type, range_column[id], src, dst)
+            + CharacterRules::getName(type, team_column[id]);
+    });
+    report("Rule checks through CharacterTraits table", ns);
+}
+
+void benchmarkCommandThroughput(){
+    Game game(64, 64);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 32; i++){
+        game.addCharacter(GridPoint(2 * i, 0), Game::makeCharacter(types[i % 3], CPP, 10, 0, 4, 1));
+    }
+    double ns = measure(1000000, [&](int i){
+        int row = 2 * ((i / 3) % 32);
+        switch (i % 3){
+            case 0: game.move(GridPoint(row, 0), GridPoint(row, 1)); break;
+            case 1: game.reload(GridPoint(row, 1)); break;
+            default: game.move(GridPoint(row, 1), GridPoint(row, 0)); break;
+        }
+    });
+    report("Game move/reload command", ns);
+}
+
+void benchmarkJournalReplay(){
+    const int commands_count = 1000000;
+    Game game(64, 64);
+    CommandJournal journal;
+    game.attachJournal(&journal);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 32; i++){
+        game.addCharacter(GridPoint(2 * i, 0), Game::makeCharacter(types[i % 3], CPP, 10, 0, 4, 1));
+    }
+    std::vector<Command> commands;
+    for (int i = 0; i < commands_count; i++){
+        int row = 2 * ((i / 3) % 32);
+        switch (i % 3){
+            case 0: commands.push_back(Command::move(GridPoint(row, 0), GridPoint(row, 1))); break;
+            case 1: commands.push_back(Command::reload(GridPoint(row, 1))); break;
+            default: commands.push_back(Command::move(GridPoint(row, 1), GridPoint(row, 0))); break;
+        }
+    }
+    game.execute(commands);
+    double ns = measure(1, [&](int){ journal.replay(); }) / journal.size();
+    report("Journal replay (" + std::to_string(journal.data().size() / journal.size()) + " bytes/record)", ns);
+}
+
+void benchmarkSpeculativeMove(){
+    Game game(256, 256);
+    for (int i = 0; i < 256; i += 2){
+        game.addCharacter(GridPoint(i, i), Game::makeCharacter(SOLDIER, (i % 4 == 0) ? CPP : PYTHON, 10, 1, 3, 1));
+    }
+    double ns = measure(2000, [&](int i){
+        Game speculative(game);
+        int row = 2 * (i % 128);
+        speculative.move(GridPoint(row, row), GridPoint(row, row + 1));
+    });
+    report("Speculative move through a Game copy", ns);
+
+    ns = measure(2000000, [&](int i){
+        int row = 2 * (i % 128);
+        game.begin();
+        game.move(GridPoint(row, row), GridPoint(row, row + 1));
+        game.rollback();
+    });
+    report("Speculative move through begin/rollback", ns);
+}
+
+// Plays the same random matches on a growing number of threads
+void benchmarkMatchSimulator(){
+    SimulationConfig config;
+    config.matches = 4096;
+    config.seed = 1;
+    int hardware_threads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    for (int threads = 1; threads <= hardware_threads; threads *= 2){
+        config.threads = threads;
+        MatchSimulator simulator(config);
+        SimulationStats stats;
+        double ns = measure(1, [&](int){ stats = simulator.run(); }) / config.matches;
+        report("Simulated match on " + std::to_string(threads) + " thread(s)", ns);
+        if (threads == 1){
+            cout << "    CPP wins " << stats.winRate(CPP) * 100 << "%, PYTHON wins " << stats.winRate(PYTHON) * 100
+                 << "%, draws " << stats.drawRate() * 100 << "%, " << stats.averageTurns() << " turns on average" << endl;
+        }
+    }
+}
+
+// Enumerates the legal commands of a team, through the generator and by trying every
+// destination in range through a transaction
+void benchmarkLegalCommands(){
+    Game game(64, 64);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 64; i++){
+        game.addCharacter(GridPoint((i * 7) % 64, (i * 13) % 64),
+            Game::makeCharacter(types[i % 3], (i % 2 == 0) ? CPP : PYTHON, 10, 4, 6, 2));
+    }
+    std::vector<Command> buffer(4096);
+    int count = 0;
+    double ns = measure(20000, [&](int){ count = game.legalCommands(CPP, buffer.data(), 4096); });
+    report("Legal commands of a team (" + std::to_string(count) + ")", ns);
+
+    std::vector<GridPoint> positions;
+    game.characterPositions(CPP, positions);
+    ns = measure(200, [&](int){
+        for (const GridPoint& src : positions){
+            for (int row = std::max(0, src.row - 6); row <= std::min(63, src.row + 6); row++){
+                for (int col = std::max(0, src.col - 6); col <= std::min(63, src.col + 6); col++){
+                    Command commands[] = {Command::move(src, GridPoint(row, col)), Command::attack(src, GridPoint(row, col))};
+                    for (const Command& command : commands){
+                        CommandResult result = SUCCESS;
+                        game.begin();
+                        game.execute(&command, 1, &result);
+                        game.rollback();
+                    }
+                }
+            }
+        }
+    });
+    report("Legal commands of a team, by trial", ns);
+}
+
+// Searches a 12x12 midgame with six characters per team, for a fixed time budget
+void benchmarkGameSearch(){
+    Game game(12, 12);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 6; i++){
+        game.addCharacter(GridPoint(2 + i % 2, 1 + 2 * i), Game::makeCharacter(types[i % 3], CPP, 10, 4, 4, 2));
+        game.addCharacter(GridPoint(8 + i % 2, 1 + 2 * i), Game::makeCharacter(types[i % 3], PYTHON, 10, 4, 4, 2));
+    }
+    SearchLimits limits;
+    limits.max_depth = 64;
+    limits.time_budget_ms = 500;
+    GameSearch search(game, CPP);
+    SearchResult result = search.alphaBeta(limits);
+    report("Alpha-beta node (reached depth " + std::to_string(result.depth) + ")", result.seconds * 1e9 / result.nodes);
+    cout << "    " << static_cast<long long>(result.nodes / result.seconds) << " nodes/s" << endl;
+    result = search.monteCarlo(limits);
+    report("MCTS node", result.seconds * 1e9 / result.nodes);
+    cout << "    " << static_cast<long long>(result.nodes / result.seconds) << " nodes/s" << endl;
+}
+
+// Store/probe cost of the table, and the nodes it saves a fixed-depth alpha-beta search
+void benchmarkTranspositionTable(){
+    TranspositionTable table(20);
+    TranspositionTable::Entry entry;
+    entry.has_command = true;
+    double ns = measure(4000000, [&](int i){
+        entry.score = i;
+        table.store(static_cast<std::uint64_t>(i) * 0x9E3779B97F4A7C15ULL, entry);
+    });
+    report("Transposition table store", ns);
+    long long hits = 0;
+    ns = measure(4000000, [&](int i){ hits += table.probe(static_cast<std::uint64_t>(i) * 0x9E3779B97F4A7C15ULL, entry); });
+    report("Transposition table probe", ns);
+
+    Game game(12, 12);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 4; i++){
+        game.addCharacter(GridPoint(3, 2 + 2 * i), Game::makeCharacter(types[i % 3], CPP, 10, 4, 4, 2));
+        game.addCharacter(GridPoint(8, 2 + 2 * i), Game::makeCharacter(types[i % 3], PYTHON, 10, 4, 4, 2));
+    }
+    SearchLimits limits;
+    limits.max_depth = 4;
+    limits.time_budget_ms = 0;
+    GameSearch search(game, CPP);
+    SearchResult plain = search.alphaBeta(limits);
+    table.clear();
+    search.setTranspositionTable(&table);
+    SearchResult cached = search.alphaBeta(limits);
+    cout << "    depth 4 alpha-beta: " << plain.nodes << " nodes (" << plain.seconds * 1000 << " ms) without the table, "
+         << cached.nodes << " nodes (" << cached.seconds * 1000 << " ms) with it" << endl;
+}
+
+// Range and row queries on boards with 2% of the cells occupied,
+// answered by the occupancy bitboards and by visiting cell by cell
+void benchmarkOccupancyQueries(){
+    int sizes[] = {256, 4096};
+    for (int size : sizes){
+        Game game(size, size);
+        std::vector<signed char> cells(static_cast<size_t>(size) * size, -1); // The team of each cell, for the scans
+        std::uint64_t state = 1;
+        for (long long i = 0; i < static_cast<long long>(size) * size / 50; i++){
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            GridPoint cell(static_cast<int>((state >> 33) % size), static_cast<int>((state >> 13) % size));
+            Team team = (i % 2 == 0) ? CPP : PYTHON;
+            if (cells[static_cast<size_t>(cell.row) * size + cell.col] < 0){
+                game.addCharacter(cell, Game::makeCharacter(SOLDIER, team, 10, 1, 1, 1));
+                cells[static_cast<size_t>(cell.row) * size + cell.col] = static_cast<signed char>(team);
+            }
+        }
+        const OccupancyBitboards& occupancy = game.occupancyBitboards();
+        string board = " on " + std::to_string(size) + "x" + std::to_string(size);
+        long long found = 0;
+        const int radius = 32;
+        auto center = [&](int i){ return GridPoint((i * 7919) % size, (i * 104729) % size); };
+        double ns = measure(20000, [&](int i){ found += occupancy.countInRange(PYTHON, center(i), radius); });
+        report("Enemies within 32, bitboards" + board, ns);
+        ns = measure(2000, [&](int i){
+            GridPoint c = center(i);
+            for (int row = std::max(0, c.row - radius); row <= std::min(size - 1, c.row + radius); row++){
+                int half = radius - std::abs(row - c.row);
+                for (int col = std::max(0, c.col - half); col <= std::min(size - 1, c.col + half); col++){
+                    found += (cells[static_cast<size_t>(row) * size + col] == PYTHON);
+                }
+            }
+        });
+        report("Enemies within 32, cell scan" + board, ns);
+        ns = measure(20000, [&](int i){ found += occupancy.countInRow(PYTHON, center(i).row, 0, size - 1); });
+        report("Enemies in a row, bitboards" + board, ns);
+        ns = measure(2000, [&](int i){
+            const signed char* row = &cells[static_cast<size_t>(center(i).row) * size];
+            for (int col = 0; col < size; col++){
+                found += (row[col] == PYTHON);
+            }
+        });
+        report("Enemies in a row, cell scan" + board, ns);
+        ns = measure(20000, [&](int i){ found += occupancy.countInColumn(PYTHON, center(i).col, 0, size - 1); });
+        report("Enemies in a column, bitboards" + board, ns);
+        if (found == 0){
+            cout << "    (no enemies found)" << endl;
+        }
+    }
+}
+
+// Board memory and command cost of a sparse 100000x100000 world holding 4096 characters,
+// against a dense 4096x4096 board holding the same characters
+void benchmarkSparseBoard(){
+    const int characters = 4096;
+    int sizes[] = {4096, 100000};
+    for (int size : sizes){
+        Game game(size, size);
+        int spacing = size / 64;
+        for (int i = 0; i < characters; i++){
+            game.addCharacter(GridPoint((i / 64) * spacing, (i % 64) * spacing),
+                Game::makeCharacter(SOLDIER, (i % 2 == 0) ? CPP : PYTHON, UNLIMITED, UNLIMITED, 1, 0));
+        }
+        string board = std::to_string(size) + "x" + std::to_string(size) + " board";
+        cout << "    " << board << ": " << game.boardMemoryUsage() / 1024 << " KB of cells and occupancy bits" << endl;
+        double ns = measure(300000, [&](int i){
+            GridPoint src(((i / 3) % characters / 64) * spacing, ((i / 3) % 64) * spacing);
+            switch (i % 3){
+                case 0: game.move(src, GridPoint(src.row + 1, src.col)); break;
+                case 1: game.reload(GridPoint(src.row + 1, src.col)); break;
+                default: game.move(GridPoint(src.row + 1, src.col), src); break;
+            }
+        });
+        report("Game move/reload command on " + board, ns);
+    }
+}
+
+// A stream buffer that discards its output, so the benchmarks measure the formatting only
+class DiscardBuffer : public std::streambuf {
+protected:
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char*, std::streamsize count) override { return count; }
+};
+
+// Frames of a 256x256 board with 1024 characters, 16 moves apart:
+// reprinted in full through operator<<, and drawn as a diff by GameRenderer
+void benchmarkRenderer(){
+    const int size = 256;
+    Game game(size, size);
+    for (int i = 0; i < 1024; i++){
+        game.addCharacter(GridPoint((i / 32) * 8, (i % 32) * 8),
+            Game::makeCharacter(SOLDIER, (i % 2 == 0) ? CPP : PYTHON, 10, 0, 1, 1));
+    }
+    DiscardBuffer discard;
+    std::ostream out(&discard);
+    auto play = [&](int frame){
+        for (int i = 0; i < 16; i++){
+            int unit = ((frame / 2) * 16 + i) % 1024; // Odd frames move back the units of the even ones
+            GridPoint cell((unit / 32) * 8, (unit % 32) * 8);
+            GridPoint other(cell.row + 1, cell.col);
+            if (frame % 2 == 0){
+                game.move(cell, other);
+            } else {
+                game.move(other, cell);
+            }
+        }
+    };
+    double ns = measure(200, [&](int frame){
+        play(frame);
+        out << game;
+    });
+    report("Full frame through operator<<", ns);
+    GameRenderer renderer;
+    game.attachRenderer(&renderer);
+    renderer.render(game, out);
+    size_t bytes = 0;
+    ns = measure(20000, [&](int frame){
+        play(frame);
+        renderer.render(game, out);
+        bytes += renderer.lastFrameSize();
+    });
+    report("Diff frame through GameRenderer", ns);
+    cout << "    " << bytes / 20000 << " bytes per diff frame, " << (size + 2) * (2 * size + 2)
+         << " per full frame" << endl;
+    game.attachRenderer(nullptr);
+}
+
+// Rejected commands (a move too far and an attack out of ammo), reported by
+// exceptions through the throwing API and by status codes through the try* API
+void benchmarkRejectedCommands(){
+    Game game(16, 16);
+    game.addCharacter(GridPoint(0, 0), Game::makeCharacter(SOLDIER, CPP, 10, 0, 2, 1));
+    game.addCharacter(GridPoint(0, 2), Game::makeCharacter(SOLDIER, PYTHON, 10, 0, 2, 1));
+    long long rejected = 0;
+    double ns = measure(200000, [&](int i){
+        try {
+            if (i % 2 == 0){
+                game.move(GridPoint(0, 0), GridPoint(8, 8));
+            } else {
+                game.attack(GridPoint(0, 0), GridPoint(0, 2));
+            }
+        } catch (const GameException&) {
+            rejected++;
+        }
+    });
+    report("Rejected command through exceptions", ns);
+    ns = measure(2000000, [&](int i){
+        CommandResult result = (i % 2 == 0) ? game.tryMove(GridPoint(0, 0), GridPoint(8, 8))
+                                            : game.tryAttack(GridPoint(0, 0), GridPoint(0, 2));
+        rejected += (result != SUCCESS);
+    });
+    report("Rejected command through try*", ns);
+    if (rejected != 2200000){
+        cout << "    (unexpected successes)" << endl;
+    }
+}
+
+// Spawning and cloning characters, through makeCharacter and clone (one pooled block per
+// character) against the plain new + shared_ptr they used to make (two calls to operator new)
+void benchmarkCharacterAllocation(){
+    const int live = 1024;
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    std::vector<std::shared_ptr<Character>> characters(live);
+    double ns = measure(4000000, [&](int i){
+        Team team = (i % 2 == 0) ? CPP : PYTHON;
+        std::shared_ptr<Character>& slot = characters[(i * 7) % live];
+        switch (types[i % 3]){
+            case SOLDIER: slot = std::shared_ptr<Character>(new Soldier(team, 10, 1, 2, 1)); break;
+            case MEDIC: slot = std::shared_ptr<Character>(new Medic(team, 10, 1, 2, 1)); break;
+            case SNIPER: slot = std::shared_ptr<Character>(new Sniper(team, 10, 1, 2, 1)); break;
+        }
+    });
+    report("Spawn through new + shared_ptr", ns);
+    ns = measure(4000000, [&](int i){
+        characters[(i * 7) % live] = Game::makeCharacter(types[i % 3], (i % 2 == 0) ? CPP : PYTHON, 10, 1, 2, 1);
+    });
+    report("Spawn through makeCharacter (pooled)", ns);
+
+    std::vector<std::shared_ptr<Character>> copies(live);
+    ns = measure(4000000, [&](int i){
+        const Character& original = *characters[i % live];
+        std::shared_ptr<Character>& slot = copies[(i * 7) % live];
+        switch (original.getType()){
+            case SOLDIER: slot = std::shared_ptr<Character>(new Soldier(static_cast<const Soldier&>(original))); break;
+            case MEDIC: slot = std::shared_ptr<Character>(new Medic(static_cast<const Medic&>(original))); break;
+            case SNIPER: slot = std::shared_ptr<Character>(new Sniper(static_cast<const Sniper&>(original))); break;
+        }
+    });
+    report("Clone through new + shared_ptr", ns);
+    ns = measure(4000000, [&](int i){
+        copies[(i * 7) % live] = characters[i % live]->clone();
+    });
+    report("Clone through clone (pooled)", ns);
+}
+
+// Random moves, attacks and reloads on a 1024x1024 board, each thread mostly in its own
+// part of the board: through a plain Game, and through a ConcurrentGame from 1 and 4 threads
+void benchmarkConcurrentGame(){
+    const int size = 1024;
+    const int threads = 4;
+    const int per_thread = 200000;
+    Game game(size, size);
+    std::mt19937 generator(42);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < size * size / 4; i++){
+        game.tryAddCharacter(GridPoint(generator() % size, generator() % size), types[generator() % 3],
+                             (i % 2) ? CPP : PYTHON, 1000, UNLIMITED, 1 + generator() % 6, 1);
+    }
+    std::vector<std::vector<Command>> commands(threads);
+    for (int t = 0; t < threads; t++){
+        for (int i = 0; i < per_thread; i++){
+            bool anywhere = generator() % 10 == 0;
+            int row = anywhere ? generator() % size : (t / 2) * (size / 2) + generator() % (size / 2);
+            int col = anywhere ? generator() % size : (t % 2) * (size / 2) + generator() % (size / 2);
+            int offset = static_cast<int>(generator() % 9) - 4;
+            GridPoint src(row, col);
+            GridPoint dst = (generator() % 2) ? GridPoint(row + offset, col) : GridPoint(row, col + offset);
+            CommandType type = static_cast<CommandType>(generator() % 3);
+            commands[t].push_back(Command(type, src, (type == RELOAD) ? src : dst));
+        }
+    }
+
+    Game serial(game);
+    std::vector<CommandResult> results(per_thread);
+    double ns = measure(threads, [&](int t){
+        serial.execute(commands[t].data(), per_thread, results.data());
+    }) / per_thread;
+    report("Command through Game", ns);
+
+    for (int active : {1, threads}){
+        ConcurrentGame shared(game);
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; t++){
+            std::function<void()> work = [&shared, &commands, t, per_thread](){
+                for (const Command& command : commands[t]){
+                    switch (command.type){
+                        case MOVE: shared.tryMove(command.src, command.dst); break;
+                        case ATTACK: shared.tryAttack(command.src, command.dst); break;
+                        case RELOAD: shared.tryReload(command.src); break;
+                    }
+                }
+            };
+            if (active == 1){
+                work();
+            } else {
+                workers.push_back(std::thread(work));
+            }
+        }
+        for (std::thread& worker : workers){
+            worker.join();
+        }
+        std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+        report("Command through ConcurrentGame, " + std::to_string(active) + " thread(s)",
+               std::chrono::duration<double, std::nano>(end - start).count() / (threads * per_thread));
+    }
+    cout << "    (" << std::thread::hardware_concurrency() << " hardware threads)" << endl;
+}
+
+int main(){
+
+    std::map<std::string, std::function<void()>> benchmarks;
+
+    ADD_BENCHMARK(benchmarkSoldierAttack);
+    ADD_BENCHMARK(benchmarkRuleDispatch);
+    ADD_BENCHMARK(benchmarkCommandThroughput);
+    ADD_BENCHMARK(benchmarkJournalReplay);
+    ADD_BENCHMARK(benchmarkSpeculativeMove);
+    ADD_BENCHMARK(benchmarkMatchSimulator);
+    ADD_BENCHMARK(benchmarkGameSearch);
+    ADD_BENCHMARK(benchmarkLegalCommands);
+    ADD_BENCHMARK(benchmarkTranspositionTable);
+    ADD_BENCHMARK(benchmarkOccupancyQueries);
+    ADD_BENCHMARK(benchmarkSparseBoard);
+    ADD_BENCHMARK(benchmarkRenderer);
+    ADD_BENCHMARK(benchmarkRejectedCommands);
+    ADD_BENCHMARK(benchmarkCharacterAllocation);
+    ADD_BENCHMARK(benchmarkConcurrentGame);
+
+    for (std::pair<std::string, std::function<void()>> element : benchmarks)
+    {
+        cout << "Running " << element.first << ":" << endl;
+        element.second();
+    }
+
+    return 0;
+}
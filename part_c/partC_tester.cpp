@@ -3,9 +3,25 @@
 #include <iostream>
 #include <sstream>
 #include <functional>
+#include <climits>
 #include <cmath>
-
+#include <cstring>
+#include <algorithm>
+#include <thread>
+#include <condition_variable>
+#include <mutex>
+#include <random>
+
+#include "AllocationTracker.h"
 #include "Game.h"
+#include "ConcurrentGame.h"
+#include "CommandScript.h"
+#include "MatchSimulator.h"
+#include "ScenarioGenerator.h"
+#include "GameSearch.h"
+#include "Instrumentation.h"
+#include "Matrix.h"
+#include "TranspositionTable.h"
 
 using namespace mtm;
 using std::cout;
@@ -39,6 +55,12 @@ using std::string;
     ": received error: "<<"\""<<e.what()<<"\" while expecting "<<"\""<<#error<<"\""<<endl; return false;}\
     } while(false);
 
+// Asserts that x makes exactly count heap allocations on this thread
+#define ASSERT_ALLOCATIONS(x, count) do{ AllocationCounter allocation_counter; x; \
+    if(allocation_counter.allocations() != static_cast<std::uint64_t>(count)){ \
+    cout<<"Failed assertion at line "<<__LINE__<<" in "<<__func__<<": "<<allocation_counter.allocations()<<\
+    " allocations while expecting "<<(count)<<endl; return false;}} while(false);
+
 #define ADD_TEST(x) tests[#x]=x;
 
 bool checkGameContainsPlayerAt(Game& game, GridPoint point){
@@ -516,6 +538,55 @@ bool testAttackSniper(){
 
 }
 
+bool testAttackSoldierLargeArea(){
+
+    int rows = 12;
+    int cols = 9;
+    Game game(rows, cols);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 1, 300, 2)));
+    for (int i = 0; i < rows; i++){
+        for (int j = 0; j < cols; j++){
+            if (GridPoint(i,j) == GridPoint(0,0)){
+                continue;
+            }
+            ASSERT_NO_ERROR(game.addCharacter(GridPoint(i,j), Game::makeCharacter(MEDIC, PYTHON, 1, 0, 0, 0)));
+        }
+    }
+    std::vector<GridPoint> casualties;
+    ASSERT_NO_ERROR(casualties = game.attack(GridPoint(0,0), GridPoint(rows - 1, 0)));
+    ASSERT_TEST(casualties.size() == size_t(rows * cols - 1));
+    ASSERT_TEST(game.isOver());
+
+    return true;
+
+}
+
+bool testAttackCasualties(){
+
+    Game game(6,6);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 5, 6, 4)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,4), Game::makeCharacter(MEDIC, PYTHON, 4, 0, 1, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,5), Game::makeCharacter(SNIPER, PYTHON, 2, 0, 1, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(1,4), Game::makeCharacter(SOLDIER, PYTHON, 3, 0, 1, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(2,4), Game::makeCharacter(SOLDIER, PYTHON, 3, 0, 1, 1)));
+
+    std::vector<GridPoint> casualties;
+    ASSERT_NO_ERROR(casualties = game.attack(GridPoint(0,0), GridPoint(0,4)));
+    ASSERT_TEST(casualties.size() == 2);
+    ASSERT_TEST(std::find(casualties.begin(), casualties.end(), GridPoint(0,4)) != casualties.end());
+    ASSERT_TEST(std::find(casualties.begin(), casualties.end(), GridPoint(0,5)) != casualties.end());
+    ASSERT_TEST(!checkGameContainsPlayerAt(game, GridPoint(0,4)));
+    ASSERT_TEST(!checkGameContainsPlayerAt(game, GridPoint(0,5)));
+    ASSERT_TEST(checkGameContainsPlayerAt(game, GridPoint(1,4)));
+    ASSERT_TEST(checkGameContainsPlayerAt(game, GridPoint(2,4)));
+
+    ASSERT_NO_ERROR(casualties = game.attack(GridPoint(0,0), GridPoint(3,0)));
+    ASSERT_TEST(casualties.empty());
+
+    return true;
+
+}
+
 bool testReload(){
 
     int rows = 20;
@@ -583,6 +654,1326 @@ bool testReload(){
 
 }
 
+bool testTeamStatistics(){
+
+    Game game(5,5);
+    ASSERT_TEST(game.totalHealth(CPP) == 0);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 3, 3, 4)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,1), Game::makeCharacter(MEDIC, CPP, 5, 2, 3, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,3), Game::makeCharacter(SNIPER, PYTHON, 3, 7, 3, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(4,4), Game::makeCharacter(SOLDIER, PYTHON, 8, 1, 3, 1)));
+
+    ASSERT_TEST(game.totalHealth(CPP) == 15);
+    ASSERT_TEST(game.totalHealth(PYTHON) == 11);
+    ASSERT_TEST(game.totalAmmo(CPP) == 5);
+    ASSERT_TEST(game.totalAmmo(PYTHON) == 8);
+
+    std::vector<GridPoint> weak = game.charactersBelowHealth(6);
+    ASSERT_TEST(weak.size() == 2);
+    ASSERT_TEST(std::find(weak.begin(), weak.end(), GridPoint(0,1)) != weak.end());
+    ASSERT_TEST(std::find(weak.begin(), weak.end(), GridPoint(0,3)) != weak.end());
+
+    // The sniper dies, and its statistics leave with it
+    ASSERT_NO_ERROR(game.attack(GridPoint(0,0), GridPoint(0,3)));
+    ASSERT_TEST(game.totalHealth(PYTHON) == 8);
+    ASSERT_TEST(game.totalAmmo(CPP) == 4);
+    ASSERT_NO_ERROR(game.move(GridPoint(4,4), GridPoint(3,3)));
+    weak = game.charactersBelowHealth(9);
+    ASSERT_TEST(weak.size() == 2);
+    ASSERT_TEST(std::find(weak.begin(), weak.end(), GridPoint(3,3)) != weak.end());
+
+    return true;
+
+}
+
+bool testMatchSimulator(){
+
+    SimulationConfig config;
+    config.height = 8;
+    config.width = 8;
+    config.characters_per_team = 4;
+    config.max_turns = 300;
+    config.matches = 200;
+    config.seed = 7;
+
+    config.threads = 1;
+    SimulationStats serial = MatchSimulator(config).run();
+    ASSERT_TEST(serial.matches == 200);
+    ASSERT_TEST(serial.wins[CPP] + serial.wins[PYTHON] + serial.draws == 200);
+    ASSERT_TEST(serial.wins[CPP] + serial.wins[PYTHON] > 0);
+    ASSERT_TEST(serial.min_turns > 0 && serial.min_turns <= serial.averageTurns());
+    ASSERT_TEST(serial.averageTurns() <= serial.max_turns && serial.max_turns <= 300);
+
+    // Every match depends on the seed alone, so the thread count does not change the outcome
+    config.threads = 4;
+    SimulationStats parallel = MatchSimulator(config).run();
+    ASSERT_TEST(parallel.matches == serial.matches);
+    ASSERT_TEST(parallel.wins[CPP] == serial.wins[CPP] && parallel.wins[PYTHON] == serial.wins[PYTHON]);
+    ASSERT_TEST(parallel.draws == serial.draws && parallel.total_turns == serial.total_turns);
+    ASSERT_TEST(parallel.min_turns == serial.min_turns && parallel.max_turns == serial.max_turns);
+
+    config.seed = 8;
+    SimulationStats other = MatchSimulator(config).run();
+    ASSERT_TEST(other.total_turns != serial.total_turns);
+
+    config.characters_per_team = 33;
+    ASSERT_ERROR(MatchSimulator simulator(config), IllegalArgument);
+    config.characters_per_team = 4;
+    config.unit_stats[SNIPER].health = 0;
+    ASSERT_ERROR(MatchSimulator simulator(config), IllegalArgument);
+
+    return true;
+
+}
+
+bool testExecuteBatch(){
+
+    Game game(6,6);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 0, 3, 5)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,3), Game::makeCharacter(MEDIC, PYTHON, 5, 0, 2, 1)));
+
+    std::vector<Command> commands;
+    commands.push_back(Command::attack(GridPoint(0,0), GridPoint(0,3)));
+    commands.push_back(Command::reload(GridPoint(0,0)));
+    commands.push_back(Command::move(GridPoint(0,0), GridPoint(5,5)));
+    commands.push_back(Command::move(GridPoint(0,0), GridPoint(0,3)));
+    commands.push_back(Command::attack(GridPoint(0,0), GridPoint(1,1)));
+    commands.push_back(Command::attack(GridPoint(0,0), GridPoint(0,3)));
+    commands.push_back(Command::move(GridPoint(0,0), GridPoint(0,3)));
+    commands.push_back(Command::reload(GridPoint(7,0)));
+    commands.push_back(Command::reload(GridPoint(0,0)));
+
+    std::vector<CommandResult> results;
+    ASSERT_NO_ERROR(results = game.execute(commands));
+    ASSERT_TEST(results.size() == commands.size());
+    ASSERT_TEST(results[0] == OUT_OF_AMMO);
+    ASSERT_TEST(results[1] == SUCCESS);
+    ASSERT_TEST(results[2] == MOVE_TOO_FAR);
+    ASSERT_TEST(results[3] == CELL_OCCUPIED);
+    ASSERT_TEST(results[4] == ILLEGAL_TARGET);
+    ASSERT_TEST(results[5] == SUCCESS);
+    // The medic died in the previous command, so its cell is free again
+    ASSERT_TEST(results[6] == SUCCESS);
+    ASSERT_TEST(results[7] == ILLEGAL_CELL);
+    ASSERT_TEST(results[8] == CELL_EMPTY);
+
+    ASSERT_TEST(checkGameContainsPlayerAt(game, GridPoint(0,3)));
+    ASSERT_TEST(game.isOver());
+    ASSERT_TEST(game.execute(std::vector<Command>()).empty());
+
+    return true;
+
+}
+
+bool testJournalReplay(){
+
+    Game game(8,8);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(1,1), Game::makeCharacter(SNIPER, CPP, 10, 3, 4, 3)));
+    CommandJournal journal;
+    ASSERT_NO_ERROR(game.attachJournal(&journal));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(1,4), Game::makeCharacter(MEDIC, PYTHON, 10, 1, 4, 2)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(5,4), Game::makeCharacter(SOLDIER, PYTHON, 4, 1, 4, 2)));
+    ASSERT_ERROR(game.addCharacter(GridPoint(5,4), Game::makeCharacter(SOLDIER, CPP, 4, 1, 4, 2)), CellOccupied);
+    ASSERT_NO_ERROR(game.attack(GridPoint(1,1), GridPoint(1,4)));
+    ASSERT_NO_ERROR(game.attack(GridPoint(1,1), GridPoint(1,4)));
+    ASSERT_ERROR(game.attack(GridPoint(1,1), GridPoint(1,2)), OutOfRange);
+    ASSERT_NO_ERROR(game.move(GridPoint(5,4), GridPoint(3,3)));
+    ASSERT_ERROR(game.move(GridPoint(-1,6), GridPoint(3,6)), IllegalCell);
+    ASSERT_NO_ERROR(game.attack(GridPoint(1,1), GridPoint(3,3)));
+    ASSERT_ERROR(game.attack(GridPoint(1,1), GridPoint(3,3)), OutOfAmmo);
+    std::vector<Command> commands;
+    commands.push_back(Command::reload(GridPoint(1,1)));
+    commands.push_back(Command::attack(GridPoint(1,1), GridPoint(1,4)));
+    commands.push_back(Command::reload(GridPoint(5,5)));
+    ASSERT_NO_ERROR(game.execute(commands));
+    ASSERT_TEST(journal.size() == 15);
+
+    std::stringstream binary;
+    journal.write(binary);
+    CommandJournal loaded = CommandJournal::read(binary);
+    ASSERT_TEST(loaded.data() == journal.data());
+
+    Game replayed = loaded.replay();
+    std::stringstream expected, actual;
+    expected << game;
+    actual << replayed;
+    ASSERT_TEST(expected.str() == actual.str());
+    ASSERT_TEST(replayed.totalHealth(CPP) == game.totalHealth(CPP));
+    ASSERT_TEST(replayed.totalHealth(PYTHON) == game.totalHealth(PYTHON));
+    ASSERT_TEST(replayed.totalAmmo(CPP) == game.totalAmmo(CPP));
+
+    // Copies are not recorded, assignments into the recorded game are
+    Game copy(game);
+    ASSERT_NO_ERROR(copy.reload(GridPoint(1,1)));
+    ASSERT_TEST(journal.size() == 15);
+    ASSERT_NO_ERROR(game = Game(3,3));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(2,2), Game::makeCharacter(MEDIC, CPP, 1, 1, 1, 1)));
+    ASSERT_TEST(journal.replay().isOver());
+
+    std::string truncated = binary.str().substr(0, binary.str().size() - 1);
+    std::stringstream corrupt(truncated);
+    try {
+        CommandJournal::read(corrupt).replay();
+        ASSERT_TEST(false);
+    }
+    catch(CommandJournal::CorruptJournal&){ }
+
+    // A header claiming a huge body fails on the missing bytes, without allocating for them
+    std::string huge_body = truncated;
+    huge_body[4] = huge_body[5] = huge_body[6] = huge_body[7] = '\xff'; //The byte count of the header
+    std::stringstream huge(huge_body);
+    AllocationCounter allocation_counter;
+    ASSERT_ERROR(CommandJournal::read(huge), CommandJournal::CorruptJournal);
+    ASSERT_TEST(allocation_counter.bytes() < 1024 * 1024);
+
+    return true;
+
+}
+
+string gameToString(Game& game){
+    std::stringstream buffer;
+    buffer << game;
+    return buffer.str();
+}
+
+bool testTransactions(){
+
+    Game game(6,6);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 2, 6, 4)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,4), Game::makeCharacter(MEDIC, PYTHON, 4, 1, 3, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,5), Game::makeCharacter(SNIPER, PYTHON, 2, 1, 5, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(5,5), Game::makeCharacter(SNIPER, CPP, 9, 3, 6, 2)));
+    string initial = gameToString(game);
+
+    ASSERT_TEST(!game.inTransaction());
+    ASSERT_NO_ERROR(game.rollback());
+    ASSERT_NO_ERROR(game.begin());
+    ASSERT_TEST(game.inTransaction());
+    ASSERT_NO_ERROR(game.attack(GridPoint(0,0), GridPoint(0,4)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(3,3), Game::makeCharacter(MEDIC, CPP, 3, 3, 3, 3)));
+    ASSERT_NO_ERROR(game.move(GridPoint(5,5), GridPoint(4,2)));
+    ASSERT_ERROR(game.attack(GridPoint(4,2), GridPoint(0,0)), IllegalTarget);
+    ASSERT_NO_ERROR(game.reload(GridPoint(0,0)));
+    ASSERT_TEST(game.isOver());
+    ASSERT_NO_ERROR(game.rollback());
+    ASSERT_TEST(!game.inTransaction());
+
+    ASSERT_TEST(gameToString(game) == initial);
+    ASSERT_TEST(game.totalHealth(CPP) == 19);
+    ASSERT_TEST(game.totalHealth(PYTHON) == 6);
+    ASSERT_TEST(game.totalAmmo(CPP) == 5);
+    ASSERT_TEST(game.totalAmmo(PYTHON) == 2);
+
+    // Nested transactions: the inner rollback keeps the outer changes
+    ASSERT_NO_ERROR(game.begin());
+    ASSERT_NO_ERROR(game.move(GridPoint(5,5), GridPoint(5,2)));
+    ASSERT_NO_ERROR(game.begin());
+    ASSERT_NO_ERROR(game.attack(GridPoint(0,0), GridPoint(0,4)));
+    ASSERT_NO_ERROR(game.rollback());
+    ASSERT_TEST(game.inTransaction());
+    ASSERT_NO_ERROR(game.commit());
+    ASSERT_TEST(!game.inTransaction());
+    ASSERT_TEST(checkGameContainsPlayerAt(game, GridPoint(5,2)));
+    ASSERT_TEST(checkGameContainsPlayerAt(game, GridPoint(0,4)));
+    ASSERT_TEST(checkGameContainsPlayerAt(game, GridPoint(0,5)));
+
+    // The game keeps working after a rollback
+    ASSERT_NO_ERROR(game.attack(GridPoint(0,0), GridPoint(0,4)));
+    ASSERT_TEST(game.totalHealth(PYTHON) == 0);
+    ASSERT_TEST(game.isOver());
+
+    return true;
+
+}
+
+bool testCharacterPool(){
+
+    // A destroyed character's block is the next one handed out on the same thread
+    std::shared_ptr<Character> soldier = Game::makeCharacter(SOLDIER, CPP, 7, 3, 2, 1);
+    const Character* address = soldier.get();
+    soldier.reset();
+    soldier = Game::makeCharacter(SOLDIER, PYTHON, 5, 1, 4, 2);
+    ASSERT_TEST(soldier.get() == address);
+    ASSERT_TEST(soldier->getHealth() == 5 && soldier->getAmmo() == 1 && soldier->getTeam() == PYTHON);
+
+    // Clones are independent copies of the right type
+    std::shared_ptr<Character> copy = soldier->clone();
+    ASSERT_TEST(copy.get() != soldier.get());
+    ASSERT_TEST(copy->getType() == SOLDIER && copy->getName() == soldier->getName());
+    copy->setHealth(1);
+    ASSERT_TEST(soldier->getHealth() == 5);
+    std::shared_ptr<Character> medic = Game::makeCharacter(MEDIC, CPP, 3, 2, 1, 1);
+    std::shared_ptr<Character> sniper = Game::makeCharacter(SNIPER, CPP, 3, 2, 4, 1);
+    ASSERT_TEST(medic->clone()->getType() == MEDIC && sniper->clone()->getType() == SNIPER);
+
+    // Characters made on threads that exit, then freed and made again here and on other threads
+    const int per_thread = 1000;
+    std::vector<std::shared_ptr<Character>> made(4 * per_thread);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++){
+        threads.push_back(std::thread([&made, t, per_thread](){
+            CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+            for (int i = 0; i < per_thread; i++){
+                made[t * per_thread + i] = Game::makeCharacter(types[i % 3], CPP, 1 + t * per_thread + i, 0, 1, 1);
+            }
+        }));
+    }
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+    threads.clear();
+    for (int i = 0; i < 4 * per_thread; i++){
+        ASSERT_TEST(made[i]->getHealth() == 1 + i);
+    }
+    for (int i = 0; i < 4 * per_thread; i += 2){
+        made[i] = made[i + 1]->clone();
+    }
+    for (int t = 0; t < 2; t++){
+        threads.push_back(std::thread([&made, t, per_thread](){
+            for (int i = t; i < 4 * per_thread; i += 2){
+                made[i].reset();
+            }
+            for (int i = t; i < 4 * per_thread; i += 2){
+                made[i] = Game::makeCharacter(SOLDIER, CPP, 1 + i, 0, 1, 1);
+            }
+        }));
+    }
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+    for (int i = 0; i < 4 * per_thread; i++){
+        ASSERT_TEST(made[i]->getHealth() == 1 + i && made[i]->getType() == SOLDIER);
+    }
+    made.clear();
+
+    // A thread making waves of characters that another thread frees gets the blocks back
+    const int waves = 200, per_wave = 100;
+    std::vector<std::shared_ptr<Character>> wave;
+    wave.reserve(per_wave);
+    std::mutex handoff_lock;
+    std::condition_variable handoff;
+    int produced = 0, consumed = 0;
+    std::uint64_t producer_allocations = 0;
+    std::thread producer([&](){
+        AllocationCounter allocation_counter;
+        for (int i = 0; i < waves; i++){
+            std::unique_lock<std::mutex> lock(handoff_lock);
+            handoff.wait(lock, [&](){ return consumed == produced; });
+            for (int j = 0; j < per_wave; j++){
+                wave.push_back(Game::makeCharacter(SOLDIER, CPP, 1, 0, 1, 1));
+            }
+            produced++;
+            handoff.notify_all();
+        }
+        producer_allocations = allocation_counter.allocations();
+    });
+    std::thread consumer([&](){
+        for (int i = 0; i < waves; i++){
+            std::unique_lock<std::mutex> lock(handoff_lock);
+            handoff.wait(lock, [&](){ return produced > consumed; });
+            wave.clear();
+            consumed++;
+            handoff.notify_all();
+        }
+    });
+    producer.join();
+    consumer.join();
+    // The waves need a few chunks of 64 blocks, where hoarding would take two per wave
+    ASSERT_TEST(producer_allocations <= 8);
+
+    return true;
+
+}
+
+bool testConcurrentGame(){
+
+    // A 256x256 board is 16 regions; the threads mostly play in their own quarter, and sometimes anywhere
+    const int size = 256;
+    Game game(size, size);
+    std::mt19937 generator(41);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 20000; i++){
+        GridPoint cell(generator() % size, generator() % size);
+        game.tryAddCharacter(cell, types[generator() % 3], (i % 2) ? CPP : PYTHON,
+                             1 + generator() % 6, generator() % 4, 1 + generator() % 6, 1 + generator() % 4);
+    }
+    ConcurrentGame shared(game);
+    ASSERT_TEST(shared.hash() == game.hash());
+    CommandJournal journal;
+    shared.attachJournal(&journal);
+
+    const int per_thread = 6000;
+    int successes[4] = {0, 0, 0, 0};
+    int deaths[4] = {0, 0, 0, 0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; t++){
+        threads.push_back(std::thread([&shared, &successes, &deaths, t, per_thread](){
+            std::mt19937 local(t);
+            std::vector<GridPoint> casualties;
+            for (int i = 0; i < per_thread; i++){
+                bool anywhere = local() % 5 == 0;
+                int row = anywhere ? local() % size : (t / 2) * (size / 2) + local() % (size / 2);
+                int col = anywhere ? local() % size : (t % 2) * (size / 2) + local() % (size / 2);
+                int offset = static_cast<int>(local() % 9) - 4;
+                GridPoint src(row, col);
+                GridPoint dst = (local() % 2) ? GridPoint(row + offset, col) : GridPoint(row, col + offset);
+                CommandResult result;
+                switch (local() % 3){
+                    case 0: result = shared.tryMove(src, dst); break;
+                    case 1: result = shared.tryAttack(src, dst, &casualties); break;
+                    default: result = shared.tryReload(src); break;
+                }
+                successes[t] += (result == SUCCESS);
+                deaths[t] += static_cast<int>(casualties.size());
+                casualties.clear();
+            }
+        }));
+    }
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+    ASSERT_TEST(successes[0] > 0 && successes[1] > 0 && successes[2] > 0 && successes[3] > 0);
+    ASSERT_TEST(deaths[0] + deaths[1] + deaths[2] + deaths[3] > 0);
+
+    // Replaying the journal serially gives every command the same outcome, and ends in the same position
+    Game replayed(1, 1);
+    ASSERT_NO_ERROR(replayed = journal.replay());
+    Game result = shared.snapshot();
+    ASSERT_TEST(result.hash() == replayed.hash());
+    ASSERT_TEST(result.hash() == result.computeHash());
+    ASSERT_TEST(shared.hash() == result.hash());
+    for (Team team : {CPP, PYTHON}){
+        ASSERT_TEST(result.characterCount(team) == replayed.characterCount(team));
+        ASSERT_TEST(result.totalHealth(team) == replayed.totalHealth(team));
+        ASSERT_TEST(result.totalAmmo(team) == replayed.totalAmmo(team));
+    }
+    ASSERT_TEST(gameToString(result) == gameToString(replayed));
+
+    // Characters can still be added, and the snapshot plays on as a plain game
+    ASSERT_TEST(shared.tryAddCharacter(GridPoint(0, 0), SOLDIER, CPP, 1, 1, 1, 1) != ILLEGAL_ARGUMENT);
+    ASSERT_TEST(shared.tryAddCharacter(GridPoint(size, 0), SOLDIER, CPP, 1, 1, 1, 1) == ILLEGAL_CELL);
+    Game after = shared.snapshot();
+    ASSERT_TEST(after.hash() == after.computeHash());
+    ASSERT_NO_ERROR(journal.replay());
+
+    // Commands out of the board are recorded while other threads add characters and attach the journal
+    const int off_board = 3000, added = 100;
+    int records = journal.size();
+    std::thread outside([&shared, off_board, size](){
+        for (int i = 0; i < off_board; i++){
+            GridPoint out(size + i % 7, -1 - i % 5);
+            switch (i % 3){
+                case 0: shared.tryMove(out, GridPoint(0, 0)); break;
+                case 1: shared.tryAttack(GridPoint(0, 0), out, nullptr); break;
+                default: shared.tryReload(out); break;
+            }
+        }
+    });
+    std::thread adding([&shared, &journal, added](){
+        for (int i = 0; i < added; i++){
+            shared.tryAddCharacter(GridPoint(i % size, (i * 37) % size), MEDIC, PYTHON, 2, 1, 1, 1);
+            if (i % 10 == 0){
+                shared.attachJournal(&journal);
+            }
+        }
+    });
+    outside.join();
+    adding.join();
+    ASSERT_TEST(journal.size() > records + off_board + added); //Attaching also records a snapshot
+    after = shared.snapshot();
+    ASSERT_NO_ERROR(replayed = journal.replay());
+    ASSERT_TEST(gameToString(after) == gameToString(replayed));
+
+    return true;
+
+}
+
+bool testCommandScript(){
+
+    const char text[] =
+        "# A short skirmish\n"
+        "board 6 6\n"
+        "add 0 0 soldier cpp 10 2 4 3   # the attacker\n"
+        "ADD 0 3 Medic Python 2 1 2 1\n"
+        "add 0 3 sniper cpp 5 1 3 1\n"
+        "add 5 5 sniper python 0 1 3 1\n"
+        "\r\n"
+        "   attack 0 0 0 3\n"
+        "move 0 0 9 9\n"
+        "reload 0 0";
+    CommandScript script = CommandScript::parse(text, sizeof(text) - 1);
+    ASSERT_TEST(script.size() == 8);
+    ASSERT_TEST(script[1].kind == CommandScript::ADD && script[1].type == SOLDIER && script[1].power == 3);
+    ASSERT_TEST(script[2].type == MEDIC && script[2].team == PYTHON);
+    ASSERT_TEST(script[5].kind == CommandScript::COMMAND && script[5].command.type == ATTACK);
+
+    CommandScript::Statistics statistics;
+    CommandJournal journal;
+    Game game = script.run(statistics, &journal);
+    ASSERT_TEST(statistics.additions == 4 && statistics.commands == 3);
+    ASSERT_TEST(statistics.outcomes[SUCCESS] == 4);
+    ASSERT_TEST(statistics.outcomes[CELL_OCCUPIED] == 1 && statistics.outcomes[ILLEGAL_ARGUMENT] == 1);
+    ASSERT_TEST(statistics.outcomes[ILLEGAL_CELL] == 1);
+    ASSERT_TEST(game.isOver());
+
+    // The recorded run replays straight from its written bytes
+    std::stringstream binary;
+    journal.write(binary);
+    std::string bytes = binary.str();
+    const unsigned char* data = reinterpret_cast<const unsigned char*>(bytes.data());
+    ASSERT_TEST(CommandJournal::recordCount(data, bytes.size()) == journal.size());
+    Game replayed = CommandJournal::replay(data, bytes.size());
+    ASSERT_TEST(gameToString(replayed) == gameToString(game));
+    ASSERT_ERROR(CommandJournal::replay(data, bytes.size() - 1), CommandJournal::CorruptJournal);
+
+    const char* broken[] = {"move 0 0 1 1", "board 0 5", "board 5 5\njump 1 1", "board 5 5\nreload 1",
+                            "board 5 5\nreload 1 x", "board 5 5\nadd 1 1 wizard cpp 1 1 1 1",
+                            "board 5 5\nmove 1 1 2 2 3", "board 5 5\nreload 99999999999 1", "# nothing"};
+    for (const char* source : broken){
+        ASSERT_ERROR(CommandScript::parse(source, std::strlen(source)), CommandScript::SyntaxError);
+    }
+    try {
+        const char* source = "board 5 5\n\n# comment\nmove 1 1";
+        CommandScript::parse(source, std::strlen(source));
+        ASSERT_TEST(false);
+    }
+    catch (const CommandScript::SyntaxError& e){
+        ASSERT_TEST(std::string(e.what()).find("Line 4") != std::string::npos);
+    }
+
+    return true;
+
+}
+
+bool testAllocations(){
+
+    Game game(8,8);
+    game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 100, 1000, 3, 1));
+    game.addCharacter(GridPoint(0,2), Game::makeCharacter(SOLDIER, PYTHON, 100, 1000, 3, 1));
+    game.addCharacter(GridPoint(4,4), Game::makeCharacter(MEDIC, CPP, 100, 1000, 3, 1));
+    game.addCharacter(GridPoint(5,5), Game::makeCharacter(SOLDIER, CPP, 100, 1000, 3, 1));
+    game.addCharacter(GridPoint(7,7), Game::makeCharacter(SNIPER, PYTHON, 100, 1000, 5, 1));
+    Command commands[] = {Command::move(GridPoint(0,0), GridPoint(1,0)), Command::attack(GridPoint(1,0), GridPoint(1,2)),
+                          Command::move(GridPoint(1,0), GridPoint(0,0)), Command::reload(GridPoint(0,0))};
+    CommandResult results[4];
+    std::vector<Command> legal(128);
+    // Warm up the buffers of the game and the tables built on first use, which are kept from then on
+    game.execute(commands, 4, results);
+    game.legalCommands(PYTHON, legal.data(), 128);
+    ASSERT_TEST(game.tryAttack(GridPoint(0,0), GridPoint(0,2)) == SUCCESS);
+
+    // The commands of the game do not allocate, successful or not
+    ASSERT_ALLOCATIONS(game.move(GridPoint(4,4), GridPoint(4,5)), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.tryMove(GridPoint(4,5), GridPoint(4,4)) == SUCCESS), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.tryAttack(GridPoint(0,0), GridPoint(0,2)) == SUCCESS), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.tryAttack(GridPoint(4,4), GridPoint(5,5)) == SUCCESS), 0);
+    ASSERT_ALLOCATIONS(game.reload(GridPoint(7,7)), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.tryMove(GridPoint(0,0), GridPoint(0,2)) == CELL_OCCUPIED), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.tryAttack(GridPoint(7,7), GridPoint(0,0)) == OUT_OF_RANGE), 0);
+    ASSERT_ALLOCATIONS(game.execute(commands, 4, results), 0);
+    ASSERT_TEST(std::count(results, results + 4, SUCCESS) == 4);
+
+    // Neither do the queries
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.legalCommands(CPP, legal.data(), 128) > 0), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.legalCommands(GridPoint(7,7), legal.data(), 128) > 0), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(!game.isOver()), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.hash() == game.computeHash()), 0);
+    ASSERT_ALLOCATIONS(ASSERT_TEST(game.characterCount(PYTHON) == 2), 0);
+
+    // A copy of a matrix is a single allocation, and reading it none
+    Matrix<int> a(Dimensions(3, 4), 1);
+    Matrix<int> b(Dimensions(3, 4), 2);
+    ASSERT_ALLOCATIONS(Matrix<int> sum = a + b; ASSERT_TEST(sum(2, 3) == 3), 1);
+    ASSERT_ALLOCATIONS(Matrix<int> copy(a); ASSERT_TEST(copy(0, 0) == 1), 1);
+    int total = 0;
+    ASSERT_ALLOCATIONS(for (int element : a){ total += element; }, 0);
+    ASSERT_ALLOCATIONS(total += a(1, 2), 0);
+    ASSERT_TEST(total == 13);
+
+    return true;
+
+}
+
+bool testTryCommands(){
+
+    Game game(5,5);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(0,0), SOLDIER, CPP, 10, 2, 2, 4) == SUCCESS);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(0,2), Game::makeCharacter(MEDIC, PYTHON, 3, 1, 3, 1)) == SUCCESS);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(4,4), SNIPER, PYTHON, 10, 0, 4, 2) == SUCCESS);
+    string initial = gameToString(game);
+    std::uint64_t initial_hash = game.hash();
+
+    // Every rejection is reported by its status, and leaves the game unchanged
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(5,0), SOLDIER, CPP, 1, 1, 1, 1) == ILLEGAL_CELL);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(0,2), SOLDIER, CPP, 1, 1, 1, 1) == CELL_OCCUPIED);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(1,1), SOLDIER, CPP, 0, 1, 1, 1) == ILLEGAL_ARGUMENT);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(1,1), nullptr) == SUCCESS);
+    ASSERT_TEST(game.tryMove(GridPoint(-1,0), GridPoint(0,1)) == ILLEGAL_CELL);
+    ASSERT_TEST(game.tryMove(GridPoint(1,1), GridPoint(0,1)) == CELL_EMPTY);
+    ASSERT_TEST(game.tryMove(GridPoint(0,0), GridPoint(4,0)) == MOVE_TOO_FAR);
+    ASSERT_TEST(game.tryMove(GridPoint(0,0), GridPoint(0,2)) == CELL_OCCUPIED);
+    ASSERT_TEST(game.tryAttack(GridPoint(0,0), GridPoint(0,4)) == OUT_OF_RANGE);
+    ASSERT_TEST(game.tryAttack(GridPoint(0,0), GridPoint(1,1)) == ILLEGAL_TARGET);
+    ASSERT_TEST(game.tryAttack(GridPoint(4,4), GridPoint(0,4)) == OUT_OF_AMMO);
+    ASSERT_TEST(game.tryAttack(GridPoint(0,2), GridPoint(0,2)) == ILLEGAL_TARGET);
+    ASSERT_TEST(game.tryReload(GridPoint(2,2)) == CELL_EMPTY);
+    ASSERT_TEST(gameToString(game) == initial && game.hash() == initial_hash);
+
+    // The throwing API raises the exception matching the status
+    ASSERT_ERROR(game.move(GridPoint(0,0), GridPoint(4,0)), MoveTooFar);
+    ASSERT_ERROR(game.attack(GridPoint(4,4), GridPoint(0,4)), OutOfAmmo);
+    ASSERT_ERROR(game.reload(GridPoint(2,2)), CellEmpty);
+
+    // Successful commands, with the casualties of an attack
+    std::vector<GridPoint> casualties(3, GridPoint(9,9));
+    ASSERT_TEST(game.tryAttack(GridPoint(0,0), GridPoint(0,2), &casualties) == SUCCESS);
+    ASSERT_TEST(casualties.size() == 1 && casualties[0] == GridPoint(0,2));
+    ASSERT_TEST(game.tryReload(GridPoint(4,4)) == SUCCESS && game.tryMove(GridPoint(4,4), GridPoint(2,4)) == SUCCESS);
+    ASSERT_TEST(game.tryAttack(GridPoint(0,0), GridPoint(0,1), &casualties) == SUCCESS && casualties.empty());
+    Team winner = CPP;
+    ASSERT_TEST(!game.isOver(&winner));
+
+    return true;
+
+}
+
+// Writes every event of a game as a line of text
+class EventLog : public GameEventListener {
+public:
+    std::vector<string> lines;
+
+    static string point(const GridPoint& point){
+        return std::to_string(point.row) + "," + std::to_string(point.col);
+    }
+    void onDamage(const DamageEvent& event) noexcept override {
+        lines.push_back((event.splash ? "splash " : "damage ") + point(event.attacker) + " " + point(event.target)
+            + " " + std::to_string(event.amount) + " " + std::to_string(event.health));
+    }
+    void onHeal(const HealEvent& event) noexcept override {
+        lines.push_back("heal " + point(event.healer) + " " + point(event.target)
+            + " " + std::to_string(event.amount) + " " + std::to_string(event.health));
+    }
+    void onDeath(const DeathEvent& event) noexcept override {
+        lines.push_back("death " + point(event.coordinates) + " " + CharacterRules::getName(event.type, event.team));
+    }
+    void onMove(const MoveEvent& event) noexcept override {
+        lines.push_back("move " + point(event.src) + " " + point(event.dst) + " "
+            + CharacterRules::getName(event.type, event.team));
+    }
+    void onReload(const ReloadEvent& event) noexcept override {
+        lines.push_back("reload " + point(event.coordinates) + " " + std::to_string(event.ammo));
+    }
+};
+
+bool testGameEvents(){
+
+    Game game(5,5);
+    EventLog log;
+    game.attachListener(&log);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(0,0), SOLDIER, CPP, 10, 2, 2, 4) == SUCCESS);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(0,2), MEDIC, PYTHON, 3, 1, 3, 1) == SUCCESS);
+    ASSERT_TEST(game.tryAddCharacter(GridPoint(1,2), SNIPER, PYTHON, 10, 0, 4, 2) == SUCCESS);
+
+    game.attack(GridPoint(0,2), GridPoint(1,2));
+    game.attack(GridPoint(0,0), GridPoint(0,2));
+    ASSERT_TEST(game.tryMove(GridPoint(0,0), GridPoint(4,4)) == MOVE_TOO_FAR);
+    game.reload(GridPoint(1,2));
+    game.move(GridPoint(1,2), GridPoint(2,1));
+    game.attack(GridPoint(2,1), GridPoint(0,0));
+    Game copy(game);
+    copy.reload(GridPoint(0,0));
+    game.attachListener(nullptr);
+    game.reload(GridPoint(0,0));
+
+    if(!GameEventSink::ENABLED){
+        // Built without MTM_GAME_EVENTS: the events are compiled out
+        ASSERT_TEST(log.lines.empty());
+        return true;
+    }
+    std::vector<string> expected = {
+        "heal 0,2 1,2 1 11",
+        "damage 0,0 0,2 4 -1",
+        "splash 0,0 1,2 2 9",
+        "death 0,2 m",
+        "reload 1,2 2",
+        "move 1,2 2,1 n",
+        "damage 2,1 0,0 2 8"
+    };
+    ASSERT_TEST(log.lines == expected);
+
+    return true;
+
+}
+
+bool testInstrumentation(){
+
+    // Every value falls in a bucket that holds it, within 1/32 of it
+    std::uint64_t values[] = {0, 1, 63, 64, 65, 1000, 123456789, LatencyHistogram::MAX_VALUE};
+    for (std::uint64_t value : values){
+        int bucket = LatencyHistogram::bucketOf(value);
+        ASSERT_TEST(bucket >= 0 && bucket < LatencyHistogram::BUCKETS);
+        ASSERT_TEST(LatencyHistogram::lowestValue(bucket) <= value && value <= LatencyHistogram::highestValue(bucket));
+        ASSERT_TEST(LatencyHistogram::highestValue(bucket) - LatencyHistogram::lowestValue(bucket) <= value / 32);
+    }
+    ASSERT_TEST(LatencyHistogram::bucketOf(LatencyHistogram::MAX_VALUE * 2) == LatencyHistogram::BUCKETS - 1);
+    LatencyHistogram histogram;
+    for (std::uint64_t value = 1; value <= 1000; value++){
+        histogram.record(value);
+    }
+    ASSERT_TEST(histogram.count() == 1000 && histogram.mean() == 500.5 && histogram.minimum() == 1);
+    ASSERT_TEST(histogram.percentile(50) >= 500 && histogram.percentile(50) <= 515);
+    ASSERT_TEST(histogram.percentile(99) >= 990 && histogram.maximum() >= 1000 && histogram.maximum() <= 1023);
+
+    Instrumentation::reset();
+    Game game(4,4);
+    game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 2, 3, 4));
+    ASSERT_TEST(game.tryMove(GridPoint(0,0), GridPoint(0,1)) == SUCCESS);
+    ASSERT_ERROR(game.move(GridPoint(0,1), GridPoint(3,3)), MoveTooFar);
+    ASSERT_ERROR(game.reload(GridPoint(3,3)), CellEmpty);
+    gameToString(game);
+    Matrix<int> matrix(Dimensions(2,2));
+    Matrix<int> copy(matrix);
+    std::thread worker([](){
+        Game other(2,2);
+        other.addCharacter(GridPoint(0,0), Game::makeCharacter(MEDIC, PYTHON, 1, 1, 1, 1));
+        for (int i = 0; i < 10; i++){
+            other.reload(GridPoint(0,0));
+        }
+    });
+    worker.join();
+    InstrumentationSnapshot snapshot = Instrumentation::snapshot();
+
+    if (!Instrumentation::ENABLED){
+        // Built without MTM_INSTRUMENTATION: nothing is counted
+        ASSERT_TEST(snapshot.counters[MOVE_COMMANDS] == 0 && snapshot.latencies[MOVE_CALL].count() == 0);
+        return true;
+    }
+    // The exited worker thread is counted too
+    ASSERT_TEST(snapshot.counters[ADD_COMMANDS] == 2 && snapshot.counters[MOVE_COMMANDS] == 2);
+    ASSERT_TEST(snapshot.counters[RELOAD_COMMANDS] == 11);
+    ASSERT_TEST(snapshot.counters[MOVE_TOO_FAR_EXCEPTIONS] == 1 && snapshot.counters[CELL_EMPTY_EXCEPTIONS] == 1);
+    ASSERT_TEST(snapshot.counters[MATRIX_ALLOCATIONS] == 2 && snapshot.counters[MATRIX_COPIES] == 1);
+    ASSERT_TEST(snapshot.counters[CELLS_SCANNED] == 16);
+    ASSERT_TEST(snapshot.latencies[MOVE_CALL].count() == 2 && snapshot.latencies[RELOAD_CALL].count() == 11);
+    ASSERT_TEST(snapshot.toJson().find("\"reload_commands\":11") != string::npos);
+    ASSERT_TEST(snapshot.toText().find("cells_scanned") != string::npos);
+
+    Instrumentation::reset();
+    ASSERT_TEST(Instrumentation::snapshot().counters[MOVE_COMMANDS] == 0);
+
+    return true;
+
+}
+
+bool testScenarioGenerator(){
+
+    ScenarioConfig config;
+    config.height = 32;
+    config.width = 24;
+    config.density = 0.25;
+    config.seed = 5;
+    ScenarioGenerator scenario(config);
+    ASSERT_TEST(scenario.characters().size() == 192);
+    ASSERT_TEST(scenario.game().characterCount(CPP) + scenario.game().characterCount(PYTHON) == 192);
+
+    // The same config gives the same game and commands, whatever was generated before
+    ScenarioGenerator same(config);
+    std::vector<Command> moves = scenario.commands(MOVE, 500);
+    std::vector<Command> snipes = scenario.attacks(SNIPER, 500);
+    ASSERT_TEST(same.game().hash() == scenario.game().hash());
+    std::vector<Command> same_snipes = same.attacks(SNIPER, 500);
+    ASSERT_TEST(moves.size() == 500 && snipes.size() == same_snipes.size() && !snipes.empty());
+    for (size_t i = 0; i < snipes.size(); i++){
+        ASSERT_TEST(snipes[i].src == same_snipes[i].src && snipes[i].dst == same_snipes[i].dst);
+    }
+
+    // Every command succeeds in order on a copy of the game
+    CommandType types[] = {MOVE, ATTACK, RELOAD};
+    for (CommandType type : types){
+        Game game(scenario.game());
+        std::vector<Command> commands = scenario.commands(type, 300);
+        ASSERT_TEST(!commands.empty());
+        for (const Command& command : commands){
+            ASSERT_TEST(command.type == type);
+        }
+        std::vector<CommandResult> results = game.execute(commands);
+        ASSERT_TEST(std::count(results.begin(), results.end(), SUCCESS) == static_cast<long>(results.size()));
+    }
+    Game game(scenario.game());
+    std::vector<CommandResult> results = game.execute(snipes);
+    ASSERT_TEST(std::count(results.begin(), results.end(), SUCCESS) == static_cast<long>(results.size()));
+
+    config.seed = 6;
+    ASSERT_TEST(ScenarioGenerator(config).game().hash() != scenario.game().hash());
+    config.density = 1.5;
+    ASSERT_ERROR(ScenarioGenerator generator(config), IllegalArgument);
+    ASSERT_ERROR(scenario.commands(MOVE, -1), IllegalArgument);
+
+    return true;
+
+}
+
+bool commandLess(const Command& first, const Command& second){
+    int a[] = {first.type, first.src.row, first.src.col, first.dst.row, first.dst.col};
+    int b[] = {second.type, second.src.row, second.src.col, second.dst.row, second.dst.col};
+    return std::lexicographical_compare(a, a + 5, b, b + 5);
+}
+
+bool testLegalCommands(){
+
+    Game game(7,7);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(3,3), Game::makeCharacter(SOLDIER, CPP, 10, 1, 2, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(3,5), Game::makeCharacter(MEDIC, CPP, 10, 0, 3, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SNIPER, CPP, 10, 2, 4, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(1,3), Game::makeCharacter(SOLDIER, PYTHON, 10, 0, 3, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(2,2), Game::makeCharacter(MEDIC, PYTHON, 10, 2, 2, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(6,6), Game::makeCharacter(SNIPER, PYTHON, 10, 1, 6, 1)));
+    GridPoint positions[] = {GridPoint(3,3), GridPoint(3,5), GridPoint(0,0), GridPoint(1,3), GridPoint(2,2), GridPoint(6,6)};
+
+    // Every generated command succeeds, and every command that succeeds is generated
+    std::vector<Command> storage(256);
+    Command* buffer = storage.data();
+    int total = 0;
+    for (const GridPoint& src : positions){
+        int count = game.legalCommands(src, buffer, 256);
+        ASSERT_TEST(count > 0 && count <= 256);
+        total += count;
+        std::vector<Command> generated(buffer, buffer + count);
+        std::vector<Command> expected;
+        expected.push_back(Command::reload(src));
+        for (int row = 0; row < 7; row++){
+            for (int col = 0; col < 7; col++){
+                Command candidates[] = {Command::move(src, GridPoint(row, col)), Command::attack(src, GridPoint(row, col))};
+                for (const Command& command : candidates){
+                    CommandResult result = SUCCESS;
+                    game.begin();
+                    game.execute(&command, 1, &result);
+                    game.rollback();
+                    if (result == SUCCESS){
+                        expected.push_back(command);
+                    }
+                }
+            }
+        }
+        std::sort(generated.begin(), generated.end(), commandLess);
+        std::sort(expected.begin(), expected.end(), commandLess);
+        ASSERT_TEST(generated.size() == expected.size());
+        for (int i = 0; i < count; i++){
+            ASSERT_TEST(!commandLess(generated[i], expected[i]) && !commandLess(expected[i], generated[i]));
+        }
+    }
+
+    // A short buffer is filled, and the full count is still returned
+    ASSERT_TEST(game.legalCommands(CPP, nullptr, 0) + game.legalCommands(PYTHON, nullptr, 0) == total);
+    int cpp_count = game.legalCommands(CPP, buffer, 3);
+    ASSERT_TEST(cpp_count > 3 && cpp_count == game.legalCommands(CPP, buffer, 256));
+
+    ASSERT_ERROR(game.legalCommands(GridPoint(7,0), buffer, 256), IllegalCell);
+    ASSERT_ERROR(game.legalCommands(GridPoint(4,4), buffer, 256), CellEmpty);
+
+    return true;
+
+}
+
+bool testLegalCommandsHugeRange(){
+
+    // A range past the board reaches every cell of the row and column, and must not overflow
+    Game game(5,6);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(2,3), Game::makeCharacter(SOLDIER, CPP, 10, 1, INT_MAX, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(MEDIC, PYTHON, 10, 1, INT_MAX, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(4,5), Game::makeCharacter(SNIPER, PYTHON, 10, 1, INT_MAX, 1)));
+    Command storage[256];
+    int count = game.legalCommands(GridPoint(2,3), storage, 256);
+    ASSERT_TEST(count > 0 && count <= 256);
+    int attacks = 0;
+    for (int i = 0; i < count; i++){
+        if (storage[i].type == ATTACK){
+            attacks++;
+            ASSERT_TEST(storage[i].dst.row == 2 || storage[i].dst.col == 3);
+        }
+    }
+    ASSERT_TEST(attacks == 5 + 6 - 1);
+    ASSERT_NO_ERROR(game.attack(GridPoint(2,3), GridPoint(0,3)));
+
+    // The medic reaches everyone, the sniper no one (its minimum range is beyond the board)
+    count = game.legalCommands(GridPoint(0,0), storage, 256);
+    attacks = 0;
+    for (int i = 0; i < count; i++){
+        attacks += (storage[i].type == ATTACK);
+    }
+    ASSERT_TEST(attacks == 2);
+    count = game.legalCommands(GridPoint(4,5), storage, 256);
+    for (int i = 0; i < count; i++){
+        ASSERT_TEST(storage[i].type != ATTACK);
+    }
+
+    return true;
+
+}
+
+// Returns true if the occupancy bits of game match the positions of its characters
+bool occupancyMatches(const Game& game, std::mt19937& generator){
+    const OccupancyBitboards& occupancy = game.occupancyBitboards();
+    std::vector<GridPoint> positions[2];
+    game.characterPositions(CPP, positions[CPP]);
+    game.characterPositions(PYTHON, positions[PYTHON]);
+    int occupied = 0;
+    for (int row = 0; row < game.height(); row++){
+        occupied += occupancy.countInRow(CPP, row, 0, game.width() - 1) + occupancy.countInRow(PYTHON, row, 0, game.width() - 1);
+    }
+    ASSERT_TEST(occupied == static_cast<int>(positions[CPP].size() + positions[PYTHON].size()));
+    for (int query = 0; query < 50; query++){
+        GridPoint center(generator() % game.height(), generator() % game.width());
+        int inner = generator() % 8, outer = inner + generator() % 80 - 4;
+        int first = static_cast<int>(generator() % 140) - 10, last = first + static_cast<int>(generator() % 90);
+        for (Team team : {CPP, PYTHON}){
+            int in_ring = 0, in_row = 0, in_column = 0;
+            for (const GridPoint& position : positions[team]){
+                ASSERT_TEST(occupancy.test(position, team));
+                int distance = GridPoint::distance(center, position);
+                in_ring += (distance >= inner && distance <= outer);
+                in_row += (position.row == center.row && position.col >= first && position.col <= last);
+                in_column += (position.col == center.col && position.row >= first && position.row <= last);
+            }
+            int visited = 0;
+            occupancy.forEachInRing(team, center, inner, outer, [&](const GridPoint& cell, int distance){
+                visited += (occupancy.test(cell, team) && distance == GridPoint::distance(center, cell)
+                            && distance >= inner && distance <= outer);
+            });
+            ASSERT_TEST(occupancy.countInRing(team, center, inner, outer) == in_ring && visited == in_ring);
+            ASSERT_TEST(occupancy.countInRow(team, center.row, first, last) == in_row);
+            ASSERT_TEST(occupancy.countInColumn(team, center.col, first, last) == in_column);
+        }
+        ASSERT_TEST(occupancy.isRowClear(center.row, first, last) ==
+                    (occupancy.countInRow(CPP, center.row, first, last) + occupancy.countInRow(PYTHON, center.row, first, last) == 0));
+    }
+    return true;
+}
+
+bool testOccupancyBitboards(){
+
+    // Rows and columns longer than a word, so spans cross word boundaries
+    Game game(70,130);
+    std::mt19937 generator(7);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 600; i++){
+        GridPoint cell(generator() % 70, generator() % 130);
+        try {
+            game.addCharacter(cell, Game::makeCharacter(types[i % 3], (i % 2) ? CPP : PYTHON, 30, 3, 2 + i % 7, 2));
+        } catch (const CellOccupied&) { }
+    }
+    ASSERT_TEST(occupancyMatches(game, generator));
+
+    // The bits follow every command, and rollback restores them
+    Game before(game);
+    std::vector<Command> storage(4096);
+    game.begin();
+    for (int turn = 0; turn < 300 && !game.isOver(); turn++){
+        Team team = (turn % 2) ? CPP : PYTHON;
+        int count = std::min(game.legalCommands(team, storage.data(), 4096), 4096);
+        CommandResult result = SUCCESS;
+        game.execute(&storage[generator() % count], 1, &result);
+        ASSERT_TEST(result == SUCCESS);
+    }
+    ASSERT_TEST(occupancyMatches(game, generator));
+    game.rollback();
+    ASSERT_TEST(occupancyMatches(game, generator) && gameToString(game) == gameToString(before));
+
+    // Ring targets on a crowded board come from the bits, and match a trial of every cell
+    std::vector<GridPoint> sources;
+    game.characterPositions(CPP, sources);
+    for (int i = 0; i < 6; i++){
+        const GridPoint& src = sources[i];
+        int count = game.legalCommands(src, storage.data(), 4096);
+        std::vector<Command> generated(storage.begin(), storage.begin() + count);
+        std::vector<Command> expected(1, Command::reload(src));
+        for (int row = 0; row < 70; row++){
+            for (int col = 0; col < 130; col++){
+                Command candidates[] = {Command::move(src, GridPoint(row, col)), Command::attack(src, GridPoint(row, col))};
+                for (const Command& command : candidates){
+                    CommandResult result = SUCCESS;
+                    game.begin();
+                    game.execute(&command, 1, &result);
+                    game.rollback();
+                    if (result == SUCCESS){
+                        expected.push_back(command);
+                    }
+                }
+            }
+        }
+        std::sort(generated.begin(), generated.end(), commandLess);
+        std::sort(expected.begin(), expected.end(), commandLess);
+        ASSERT_TEST(generated.size() == expected.size());
+        for (int j = 0; j < count; j++){
+            ASSERT_TEST(!commandLess(generated[j], expected[j]) && !commandLess(expected[j], generated[j]));
+        }
+    }
+
+    return true;
+
+}
+
+// Returns command moved by (rows, cols)
+Command translated(const Command& command, int rows, int cols){
+    return Command(command.type, GridPoint(command.src.row + rows, command.src.col + cols),
+                    GridPoint(command.dst.row + rows, command.dst.col + cols));
+}
+
+bool testSparseBoard(){
+
+    // A huge empty board takes almost no memory, and keeps its bounds
+    Game huge(100000, 100000);
+    ASSERT_TEST(huge.boardMemoryUsage() < 4096);
+    ASSERT_ERROR(huge.addCharacter(GridPoint(100000, 5), Game::makeCharacter(SOLDIER, CPP, 1, 1, 1, 1)), IllegalCell);
+    ASSERT_ERROR(huge.addCharacter(GridPoint(5, -1), Game::makeCharacter(SOLDIER, CPP, 1, 1, 1, 1)), IllegalCell);
+    ASSERT_NO_ERROR(huge.addCharacter(GridPoint(99999, 99999), Game::makeCharacter(SNIPER, CPP, 5, 1, 9, 1)));
+    ASSERT_NO_ERROR(huge.addCharacter(GridPoint(99994, 99999), Game::makeCharacter(SOLDIER, PYTHON, 5, 1, 9, 1)));
+    ASSERT_ERROR(huge.move(GridPoint(99999, 99999), GridPoint(99999, 100000)), IllegalCell);
+    ASSERT_NO_ERROR(huge.attack(GridPoint(99999, 99999), GridPoint(99994, 99999)));
+    ASSERT_TEST(huge.boardMemoryUsage() < 64 * 1024);
+    huge.clear();
+    ASSERT_TEST(huge.boardMemoryUsage() < 4096);
+
+    // The same game on the corner of a dense board and of a slightly larger sparse one,
+    // shifted across tile boundaries, plays out the same
+    const int shift = 4;
+    Game dense(4096, 4096), sparse(4096 + shift, 4096 + shift);
+    ASSERT_TEST(static_cast<long long>(4096 + shift) * (4096 + shift) > Game::SPARSE_BOARD_CELLS);
+    ASSERT_TEST(sparse.boardMemoryUsage() * 100 < dense.boardMemoryUsage());
+    std::mt19937 generator(11);
+    CharacterType types[] = {SOLDIER, MEDIC, SNIPER};
+    for (int i = 0; i < 300; i++){
+        GridPoint cell(4096 - 60 + generator() % 60, 4096 - 60 + generator() % 60);
+        std::shared_ptr<Character> character = Game::makeCharacter(types[i % 3], (i % 2) ? CPP : PYTHON, 20, 3, 2 + i % 6, 3);
+        try {
+            dense.addCharacter(cell, character);
+        } catch (const CellOccupied&) {
+            continue;
+        }
+        ASSERT_NO_ERROR(sparse.addCharacter(GridPoint(cell.row + shift, cell.col + shift), character));
+    }
+    std::vector<Command> dense_commands(4096);
+    std::vector<Command> sparse_commands(4096);
+    std::uint64_t initial_hash = sparse.hash();
+    sparse.begin();
+    for (int turn = 0; turn < 200 && !dense.isOver(); turn++){
+        Team team = (turn % 2) ? CPP : PYTHON;
+        int count = dense.legalCommands(team, dense_commands.data(), 4096);
+        ASSERT_TEST(sparse.legalCommands(team, sparse_commands.data(), 4096) == count);
+        count = std::min(count, 4096);
+        const Command& command = dense_commands[generator() % count];
+        CommandResult dense_result = SUCCESS, sparse_result = SUCCESS;
+        dense.execute(&command, 1, &dense_result);
+        Command shifted = translated(command, shift, shift);
+        sparse.execute(&shifted, 1, &sparse_result);
+        ASSERT_TEST(dense_result == sparse_result);
+    }
+    for (Team team : {CPP, PYTHON}){
+        std::vector<GridPoint> dense_positions, sparse_positions;
+        dense.characterPositions(team, dense_positions);
+        sparse.characterPositions(team, sparse_positions);
+        ASSERT_TEST(dense_positions.size() == sparse_positions.size());
+        ASSERT_TEST(dense.totalHealth(team) == sparse.totalHealth(team));
+        for (size_t i = 0; i < dense_positions.size(); i++){
+            ASSERT_TEST(sparse_positions[i] == GridPoint(dense_positions[i].row + shift, dense_positions[i].col + shift));
+        }
+    }
+    ASSERT_TEST(sparse.hash() == sparse.computeHash() && occupancyMatches(sparse, generator));
+
+    // Rollback restores the sparse board, and copies hold only the occupied tiles
+    size_t before_rollback = sparse.boardMemoryUsage();
+    sparse.rollback();
+    ASSERT_TEST(sparse.hash() == sparse.computeHash() && occupancyMatches(sparse, generator));
+    ASSERT_TEST(sparse.hash() == initial_hash);
+    Game copy(sparse);
+    ASSERT_TEST(copy.boardMemoryUsage() <= sparse.boardMemoryUsage() && before_rollback > 0);
+
+    return true;
+
+}
+
+// Applies the output of a GameRenderer to a screen of lines, understanding only what it writes:
+// cursor home, erase screen, cursor position, newlines and printable characters
+void applyAnsi(std::vector<string>& screen, const string& output){
+    int row = 0, col = 0;
+    for (size_t i = 0; i < output.size(); i++){
+        if (output[i] == '\x1b'){
+            size_t end = output.find_first_of("HJ", i);
+            string operands = output.substr(i + 2, end - i - 2);
+            if (output[end] == 'J'){
+                screen.clear();
+            } else if (operands.empty()){
+                row = col = 0;
+            } else {
+                row = std::stoi(operands) - 1;
+                col = std::stoi(operands.substr(operands.find(';') + 1)) - 1;
+            }
+            i = end;
+        } else if (output[i] == '\n'){
+            row++;
+            col = 0;
+        } else {
+            if (static_cast<int>(screen.size()) <= row){
+                screen.resize(row + 1);
+            }
+            if (static_cast<int>(screen[row].size()) <= col){
+                screen[row].resize(col + 1, ' ');
+            }
+            screen[row][col++] = output[i];
+        }
+    }
+}
+
+// Returns true if screen shows what operator<< prints for game
+bool screenShows(const std::vector<string>& screen, Game& game){
+    std::ostringstream expected;
+    expected << game;
+    std::istringstream lines(expected.str());
+    string line;
+    for (int row = 0; std::getline(lines, line); row++){
+        if (row >= static_cast<int>(screen.size()) || screen[row] != line){
+            return false;
+        }
+    }
+    return true;
+}
+
+bool testRenderer(){
+
+    Game game(5,6);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 2, 4, 5)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,3), Game::makeCharacter(MEDIC, PYTHON, 5, 2, 4, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(4,5), Game::makeCharacter(SNIPER, PYTHON, 5, 2, 4, 1)));
+    GameRenderer renderer;
+    game.attachRenderer(&renderer);
+    std::vector<string> screen;
+    std::ostringstream out;
+
+    // The first frame draws everything, and an unchanged game draws nothing
+    ASSERT_TEST(renderer.render(game, out) == 30);
+    applyAnsi(screen, out.str());
+    ASSERT_TEST(screenShows(screen, game));
+    out.str("");
+    ASSERT_TEST(renderer.render(game, out) == 0 && out.str().empty() && renderer.lastFrameSize() == 0);
+
+    // A move redraws its two cells, and a casualty its own cell
+    ASSERT_NO_ERROR(game.move(GridPoint(0,0), GridPoint(0,1)));
+    ASSERT_TEST(renderer.render(game, out) == 2);
+    ASSERT_NO_ERROR(game.attack(GridPoint(0,1), GridPoint(0,3)));
+    ASSERT_TEST(renderer.render(game, out) == 1);
+    applyAnsi(screen, out.str());
+    ASSERT_TEST(screenShows(screen, game));
+
+    // Changes that cancel out draw nothing, and rollback redraws what it restores
+    ASSERT_NO_ERROR(game.move(GridPoint(0,1), GridPoint(1,1)));
+    ASSERT_NO_ERROR(game.move(GridPoint(1,1), GridPoint(0,1)));
+    out.str("");
+    ASSERT_TEST(renderer.render(game, out) == 0);
+    game.begin();
+    ASSERT_NO_ERROR(game.move(GridPoint(4,5), GridPoint(2,5)));
+    ASSERT_TEST(renderer.render(game, out) == 2);
+    game.rollback();
+    ASSERT_TEST(renderer.render(game, out) == 2);
+    applyAnsi(screen, out.str());
+    ASSERT_TEST(screenShows(screen, game));
+
+    // Assignments and invalidate redraw the whole board
+    Game other(3,3);
+    game = other;
+    ASSERT_TEST(renderer.render(game, out) == 9);
+    renderer.invalidate();
+    ASSERT_TEST(renderer.render(game, out) == 9);
+    applyAnsi(screen, out.str());
+    ASSERT_TEST(screenShows(screen, game));
+    game.attachRenderer(nullptr);
+
+    return true;
+
+}
+
+// Returns true if applying command to a copy of game ends it with team winning
+bool winsAtOnce(const Game& game, const Command& command, Team team){
+    Game copy(game);
+    CommandResult result = SUCCESS;
+    copy.execute(&command, 1, &result);
+    Team winner = (team == CPP) ? PYTHON : CPP;
+    return result == SUCCESS && copy.isOver(&winner) && winner == team;
+}
+
+bool testZobristHash(){
+
+    Game game(8,8);
+    ASSERT_TEST(game.hash() == 0);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 3, 4, 4)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(7,7), Game::makeCharacter(SNIPER, CPP, 10, 5, 6, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,3), Game::makeCharacter(MEDIC, PYTHON, 5, 1, 2, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(1,3), Game::makeCharacter(SOLDIER, PYTHON, 2, 1, 2, 1)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(4,4), Game::makeCharacter(MEDIC, PYTHON, 20, 1, 2, 1)));
+    ASSERT_TEST(game.hash() != 0 && game.hash() == game.computeHash());
+    std::uint64_t start = game.hash();
+
+    // The same position, reached in two different orders, has the same hash
+    Game other(game);
+    ASSERT_NO_ERROR(game.move(GridPoint(0,0), GridPoint(2,0)));
+    ASSERT_NO_ERROR(game.move(GridPoint(7,7), GridPoint(7,4)));
+    ASSERT_NO_ERROR(other.move(GridPoint(7,7), GridPoint(6,5)));
+    ASSERT_NO_ERROR(other.move(GridPoint(0,0), GridPoint(2,0)));
+    ASSERT_TEST(game.hash() != other.hash());
+    ASSERT_NO_ERROR(other.move(GridPoint(6,5), GridPoint(7,4)));
+    ASSERT_TEST(game.hash() == other.hash() && game.hash() == game.computeHash());
+
+    // Attacks (with splash damage, casualties, heals and sniper combos) and reloads
+    game.begin();
+    ASSERT_NO_ERROR(game.move(GridPoint(2,0), GridPoint(0,0)));
+    ASSERT_NO_ERROR(game.attack(GridPoint(0,0), GridPoint(0,3)));
+    ASSERT_TEST(game.hash() == game.computeHash());
+    ASSERT_NO_ERROR(game.attack(GridPoint(7,4), GridPoint(4,4)));
+    ASSERT_NO_ERROR(game.attack(GridPoint(7,4), GridPoint(4,4)));
+    ASSERT_TEST(game.hash() == game.computeHash());
+    ASSERT_NO_ERROR(game.reload(GridPoint(7,4)));
+    ASSERT_TEST(game.hash() == game.computeHash());
+    std::uint64_t before_rollback = game.hash();
+    game.rollback();
+    ASSERT_TEST(game.hash() == other.hash() && game.hash() == game.computeHash());
+    ASSERT_TEST(before_rollback != game.hash());
+
+    // Copies and assignments carry the hash
+    Game copy(5,5);
+    copy = game;
+    ASSERT_TEST(copy.hash() == game.hash());
+    game.clear();
+    ASSERT_TEST(game.hash() == 0 && Game(other).hash() == other.hash());
+    ASSERT_TEST(start != other.hash());
+
+    // Small values are exact, larger ones share a bucket per power of two
+    ASSERT_TEST(ZobristKeys::bucket(3) != ZobristKeys::bucket(4));
+    ASSERT_TEST(ZobristKeys::bucket(16) == ZobristKeys::bucket(31));
+    ASSERT_TEST(ZobristKeys::bucket(31) != ZobristKeys::bucket(32));
+
+    return true;
+
+}
+
+bool testTranspositionTable(){
+
+    TranspositionTable table(10);
+    ASSERT_TEST(table.size() == 1024);
+    TranspositionTable::Entry entry;
+    ASSERT_TEST(!table.probe(0, entry) && !table.probe(12345, entry));
+
+    entry.score = -42;
+    entry.depth = 5;
+    entry.bound = TranspositionTable::LOWER;
+    entry.has_command = true;
+    entry.command = Command::attack(GridPoint(3,4), GridPoint(5,6));
+    table.store(12345, entry);
+    TranspositionTable::Entry found;
+    ASSERT_TEST(table.probe(12345, found));
+    ASSERT_TEST(found.score == -42 && found.depth == 5 && found.bound == TranspositionTable::LOWER);
+    ASSERT_TEST(found.has_command && found.command.type == ATTACK);
+    ASSERT_TEST(found.command.src == GridPoint(3,4) && found.command.dst == GridPoint(5,6));
+    ASSERT_TEST(!table.probe(12345 + 1024, found));
+
+    // A shallower result does not replace a deeper one for the same position
+    entry.depth = 2;
+    entry.score = 7;
+    table.store(12345, entry);
+    ASSERT_TEST(table.probe(12345, found) && found.score == -42);
+
+    // Concurrent writers of colliding keys never produce a mixed entry
+    table.clear();
+    std::vector<std::thread> threads;
+    bool consistent[4] = {true, true, true, true};
+    for (int t = 0; t < 4; t++){
+        threads.push_back(std::thread([&table, &consistent, t](){
+            TranspositionTable::Entry local;
+            for (int i = 0; i < 100000; i++){
+                std::uint64_t key = static_cast<std::uint64_t>(t * 100000 + i) << 10 | (i & 15);
+                local.score = static_cast<int>(key >> 10);
+                local.depth = 0;
+                local.has_command = true;
+                local.command = Command::move(GridPoint(t, i & 0x3FFF), GridPoint(t, t));
+                table.store(key, local);
+                if (table.probe(key, local) && (local.score != static_cast<int>(key >> 10) ||
+                    !(local.command.src == GridPoint(t, i & 0x3FFF)))){
+                    consistent[t] = false;
+                }
+            }
+        }));
+    }
+    for (std::thread& thread : threads){
+        thread.join();
+    }
+    ASSERT_TEST(consistent[0] && consistent[1] && consistent[2] && consistent[3]);
+
+    // Searches sharing a table agree with a search without one
+    Game game(6,6);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 3, 3, 5)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(5,5), Game::makeCharacter(MEDIC, CPP, 10, 3, 3, 5)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,2), Game::makeCharacter(SNIPER, PYTHON, 3, 3, 4, 2)));
+    SearchLimits limits;
+    limits.max_depth = 3;
+    limits.time_budget_ms = 0;
+    GameSearch search(game, CPP);
+    search.setTranspositionTable(&table);
+    SearchResult result = search.alphaBeta(limits);
+    ASSERT_TEST(winsAtOnce(game, result.best, CPP));
+    SearchResult cached = search.alphaBeta(limits);
+    ASSERT_TEST(winsAtOnce(game, cached.best, CPP) && cached.score == result.score);
+
+    ASSERT_ERROR(TranspositionTable invalid(31), IllegalArgument);
+
+    return true;
+
+}
+
+bool testGameSearch(){
+
+    Game game(6,6);
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,0), Game::makeCharacter(SOLDIER, CPP, 10, 3, 3, 5)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(5,5), Game::makeCharacter(MEDIC, CPP, 10, 3, 3, 5)));
+    ASSERT_NO_ERROR(game.addCharacter(GridPoint(0,2), Game::makeCharacter(SNIPER, PYTHON, 3, 3, 4, 2)));
+    string before = gameToString(game);
+
+    // Killing the only enemy wins at once, whatever the search method
+    SearchLimits limits;
+    limits.max_depth = 3;
+    limits.time_budget_ms = 0;
+    GameSearch search(game, CPP);
+    SearchResult result = search.alphaBeta(limits);
+    ASSERT_TEST(result.found && result.depth >= 1 && result.nodes > 0);
+    ASSERT_TEST(winsAtOnce(game, result.best, CPP));
+    ASSERT_TEST(result.score > 0);
+
+    limits.max_nodes = 20000;
+    result = search.monteCarlo(limits);
+    ASSERT_TEST(result.found && result.nodes >= 20000);
+    ASSERT_TEST(winsAtOnce(game, result.best, CPP));
+    ASSERT_TEST(result.score > 900);
+    SearchResult again = search.monteCarlo(limits);
+    ASSERT_TEST(again.nodes == result.nodes && again.score == result.score);
+
+    // Hitting the soldier only gets the sniper killed, so it runs out of reach instead
+    GameSearch defense(game, PYTHON);
+    limits.max_nodes = 0;
+    limits.max_depth = 2;
+    result = defense.alphaBeta(limits);
+    ASSERT_TEST(result.found && result.best.type == MOVE && result.best.src == GridPoint(0,2));
+    ASSERT_TEST(result.best.dst.row != 0 && result.score > -1000);
+
+    // The search works on its own copy of the game
+    ASSERT_TEST(gameToString(game) == before);
+    ASSERT_TEST(!game.inTransaction());
+
+    limits.max_depth = 0;
+    ASSERT_ERROR(search.alphaBeta(limits), IllegalArgument);
+    limits.max_nodes = 0;
+    ASSERT_ERROR(search.monteCarlo(limits), IllegalArgument);
+
+    return true;
+
+}
+
 bool testOutput(){
 
     int rows = 10;
@@ -811,8 +2202,31 @@ int main(){
     ADD_TEST(testAttackSoldier);
     ADD_TEST(testAttackMedic);
     ADD_TEST(testAttackSniper);
+    ADD_TEST(testAttackCasualties);
+    ADD_TEST(testAttackSoldierLargeArea);
     ADD_TEST(testReload);
     ADD_TEST(testOutput);
+    ADD_TEST(testTransactions);
+    ADD_TEST(testJournalReplay);
+    ADD_TEST(testExecuteBatch);
+    ADD_TEST(testTryCommands);
+    ADD_TEST(testAllocations);
+    ADD_TEST(testGameEvents);
+    ADD_TEST(testInstrumentation);
+    ADD_TEST(testCharacterPool);
+    ADD_TEST(testConcurrentGame);
+    ADD_TEST(testCommandScript);
+    ADD_TEST(testMatchSimulator);
+    ADD_TEST(testScenarioGenerator);
+    ADD_TEST(testGameSearch);
+    ADD_TEST(testLegalCommands);
+    ADD_TEST(testLegalCommandsHugeRange);
+    ADD_TEST(testZobristHash);
+    ADD_TEST(testOccupancyBitboards);
+    ADD_TEST(testSparseBoard);
+    ADD_TEST(testRenderer);
+    ADD_TEST(testTranspositionTable);
+    ADD_TEST(testTeamStatistics);
     ADD_TEST(testWinningTeam);
     ADD_TEST(testGame1);
     ADD_TEST(testGame2);